@@ -209,6 +209,35 @@ public:
         }
     }
 
+    /**
+     * Resizes the partitions. The dimensions of b_i and y_i passed as second
+     * and third argument are only required by the contiguous storage
+     * ContiguousComposedStateDistribution, the partitions here are sized on
+     * assignment.
+     *
+     * \param count     Number of partitions
+     */
+    void resize_partitions(size_t count, size_t, size_t)
+    {
+        joint_partitions.resize(count);
+    }
+
+    /**
+     * \return The i-th partition
+     */
+    JointPartitions& partition(size_t i)
+    {
+        return joint_partitions[i];
+    }
+
+    /**
+     * \return The i-th partition
+     */
+    const JointPartitions& partition(size_t i) const
+    {
+        return joint_partitions[i];
+    }
+
     size_t a_dimension() const
     {
         return mean_a.rows();
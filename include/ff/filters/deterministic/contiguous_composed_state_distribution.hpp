@@ -0,0 +1,303 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2014 Max-Planck-Institute for Intelligent Systems,
+ *                     University of Southern California
+ *    Jan Issac (jan.issac@gmail.com)
+ *    Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ *
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/**
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ * Max-Planck-Institute for Intelligent Systems, University of Southern California
+ */
+
+#ifndef FAST_FILTERING_STATES_CONTIGUOUS_COMPOSED_STATE_DISTRIBUTION_HPP
+#define FAST_FILTERING_STATES_CONTIGUOUS_COMPOSED_STATE_DISTRIBUTION_HPP
+
+#include <Eigen/Dense>
+
+#include <type_traits>
+
+#include <fl/util/traits.hpp>
+#include <ff/filters/deterministic/composed_state_distribution.hpp>
+
+namespace fl
+{
+
+// Forward declarations
+template <typename CohesiveState, typename FactorizedState, typename Observation>
+class ContiguousComposedStateDistribution;
+
+/**
+ * ContiguousComposedStateDistribution distribution traits specialization
+ * \internal
+ */
+template <typename CohesiveState,
+          typename FactorizedState,
+          typename Observation>
+struct Traits<ContiguousComposedStateDistribution<
+        CohesiveState, FactorizedState, Observation>>
+    : Traits<ComposedStateDistribution<
+        CohesiveState, FactorizedState, Observation>>
+{
+    typedef typename CohesiveState::Scalar Scalar;
+
+    enum
+    {
+        Dim_a = CohesiveState::SizeAtCompileTime,
+        Dim_b = FactorizedState::SizeAtCompileTime,
+        Dim_y = Observation::SizeAtCompileTime
+    };
+
+    /**
+     * \brief Buffer of a partition field with the given number of rows. The
+     * field of the i-th partition occupies the columns [i n, (i + 1) n),
+     * where n is the number of columns of the field.
+     */
+    template <int Rows>
+    using Buffer = Eigen::Matrix<Scalar, Rows, Eigen::Dynamic>;
+};
+
+/**
+ * \class ContiguousComposedStateDistribution
+ *
+ * Composed state distribution storing the factorized partitions as a struct
+ * of arrays. Instead of one JointPartitions struct per partition, each field
+ * of all partitions is kept in one contiguous buffer (see
+ * Traits::Buffer). A 300k partition state hence consists of seven buffers
+ * rather than millions of small heap blocks, and the filter kernels stream
+ * over them partition by partition.
+ *
+ * The per-partition fields are accessed via partition(i) which returns
+ * blocks into the buffers with the same member names as JointPartitions.
+ * If the dimensions of b_i and y_i are known at compile time, e.g. for
+ * one-dimensional partitions, the buffers have fixed-size rows and the
+ * blocks are fixed-size as well.
+ */
+template <typename CohesiveState,
+          typename FactorizedState,
+          typename Observation>
+class ContiguousComposedStateDistribution
+{
+public:
+    typedef ContiguousComposedStateDistribution<
+                CohesiveState,
+                FactorizedState,
+                Observation
+            > This;
+
+    typedef typename Traits<This>::Scalar Scalar;
+    typedef typename Traits<This>::Cov_aa Cov_aa;
+    typedef typename Traits<This>::Cov_ab Cov_ab;
+    typedef typename Traits<This>::Cov_ay Cov_ay;
+    typedef typename Traits<This>::Cov_bb Cov_bb;
+    typedef typename Traits<This>::Cov_by Cov_by;
+    typedef typename Traits<This>::Cov_yy Cov_yy;
+    typedef typename Traits<This>::Y Y;
+
+    enum
+    {
+        Dim_a = Traits<This>::Dim_a,
+        Dim_b = Traits<This>::Dim_b,
+        Dim_y = Traits<This>::Dim_y
+    };
+
+    typedef typename Traits<This>::template Buffer<Dim_a> Buffer_a;
+    typedef typename Traits<This>::template Buffer<Dim_b> Buffer_b;
+    typedef typename Traits<This>::template Buffer<Dim_y> Buffer_y;
+
+protected:
+    /** \cond INTERNAL */
+    template <typename T> struct Mutable { typedef T type; };
+    /** \endcond */
+
+    /**
+     * \brief Blocks of a single partition within the buffers
+     *
+     * \tparam Qualify  std::add_const for read only blocks
+     */
+    template <template <typename> class Qualify>
+    struct PartitionBlocks
+    {
+        typedef typename Qualify<Buffer_a>::type Qualified_a;
+        typedef typename Qualify<Buffer_b>::type Qualified_b;
+        typedef typename Qualify<Buffer_y>::type Qualified_y;
+
+        PartitionBlocks(Qualified_b& means_b,
+                        Qualified_y& means_y,
+                        Qualified_a& covs_ab,
+                        Qualified_a& covs_ay,
+                        Qualified_b& covs_bb,
+                        Qualified_b& covs_by,
+                        Qualified_y& covs_yy,
+                        size_t i)
+            : mean_b(means_b, 0, i, means_b.rows(), 1),
+              mean_y(means_y, 0, i, means_y.rows(), 1),
+              cov_ab(covs_ab,
+                     0, i * means_b.rows(), covs_ab.rows(), means_b.rows()),
+              cov_ay(covs_ay,
+                     0, i * means_y.rows(), covs_ay.rows(), means_y.rows()),
+              cov_bb(covs_bb,
+                     0, i * means_b.rows(), means_b.rows(), means_b.rows()),
+              cov_by(covs_by,
+                     0, i * means_y.rows(), means_b.rows(), means_y.rows()),
+              cov_yy(covs_yy,
+                     0, i * means_y.rows(), means_y.rows(), means_y.rows())
+        { }
+
+        Eigen::Block<Qualified_b, Dim_b, 1> mean_b;
+        Eigen::Block<Qualified_y, Dim_y, 1> mean_y;
+
+        Eigen::Block<Qualified_a, Dim_a, Dim_b> cov_ab;
+        Eigen::Block<Qualified_a, Dim_a, Dim_y> cov_ay;
+        Eigen::Block<Qualified_b, Dim_b, Dim_b> cov_bb;
+        Eigen::Block<Qualified_b, Dim_b, Dim_y> cov_by;
+        Eigen::Block<Qualified_y, Dim_y, Dim_y> cov_yy;
+    };
+
+public:
+    typedef PartitionBlocks<Mutable> JointPartitions;
+    typedef PartitionBlocks<std::add_const> ConstJointPartitions;
+
+public:
+    /**
+     * Creates an empty composed state distribution
+     */
+    ContiguousComposedStateDistribution()
+    {
+    }
+
+    virtual ~ContiguousComposedStateDistribution() { }
+
+    /**
+     * \copydoc ComposedStateDistribution::initialize
+     */
+    void initialize(const CohesiveState& initial_a,
+                    const size_t factorized_states_count,
+                    const FactorizedState& initial_b_i,
+                    const Scalar sigma_a = 1.0,
+                    const Scalar sigma_b_i = 1.0)
+    {
+        mean_a = initial_a;
+        mean_a_predicted = initial_a;
+        cov_aa = Cov_aa::Identity(a_dimension(), a_dimension()) * sigma_a;
+
+        const size_t dim_b = initial_b_i.rows();
+
+        resize_partitions(factorized_states_count, dim_b, y_i_dimension());
+
+        means_b = initial_b_i.replicate(1, factorized_states_count);
+        covs_bb = Cov_bb::Identity(dim_b, dim_b).replicate(
+                      1, factorized_states_count) * sigma_b_i;
+    }
+
+    /**
+     * Resizes the partition buffers. The content is kept if the sizes do not
+     * change, otherwise it is undefined.
+     *
+     * \param count     Number of partitions
+     * \param dim_b_i   Dimension of each b_i
+     * \param dim_y_i   Dimension of each y_i
+     */
+    void resize_partitions(size_t count, size_t dim_b_i, size_t dim_y_i)
+    {
+        const size_t dim_a = a_dimension();
+
+        means_b.resize(dim_b_i, count);
+        means_y.resize(dim_y_i, count);
+        covs_ab.resize(dim_a, dim_b_i * count);
+        covs_ay.resize(dim_a, dim_y_i * count);
+        covs_bb.resize(dim_b_i, dim_b_i * count);
+        covs_by.resize(dim_b_i, dim_y_i * count);
+        covs_yy.resize(dim_y_i, dim_y_i * count);
+    }
+
+    /**
+     * \return Blocks of the i-th partition
+     */
+    JointPartitions partition(size_t i)
+    {
+        return JointPartitions(
+            means_b, means_y, covs_ab, covs_ay, covs_bb, covs_by, covs_yy, i);
+    }
+
+    /**
+     * \return Read only blocks of the i-th partition
+     */
+    ConstJointPartitions partition(size_t i) const
+    {
+        return ConstJointPartitions(
+            means_b, means_y, covs_ab, covs_ay, covs_bb, covs_by, covs_yy, i);
+    }
+
+    size_t a_dimension() const
+    {
+        return mean_a.rows();
+    }
+
+    size_t b_i_dimension() const
+    {
+        return means_b.rows();
+    }
+
+    size_t y_i_dimension() const
+    {
+        return means_y.rows();
+    }
+
+    size_t count_partitions() const
+    {
+        return means_b.cols();
+    }
+
+public:
+    CohesiveState mean_a;
+    CohesiveState mean_a_predicted;
+    Cov_aa cov_aa;
+    Cov_aa cov_aa_inverse;
+
+    /* partition buffers */
+    Buffer_b means_b;
+    Buffer_y means_y;
+    Buffer_a covs_ab;
+    Buffer_a covs_ay;
+    Buffer_b covs_bb;
+    Buffer_b covs_by;
+    Buffer_y covs_yy;
+};
+
+}
+
+#endif
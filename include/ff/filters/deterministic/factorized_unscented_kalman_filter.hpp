@@ -50,15 +50,20 @@
 #include <Eigen/Dense>
 
 #include <cmath>
+#include <vector>
+#include <algorithm>
 #include <type_traits>
 #include <memory>
 
 #include <fl/util/assertions.hpp>
+#include <fl/filter/gaussian/unscented_transform.hpp>
 #include <fl/distribution/interface/standard_gaussian_mapping.hpp>
 #include <fl/distribution/sum_of_deltas.hpp>
 #include <ff/filters/deterministic/composed_state_distribution.hpp>
+#include <ff/filters/deterministic/contiguous_composed_state_distribution.hpp>
 
 #include <fl/util/profiling.hpp>
+#include <fl/util/thread_pool.hpp>
 
 namespace fl
 {
@@ -71,6 +76,11 @@ namespace fl
  * \f$a_t\f$ and a high-dimensional fully factorised segment
  * \f$b^{[1]}_t, b^{[2]}_t, \ldots, b^{[M]}_t \f$. The two parts are predicted
  * using two different process models ProcessModelA and ProcessModelB.
+ *
+ * The filter steps accept the partitions either as an array of structs,
+ * StateDistribution, or as a struct of arrays, ContiguousStateDistribution.
+ * The latter keeps each partition field in one contiguous buffer and is
+ * preferable for a large number of partitions.
  */
 template<typename CohesiveStateProcessModel,
          typename FactorizedStateProcessModel,
@@ -90,6 +100,9 @@ public:
 
     typedef ComposedStateDistribution<State_a, State_b_i, Observation> StateDistribution;
     typedef typename StateDistribution::JointPartitions JointPartitions;
+    typedef ContiguousComposedStateDistribution<
+                State_a, State_b_i, Observation
+            > ContiguousStateDistribution;
     typedef typename StateDistribution::Cov_aa Cov_aa;
     typedef typename StateDistribution::Cov_bb Cov_bb;
     typedef typename StateDistribution::Cov_yy Cov_yy;
@@ -107,6 +120,17 @@ public:
 
     enum RandomVariableIndex { a = 0, Q_a , b_i, Q_b_i, R_y_i, y_i };
 
+    /**
+     * \brief True if each factorized state b_i and its measurement y_i are
+     * one-dimensional. In this case the per-partition algebra reduces to
+     * scalar arithmetic with closed-form inverses.
+     */
+    enum : bool
+    {
+        ScalarPartitions = State_b_i::SizeAtCompileTime == 1
+                           && Observation::SizeAtCompileTime == 1
+    };
+
 public:
     FactorizedUnscentedKalmanFilter(
             const CohesiveStateProcessModelPtr cohesive_state_process_model,
@@ -148,9 +172,10 @@ public:
      *
      * \note TESTED
      */
-    void Predict(const StateDistribution& prior_state,
+    template <typename Distribution>
+    void Predict(const Distribution& prior_state,
                  double delta_time,
-                 StateDistribution& predicted_state)
+                 Distribution& predicted_state)
     {
         const Eigen::MatrixXd noise_Q_a =
                 Eigen::MatrixXd::Identity(Dim(Q_a), Dim(Q_a));
@@ -181,38 +206,60 @@ public:
         X_a_norm_ = X_[a];
         Normalize(predicted_state.mean_a, X_a_norm_);
         predicted_state.cov_aa = X_a_norm_ * X_a_norm_.transpose();
+        CompressSigmaPoints(X_a_norm_, false, X_a_compressed_);
+
+        predicted_state.resize_partitions(prior_state.count_partitions(),
+                                          Dim(b_i),
+                                          Dim(y_i));
+
+        // predict the joint state [a  b_i  y_i] of all partitions
+        for_each_partition(
+            prior_state.count_partitions(),
+            [&](size_t i,
+                Workspace& workspace,
+                FactorizedStateProcessModel& f_b_model,
+                ObservationModel& h_model)
+            {
+                PredictPartition(prior_state.partition(i),
+                                 delta_time,
+                                 i,
+                                 workspace,
+                                 f_b_model,
+                                 h_model,
+                                 predicted_state.partition(i));
+            });
+    }
 
-        predicted_state
-                .joint_partitions
-                .resize(prior_state.joint_partitions.size());
-
-        // predict the joint state [a  b_i  y_i]
-        for (size_t i = 0; i < prior_state.joint_partitions.size(); ++i)
-        {
-            ComputeSigmaPoints(prior_state.joint_partitions[i].mean_b,
-                               prior_state.joint_partitions[i].cov_bb,
-                               Dim(a) + Dim(Q_a),
-                               X_[b_i]);
-
-            f_b(X_[b_i], X_[Q_b_i], delta_time, X_[b_i]);
-            h(X_[a], X_[b_i], X_[R_y_i], i, Y_);
-
-            typename StateDistribution::JointPartitions& predicted_partition =
-                    predicted_state.joint_partitions[i];
-
-            mean(X_[b_i], predicted_partition.mean_b);
-            mean(Y_, predicted_partition.mean_y);
-
-            Normalize(predicted_partition.mean_b, X_[b_i]);
-            Normalize(predicted_partition.mean_y, Y_);
+    /**
+     * Sets the thread pool used to predict the factorized partitions in
+     * parallel. Each partition is predicted by a single worker using its own
+     * scratch sigma points and written to its own slot, hence the result does
+     * not depend on the number of threads. Models which are not thread safe
+     * are cloned once for each worker when they are first used in parallel.
+     * If the factorized process model or the observation model can neither
+     * be shared nor cloned, the partitions are predicted serially.
+     *
+     * The clones are replaced automatically once the version of a model
+     * changes, i.e. after its parameters have been modified.
+     *
+     * \param thread_pool   Thread pool or a null pointer to predict all
+     *                      partitions in the calling thread (default)
+     */
+    void thread_pool(const std::shared_ptr<ThreadPool>& thread_pool)
+    {
+        thread_pool_ = thread_pool;
 
-            predicted_partition.cov_ab = X_a_norm_ * X_[b_i].transpose();
-            predicted_partition.cov_ay = X_a_norm_ * Y_.transpose();
-            predicted_partition.cov_bb = X_[b_i] * X_[b_i].transpose();
+        f_b_instances_.reset();
+        h_instances_.reset();
+    }
 
-            predicted_partition.cov_by = X_[b_i] * Y_.transpose();
-            predicted_partition.cov_yy = Y_ * Y_.transpose();
-        }
+    /**
+     * \return Thread pool used to predict the partitions, null if the
+     *         partitions are predicted serially
+     */
+    const std::shared_ptr<ThreadPool>& thread_pool() const
+    {
+        return thread_pool_;
     }
 
     /**
@@ -224,14 +271,20 @@ public:
      * \param [in]  y                   Measurement
      * \param [out] posterior_state     Updated posterior state
      *
+     * \return False if none of the measurements was valid. The cohesive state
+     *         of the posterior_state is left unchanged in that case.
+     *
      * \attention NEEDS TO BE TESTED
      */
-    void Update(const StateDistribution& predicted_state,
+    template <typename Distribution>
+    bool Update(const Distribution& predicted_state,
                 const Eigen::MatrixXd& y,
-                StateDistribution& posterior_state)
+                Distribution& posterior_state)
     {
-        Update_a(predicted_state, y, posterior_state);
+        const bool updated = Update_a(predicted_state, y, posterior_state);
         Update_b(predicted_state, y, posterior_state);
+
+        return updated;
     }
 
 
@@ -243,144 +296,117 @@ public:
      * \param [in]  y                   Measurement
      * \param [out] posterior_state     Updated posterior state
      *
+     * \return False if none of the measurements was valid
+     *
      * \attention NEEDS TO BE TESTED
      */
-    template <typename RT = void>
+    template <typename Distribution, typename RT = bool>
     typename std::enable_if<Observation::SizeAtCompileTime != 1, RT>::type
-    Update_a(const StateDistribution& predicted_state,
+    Update_a(const Distribution& predicted_state,
              const Eigen::MatrixXd& y,
-             StateDistribution& posterior_state)
+             Distribution& posterior_state)
     {
-        const size_t count_b = predicted_state.count_partitions();
         const size_t dim_y_i = Dim(y_i);
 
-        posterior_state.cov_aa_inverse = predicted_state.cov_aa.inverse();
+        InvertCovariance_aa(predicted_state, posterior_state);
         const Cov_aa& cov_aa_inv = posterior_state.cov_aa_inverse;
 
-        Cov_yy cov_yy_given_a_inv_i;
-        Eigen::MatrixXd A_i(dim_y_i, Dim(a));
-        Eigen::MatrixXd T_i(Dim(a), dim_y_i);
-        Cov_aa C(Dim(a), Dim(a));
-        Eigen::MatrixXd D(Dim(a), 1);
-
-        C.setZero();
-        D.setZero();
-
-        for (size_t i = 0; i < count_b; ++i)
-        {
-            if (std::isnan(y(i, 0)))
-                    //|| std::fabs(y(i, 0) - partition.mean_y(0,0)) > 0.08)
+        const InformationAccumulator& information = AccumulateInformation(
+            predicted_state.count_partitions(),
+            [&](size_t i, InformationAccumulator& accumulator)
             {
-                continue;
-            }
-
-            const JointPartitions& partition
-                    = predicted_state.joint_partitions[i];
-
-            const Cov_ay& cov_ay = partition.cov_ay;
-            const Cov_yy& cov_yy = partition.cov_yy;
-
-            A_i = cov_ay.transpose() * cov_aa_inv;
-            cov_yy_given_a_inv_i
-                    = (cov_yy - cov_ay.transpose() * cov_aa_inv * cov_ay)
-                      .inverse();
-
-            T_i = A_i.transpose() * cov_yy_given_a_inv_i;
-
-            C += T_i * A_i;
-            D += T_i * (y.middleRows(i * dim_y_i, dim_y_i) - partition.mean_y);
-        }
-
-        if (!D.isZero())
-        {
-            posterior_state.cov_aa
-                    = (cov_aa_inv + C).inverse();
-            posterior_state.mean_a
-                    = predicted_state.mean_a + posterior_state.cov_aa * D;
-        }
-        else
-        {
-            std::cout << "No valid measurements. Cohesive state partition has"
-                         " no been updated." << std::endl;
-            return;
-        }
+                if (y.middleRows(i * dim_y_i, dim_y_i).hasNaN())
+                {
+                    return;
+                }
+
+                auto&& partition = predicted_state.partition(i);
+
+                auto&& cov_ay = partition.cov_ay;
+
+                // A_i^T = cov_aa^-1 cov_ay
+                accumulator.A_i_transpose.noalias() = cov_aa_inv * cov_ay;
+
+                accumulator.cov_yy_given_a = partition.cov_yy;
+                accumulator.cov_yy_given_a.noalias() -=
+                        cov_ay.transpose() * accumulator.A_i_transpose;
+
+                // T_i^T = cov_yy_given_a^-1 A_i
+                accumulator.llt.compute(accumulator.cov_yy_given_a);
+                accumulator.T_i_transpose =
+                        accumulator.llt.solve(
+                            accumulator.A_i_transpose.transpose());
+
+                accumulator.C.noalias() +=
+                        accumulator.A_i_transpose * accumulator.T_i_transpose;
+                accumulator.D.noalias() +=
+                        accumulator.T_i_transpose.transpose()
+                        * (y.middleRows(i * dim_y_i, dim_y_i)
+                           - partition.mean_y);
+                ++accumulator.count;
+            });
+
+        return UpdateCohesiveState(
+                    predicted_state, information, posterior_state);
     }
 
     /**
      * Update the cohesive predicted_state part a assuming a one-dimensoinal
-     * measurements for each factor
+     * measurements for each factor. The information terms of the scalar
+     * measurements are accumulated directly as rank-one updates.
      *
      * \param [in]  predicted_state     Propagated state
      * \param [in]  y                   Measurement
      * \param [out] posterior_state     Updated posterior state
      *
+     * \return False if none of the measurements was valid
+     *
      * \attention NEEDS TO BE TESTED
      */
-    template <typename RT = void>
+    template <typename Distribution, typename RT = bool>
     typename std::enable_if<Observation::SizeAtCompileTime == 1, RT>::type
-    Update_a(const StateDistribution& predicted_state,
+    Update_a(const Distribution& predicted_state,
              const Eigen::MatrixXd& y,
-             StateDistribution& posterior_state)
+             Distribution& posterior_state)
     {
-        size_t dim_b = predicted_state.count_partitions();
-
-        Eigen::MatrixXd A(dim_b, Dim(a));
-        Eigen::MatrixXd mu_y(dim_b, 1);
-        Eigen::MatrixXd cov_yy_given_a_inv(dim_b, 1);
-
-        posterior_state.cov_aa_inverse = predicted_state.cov_aa.inverse();
-        Cov_aa& cov_aa_inv = posterior_state.cov_aa_inverse;
-
-        size_t k = 0;
-        Eigen::MatrixXd valid_y(dim_b, 1);
-        for (size_t i = 0; i < dim_b; ++i)
-        {
-            const JointPartitions& partition
-                    = predicted_state.joint_partitions[i];
+        InvertCovariance_aa(predicted_state, posterior_state);
+        const Cov_aa& cov_aa_inv = posterior_state.cov_aa_inverse;
 
-            if (std::isnan(y(i, 0))
-                    || std::fabs(y(i, 0) - partition.mean_y(0,0)) > 0.08)
+        const InformationAccumulator& information = AccumulateInformation(
+            predicted_state.count_partitions(),
+            [&](size_t i, InformationAccumulator& accumulator)
             {
-                continue;
-            }
-
-            const Cov_ay& cov_ay = partition.cov_ay;
-            const Cov_yy& cov_yy = partition.cov_yy;
+                auto&& partition = predicted_state.partition(i);
 
-            A.row(k) = cov_ay.transpose();
-            mu_y.row(k) = partition.mean_y;
+                if (std::isnan(y(i, 0))
+                        || std::fabs(y(i, 0) - partition.mean_y(0,0)) > 0.08)
+                {
+                    return;
+                }
 
-            cov_yy_given_a_inv.row(k) =
-                    cov_yy - cov_ay.transpose() * cov_aa_inv * cov_ay;
+                auto&& cov_ay = partition.cov_ay;
 
-            valid_y.row(k) = y.row(i);
-
-            k++;
-        }
-
-        if (!k)
-        {
-            std::cout << "No valid measurements. Cohesive state partition has"
-                         " no been updated." << std::endl;
-            return;
-        }
+                // A_i^T = cov_aa^-1 cov_ay
+                accumulator.A_i_transpose.noalias() = cov_aa_inv * cov_ay;
 
-        A.conservativeResize(k, Eigen::NoChange);
-        mu_y.conservativeResize(k, Eigen::NoChange);
-        cov_yy_given_a_inv.conservativeResize(k, Eigen::NoChange);
-        valid_y.conservativeResize(k, Eigen::NoChange);
+                const double cov_yy_given_a_inv =
+                        1. / (partition.cov_yy(0, 0)
+                              - cov_ay.col(0).dot(
+                                    accumulator.A_i_transpose.col(0)));
 
-        A = A * cov_aa_inv;
+                const double innov = y(i, 0) - partition.mean_y(0, 0);
 
-        invert_diagonal_Vector(cov_yy_given_a_inv, cov_yy_given_a_inv);
-        Eigen::MatrixXd AT_Cov_yy_given_a =
-                A.transpose() * cov_yy_given_a_inv.asDiagonal();
+                accumulator.C.noalias() +=
+                        (cov_yy_given_a_inv * accumulator.A_i_transpose)
+                        * accumulator.A_i_transpose.transpose();
+                accumulator.D.noalias() +=
+                        (cov_yy_given_a_inv * innov)
+                        * accumulator.A_i_transpose;
+                ++accumulator.count;
+            });
 
-        // update cohesive state segment
-        posterior_state.cov_aa = (cov_aa_inv + AT_Cov_yy_given_a * A).inverse();
-        posterior_state.mean_a =
-                predicted_state.mean_a +
-                posterior_state.cov_aa * (AT_Cov_yy_given_a * (valid_y - mu_y));
+        return UpdateCohesiveState(
+                    predicted_state, information, posterior_state);
     }
 
     /**
@@ -393,9 +419,11 @@ public:
      *
      * \attention NEEDS TO BE TESTED
      */
-    void Update_b(const StateDistribution& predicted_state,
-                  const Eigen::MatrixXd& y,
-                  StateDistribution& posterior_state)
+    template <typename Distribution, typename RT = void>
+    typename std::enable_if<!ScalarPartitions, RT>::type
+    Update_b(const Distribution& predicted_state,
+             const Eigen::MatrixXd& y,
+             Distribution& posterior_state)
     {
         Eigen::MatrixXd L;
         Eigen::MatrixXd L_aa;
@@ -420,8 +448,7 @@ public:
 
         for (size_t i = 0; i < count_b; ++i)
         {
-            const JointPartitions& partition
-                    = predicted_state.joint_partitions[i];
+            auto&& partition = predicted_state.partition(i);
 
             if (std::isnan(y(i, 0)) ||
                 std::fabs(y(i, 0) - partition.mean_y(0,0)) > 0.20)
@@ -429,11 +456,11 @@ public:
                 continue;
             }
 
-            const Cov_ay& cov_ay = partition.cov_ay;
-            const Cov_ab& cov_ab = partition.cov_ab;
-            const Cov_by& cov_by = partition.cov_by;
-            const Cov_bb& cov_bb = partition.cov_bb;
-            const Cov_yy& cov_yy = partition.cov_yy;
+            auto&& cov_ay = partition.cov_ay;
+            auto&& cov_ab = partition.cov_ab;
+            auto&& cov_by = partition.cov_by;
+            auto&& cov_bb = partition.cov_bb;
+            auto&& cov_yy = partition.cov_yy;
 
             smw_inverse(cov_aa_inv, cov_ay, cov_ay.transpose(), cov_yy,
                          L_aa, L_ay, L_ya, L_yy,
@@ -455,15 +482,93 @@ public:
             cov_b_given_a_y = cov_bb - K * cov_ba_by.transpose();
 
             // update b_[i]
-            posterior_state.joint_partitions[i].mean_b
+            auto&& posterior_partition = posterior_state.partition(i);
+            posterior_partition.mean_b
                      = B * posterior_state.mean_a + c;
-            posterior_state.joint_partitions[i].cov_bb
+            posterior_partition.cov_bb
                      = cov_b_given_a_y
                        + B * posterior_state.cov_aa * B.transpose();
         }
     }
 
 
+    /**
+     * Update the factorized predicted_state part b given the updated cohesive
+     * part a for one-dimensional b_i and y_i.
+     *
+     * With \f$v_i = \Sigma_{aa}^{-1}\Sigma_{ay_i}\f$ and
+     * \f$w_i = \Sigma_{aa}^{-1}\Sigma_{ab_i}\f$ the blockwise inverse of the
+     * joint covariance of a and y_i collapses to the scalar Schur complement
+     * \f$s_i = \sigma_{y_i}^2 - \Sigma_{ay_i}^T v_i\f$. The gain of y_i
+     * and the regression of b_i onto a are then
+     *
+     * \f$k_i = (\sigma_{b_iy_i} - \Sigma_{ab_i}^T v_i) / s_i\f$,
+     * \f$B_i^T = w_i - k_i v_i\f$
+     *
+     * and no matrix is inverted.
+     *
+     * \param [in]  predicted_state     Propagated state
+     * \param [in]  y                   Measurement
+     * \param [out] posterior_state     Updated posterior state
+     */
+    template <typename Distribution, typename RT = void>
+    typename std::enable_if<ScalarPartitions, RT>::type
+    Update_b(const Distribution& predicted_state,
+             const Eigen::MatrixXd& y,
+             Distribution& posterior_state)
+    {
+        typedef typename StateDistribution::Scalar Scalar;
+
+        const size_t count_b = predicted_state.count_partitions();
+        const Cov_aa& cov_aa_inv = posterior_state.cov_aa_inverse;
+        const State_a delta_a =
+                posterior_state.mean_a - predicted_state.mean_a_predicted;
+
+        State_a v;
+        State_a B_transpose;
+        State_a cov_aa_B_transpose;
+
+        for (size_t i = 0; i < count_b; ++i)
+        {
+            auto&& partition = predicted_state.partition(i);
+
+            const Scalar innov = y(i, 0) - partition.mean_y(0, 0);
+
+            if (std::isnan(y(i, 0)) || std::fabs(innov) > 0.20)
+            {
+                continue;
+            }
+
+            auto&& cov_ab = partition.cov_ab.col(0);
+            auto&& cov_ay = partition.cov_ay.col(0);
+            const Scalar cov_by = partition.cov_by(0, 0);
+
+            v.noalias() = cov_aa_inv * cov_ay;
+
+            const Scalar k = (cov_by - cov_ab.dot(v))
+                             / (partition.cov_yy(0, 0) - cov_ay.dot(v));
+
+            B_transpose.noalias() = cov_aa_inv * cov_ab;
+            B_transpose -= k * v;
+
+            cov_aa_B_transpose.noalias() =
+                    posterior_state.cov_aa * B_transpose;
+
+            const Scalar cov_bb = partition.cov_bb(0, 0)
+                                  - B_transpose.dot(cov_ab)
+                                  - k * cov_by
+                                  + B_transpose.dot(cov_aa_B_transpose);
+
+            // update b_[i]
+            auto&& posterior_partition = posterior_state.partition(i);
+            posterior_partition.mean_b(0, 0) = partition.mean_b(0, 0)
+                                               + B_transpose.dot(delta_a)
+                                               + k * innov;
+            posterior_partition.cov_bb(0, 0) = cov_bb;
+        }
+    }
+
+
 public:
     void f_a(const SigmaPoints& prior_X_a,
              const SigmaPoints& noise_X_a,
@@ -472,8 +577,20 @@ public:
     {
         Input_a zero_input = Input_a::Zero(f_a_->InputDimension(), 1);
 
+        // the points outside of the [a  Q_a] partition are copies of the
+        // first point and share its prediction
+        const size_t joint_dimension = (prior_X_a.cols() - 1) / 2;
+        const size_t partition_dimension = Dim(a) + Dim(Q_a);
+
         for (size_t i = 0; i < prior_X_a.cols(); ++i)
         {
+            if (i > 0 && UnscentedTransform::is_mean_point(
+                             i, joint_dimension, 0, partition_dimension))
+            {
+                predicted_X_a.col(i) = predicted_X_a.col(0);
+                continue;
+            }
+
             f_a_->condition(delta_time, prior_X_a.col(i), zero_input);
             predicted_X_a.col(i)
                     = f_a_->map_standard_normal(noise_X_a.col(i));
@@ -485,13 +602,39 @@ public:
              const double delta_time,
              SigmaPoints& predicted_X_b_i)
     {
-        Input_b_i zero_input = Input_b_i::Zero(f_b_->standard_variate_dimension(), 1);
+        f_b(*f_b_, prior_X_b_i, noise_X_b_i, delta_time, predicted_X_b_i);
+    }
+
+    void f_b(FactorizedStateProcessModel& f_b_model,
+             const SigmaPoints& prior_X_b_i,
+             const SigmaPoints& noise_X_b_i,
+             const double delta_time,
+             SigmaPoints& predicted_X_b_i)
+    {
+        Input_b_i zero_input =
+            Input_b_i::Zero(f_b_model.standard_variate_dimension(), 1);
+
+        // the points outside of the [b_i  Q_b_i] partition are copies of the
+        // first point and share its prediction
+        const size_t joint_dimension = (prior_X_b_i.cols() - 1) / 2;
+        const size_t partition_offset = Dim(a) + Dim(Q_a);
+        const size_t partition_dimension = Dim(b_i) + Dim(Q_b_i);
 
         for (size_t i = 0; i < prior_X_b_i.cols(); ++i)
-        {            
-            f_b_->condition(delta_time, prior_X_b_i.col(i), zero_input);
+        {
+            if (i > 0 && UnscentedTransform::is_mean_point(
+                             i,
+                             joint_dimension,
+                             partition_offset,
+                             partition_dimension))
+            {
+                predicted_X_b_i.col(i) = predicted_X_b_i.col(0);
+                continue;
+            }
+
+            f_b_model.condition(delta_time, prior_X_b_i.col(i), zero_input);
             predicted_X_b_i.col(i)
-                    = f_b_->map_standard_normal(noise_X_b_i.col(i));
+                    = f_b_model.map_standard_normal(noise_X_b_i.col(i));
         }
     }
 
@@ -500,14 +643,26 @@ public:
            const SigmaPoints& noise_X_y_i,
            const size_t index,
            SigmaPoints& predicted_X_y_i)
+    {
+        h(*h_, prior_X_a, prior_X_b_i, noise_X_y_i, index, predicted_X_y_i);
+    }
+
+    void h(ObservationModel& h_model,
+           const SigmaPoints& prior_X_a,
+           const SigmaPoints& prior_X_b_i,
+           const SigmaPoints& noise_X_y_i,
+           const size_t index,
+           SigmaPoints& predicted_X_y_i)
     {
         predicted_X_y_i.resize(Dim(y_i), prior_X_a.cols());
 
+        // every point varies in at least one of the partitions a, Q_a, b_i,
+        // Q_b_i or R_y_i, hence all points are evaluated
         for (size_t i = 0; i < prior_X_a.cols(); ++i)
         {
-            h_->condition(prior_X_a.col(i), prior_X_b_i.col(i), i, index);
+            h_model.condition(prior_X_a.col(i), prior_X_b_i.col(i), i, index);
             predicted_X_y_i.col(i)
-                    = h_->map_standard_normal(noise_X_y_i.col(i));
+                    = h_model.map_standard_normal(noise_X_y_i.col(i));
         }
     }
 
@@ -663,7 +818,8 @@ public:
     {
         // assert sigma_points.rows() == mean.rows()
         size_t joint_dimension = (sigma_points.cols() - 1) / 2;
-        CovarianceMatrix covarianceSqr = covariance.llt().matrixL();
+        typename CovarianceMatrix::PlainObject covarianceSqr =
+                CholeskyFactor(covariance);
 
         covarianceSqr *=
                 std::sqrt(
@@ -674,7 +830,7 @@ public:
         //sigma_points.setZero();
         sigma_points.col(0) = mean;
 
-        MeanVector pointShift;
+        typename MeanVector::PlainObject pointShift;
         for (size_t i = 1; i <= joint_dimension; ++i)
         {
             if (offset + 1 <= i && i < offset + 1 + covariance.rows())
@@ -693,6 +849,391 @@ public:
     }
 
 
+protected:
+    /** \cond INTERNAL */
+    /**
+     * \return Lower Cholesky factor of the given covariance
+     */
+    template <typename CovarianceMatrix>
+    typename std::enable_if<
+        CovarianceMatrix::SizeAtCompileTime != 1,
+        typename CovarianceMatrix::PlainObject
+    >::type
+    CholeskyFactor(const CovarianceMatrix& covariance)
+    {
+        return covariance.llt().matrixL();
+    }
+
+    /**
+     * \return Standard deviation of the given 1x1 covariance
+     */
+    template <typename CovarianceMatrix>
+    typename std::enable_if<
+        CovarianceMatrix::SizeAtCompileTime == 1,
+        typename CovarianceMatrix::PlainObject
+    >::type
+    CholeskyFactor(const CovarianceMatrix& covariance)
+    {
+        typename CovarianceMatrix::PlainObject factor;
+        factor(0, 0) = std::sqrt(covariance(0, 0));
+        return factor;
+    }
+
+    /**
+     * \brief Scratch sigma points of a single worker
+     */
+    struct Workspace
+    {
+        SigmaPoints X_b_i;
+        SigmaPoints Y;
+
+        /* compressed points, see CompressSigmaPoints() */
+        SigmaPoints X_b_i_compressed;
+        SigmaPoints Y_compressed;
+    };
+
+    /**
+     * Predicts the joint state [a  b_i  y_i] of a single partition. Requires
+     * the sigma point partitions X_ and the normalized predicted points
+     * X_a_norm_ of the cohesive state.
+     *
+     * \param [in]  prior_partition      Prior of the partition
+     * \param [in]  delta_time
+     * \param [in]  index                Index of the partition
+     * \param [in]  workspace            Scratch sigma points
+     * \param [in]  f_b_model            Factorized state process model
+     * \param [in]  h_model              Observation model
+     * \param [out] predicted_partition  Predicted partition
+     */
+    template <typename PriorPartition, typename PredictedPartition>
+    void PredictPartition(const PriorPartition& prior_partition,
+                          double delta_time,
+                          size_t index,
+                          Workspace& workspace,
+                          FactorizedStateProcessModel& f_b_model,
+                          ObservationModel& h_model,
+                          PredictedPartition&& predicted_partition)
+    {
+        SigmaPoints& X_b_i = workspace.X_b_i;
+        SigmaPoints& Y = workspace.Y;
+
+        X_b_i.resize(X_[b_i].rows(), X_[b_i].cols());
+
+        ComputeSigmaPoints(prior_partition.mean_b,
+                           prior_partition.cov_bb,
+                           Dim(a) + Dim(Q_a),
+                           X_b_i);
+
+        f_b(f_b_model, X_b_i, X_[Q_b_i], delta_time, X_b_i);
+        h(h_model, X_[a], X_b_i, X_[R_y_i], index, Y);
+
+        mean(X_b_i, predicted_partition.mean_b);
+        mean(Y, predicted_partition.mean_y);
+
+        Normalize(predicted_partition.mean_b, X_b_i);
+        Normalize(predicted_partition.mean_y, Y);
+
+        CompressSigmaPoints(X_b_i, true, workspace.X_b_i_compressed);
+        CompressSigmaPoints(Y, false, workspace.Y_compressed);
+
+        ComputePartitionCovariances(workspace, predicted_partition);
+    }
+
+    /**
+     * Compresses normalized sigma points of the joint transform onto the
+     * columns of the [b_i  Q_b_i] partition.
+     *
+     * The points of X_b_i differ from the first one only in the 2p columns
+     * of the [b_i  Q_b_i] partition, p = dim(b_i) + dim(Q_b_i). The
+     * remaining r = 2n - 2p normalized points are identical, say c. Any
+     * product \f$X Z^T\f$ with Z = X_b_i therefore reduces to the first
+     * column, the 2p partition columns and the single term
+     * \f$(\sum_{j \in R} x_j) c^T\f$. The compressed points hold
+     *
+     * [x_0  X_{b_i}  X_{Q_{b_i}}  (\sum_{j \in R} x_j) / \sqrt{r}]
+     *
+     * such that \f$X_c Z_c^T = X Z^T\f$.
+     *
+     * \param [in]  X               Normalized sigma points
+     * \param [in]  constant_rest   True if the remaining points of X are
+     *                              identical, i.e. X = X_b_i. Their sum is
+     *                              then taken from a single point.
+     * \param [out] X_compressed    Compressed points with 2p + 2 columns, or
+     *                              2p + 1 if there are no remaining points
+     */
+    void CompressSigmaPoints(const SigmaPoints& X,
+                             bool constant_rest,
+                             SigmaPoints& X_compressed)
+    {
+        const size_t joint_dimension = (X.cols() - 1) / 2;
+        const size_t offset = Dim(a) + Dim(Q_a);
+        const size_t dimension = Dim(b_i) + Dim(Q_b_i);
+        const size_t rest = 2 * (joint_dimension - dimension);
+
+        X_compressed.resize(X.rows(), 1 + 2 * dimension + (rest > 0 ? 1 : 0));
+
+        X_compressed.col(0) = X.col(0);
+        X_compressed.middleCols(1, dimension) =
+                X.middleCols(1 + offset, dimension);
+        X_compressed.middleCols(1 + dimension, dimension) =
+                X.middleCols(1 + joint_dimension + offset, dimension);
+
+        if (rest == 0) return;
+
+        if (constant_rest)
+        {
+            // any point outside of the partition represents the rest
+            const size_t j = offset > 0 ? 1 : 1 + offset + dimension;
+
+            X_compressed.col(1 + 2 * dimension) =
+                    std::sqrt(double(rest)) * X.col(j);
+        }
+        else
+        {
+            X_compressed.col(1 + 2 * dimension) =
+                    (X.rowwise().sum()
+                     - X_compressed.leftCols(1 + 2 * dimension)
+                                   .rowwise().sum())
+                    / std::sqrt(double(rest));
+        }
+    }
+
+    /**
+     * Computes the covariances of a partition from its normalized sigma
+     * points. The covariances with b_i are computed from the compressed
+     * points with 2p + 2 columns, p = dim(b_i) + dim(Q_b_i), e.g. cov_ab in
+     * O(dim(a) dim(b_i) p) instead of O(dim(a) dim(b_i) n). The products
+     * cov_ay and cov_yy run over all n points, and compressing the points of
+     * b_i and y_i beforehand is O(n) as well. A partition therefore still
+     * costs O(dim(a) dim(y_i) n) overall.
+     */
+    template <typename Partition, typename RT = void>
+    typename std::enable_if<!ScalarPartitions, RT>::type
+    ComputePartitionCovariances(const Workspace& workspace,
+                                Partition&& partition)
+    {
+        const SigmaPoints& X_b_i = workspace.X_b_i_compressed;
+        const SigmaPoints& Y = workspace.Y;
+
+        partition.cov_ab = X_a_compressed_ * X_b_i.transpose();
+        partition.cov_ay = X_a_norm_ * Y.transpose();
+        partition.cov_bb = X_b_i * X_b_i.transpose();
+
+        partition.cov_by = X_b_i * workspace.Y_compressed.transpose();
+        partition.cov_yy = Y * Y.transpose();
+    }
+
+    /**
+     * Computes the covariances of a partition from its normalized sigma
+     * points, one-dimensional b_i and y_i. The sigma points of b_i and y_i
+     * are single rows, hence all products but the cross-covariances with a
+     * are dot products.
+     */
+    template <typename Partition, typename RT = void>
+    typename std::enable_if<ScalarPartitions, RT>::type
+    ComputePartitionCovariances(const Workspace& workspace,
+                                Partition&& partition)
+    {
+        auto&& X_b_i = workspace.X_b_i_compressed.row(0);
+        auto&& Y = workspace.Y.row(0);
+
+        partition.cov_ab.noalias() = X_a_compressed_ * X_b_i.transpose();
+        partition.cov_ay.noalias() = X_a_norm_ * Y.transpose();
+        partition.cov_bb(0, 0) = X_b_i.squaredNorm();
+
+        partition.cov_by(0, 0) = X_b_i.dot(workspace.Y_compressed.row(0));
+        partition.cov_yy(0, 0) = Y.squaredNorm();
+    }
+
+    /**
+     * \brief Information terms of the cohesive state a contributed by a
+     *        block of partitions
+     */
+    struct InformationAccumulator
+    {
+        /** \brief \f$\sum_i A_i^T \Sigma_{y_i|a}^{-1} A_i\f$ */
+        Cov_aa C;
+
+        /** \brief \f$\sum_i A_i^T \Sigma_{y_i|a}^{-1} (y_i - \mu_{y_i})\f$ */
+        State_a D;
+
+        /** \brief Number of accumulated partitions */
+        size_t count;
+
+        /* scratch buffers */
+        Cov_ay A_i_transpose;
+        Cov_yy cov_yy_given_a;
+        Eigen::Matrix<typename StateDistribution::Scalar,
+                      Observation::SizeAtCompileTime,
+                      State_a::SizeAtCompileTime> T_i_transpose;
+        Eigen::LLT<Cov_yy> llt;
+    };
+
+    /**
+     * Computes the inverse of the predicted cohesive covariance via its
+     * Cholesky factorization
+     */
+    template <typename Distribution>
+    void InvertCovariance_aa(const Distribution& predicted_state,
+                             Distribution& posterior_state)
+    {
+        const size_t dim_a = predicted_state.cov_aa.rows();
+
+        posterior_state.cov_aa_inverse =
+                predicted_state.cov_aa.llt().solve(
+                    Cov_aa::Identity(dim_a, dim_a));
+    }
+
+    /**
+     * Sums the information terms of all partitions. The partitions are
+     * accumulated in blocks of fixed size, each block into its own
+     * accumulator. The blocks are distributed among the workers of the thread
+     * pool, if set. The block accumulators are then reduced pairwise. The
+     * order of all additions is fixed, hence the sum does not depend on the
+     * number of threads.
+     *
+     * \param count         Number of partitions
+     * \param accumulate    Callable adding the terms of the i-th partition to
+     *                      the given accumulator
+     *
+     * \return Accumulator holding the sum of all partitions
+     */
+    template <typename Accumulate>
+    const InformationAccumulator& AccumulateInformation(size_t count,
+                                                        Accumulate accumulate)
+    {
+        const size_t block_size = 256;
+        const size_t blocks = std::max(size_t(1),
+                                       (count + block_size - 1) / block_size);
+        const size_t dim_a = Dim(a);
+
+        if (accumulators_.size() < blocks) accumulators_.resize(blocks);
+
+        auto accumulate_block = [&](size_t block, size_t)
+        {
+            InformationAccumulator& accumulator = accumulators_[block];
+            accumulator.C.setZero(dim_a, dim_a);
+            accumulator.D.setZero(dim_a, 1);
+            accumulator.count = 0;
+
+            const size_t end = std::min(count, (block + 1) * block_size);
+            for (size_t i = block * block_size; i < end; ++i)
+            {
+                accumulate(i, accumulator);
+            }
+        };
+
+        if (thread_pool_ && thread_pool_->size() > 1 && blocks > 1)
+        {
+            thread_pool_->parallel_for(0, blocks, accumulate_block);
+        }
+        else
+        {
+            for (size_t block = 0; block < blocks; ++block)
+            {
+                accumulate_block(block, 0);
+            }
+        }
+
+        // pairwise tree reduction into the first accumulator
+        for (size_t stride = 1; stride < blocks; stride *= 2)
+        {
+            for (size_t block = 0; block + stride < blocks; block += 2 * stride)
+            {
+                InformationAccumulator& left = accumulators_[block];
+                const InformationAccumulator& right =
+                        accumulators_[block + stride];
+
+                left.C += right.C;
+                left.D += right.D;
+                left.count += right.count;
+            }
+        }
+
+        return accumulators_[0];
+    }
+
+    /**
+     * Updates the cohesive state given the accumulated information terms. The
+     * posterior information matrix \f$\Sigma_{aa}^{-1} + C\f$ is factorized
+     * once and used to solve for the posterior covariance and mean.
+     *
+     * \return False if no information has been accumulated. The cohesive
+     *         state is not updated in that case.
+     */
+    template <typename Distribution>
+    bool UpdateCohesiveState(const Distribution& predicted_state,
+                             const InformationAccumulator& information,
+                             Distribution& posterior_state)
+    {
+        if (!information.count)
+        {
+            return false;
+        }
+
+        const size_t dim_a = predicted_state.cov_aa.rows();
+
+        Eigen::LLT<Cov_aa> information_llt(
+            posterior_state.cov_aa_inverse + information.C);
+
+        posterior_state.cov_aa =
+                information_llt.solve(Cov_aa::Identity(dim_a, dim_a));
+        posterior_state.mean_a =
+                predicted_state.mean_a + information_llt.solve(information.D);
+
+        return true;
+    }
+
+    /**
+     * Calls function(i, workspace, f_b_model, h_model) for all partitions
+     * i in [0, count). Without a thread pool all partitions are processed in
+     * the calling thread. Otherwise the partitions are split into consecutive
+     * ranges which are distributed dynamically among the workers. Each worker
+     * uses its own workspace and model instances.
+     */
+    template <typename Function>
+    void for_each_partition(size_t count, Function function)
+    {
+        if (thread_pool_ && thread_pool_->size() > 1 && count > 1
+            && f_b_instances_.assign(f_b_, thread_pool_->size())
+            && h_instances_.assign(h_, thread_pool_->size()))
+        {
+            if (workspaces_.size() < thread_pool_->size())
+            {
+                workspaces_.resize(thread_pool_->size());
+            }
+
+            // a few ranges per worker balance the load of uneven partitions
+            const size_t ranges = std::min(count, 4 * thread_pool_->size());
+
+            thread_pool_->parallel_for(
+                0, ranges,
+                [&](size_t range, size_t worker)
+                {
+                    const size_t begin = range * count / ranges;
+                    const size_t end = (range + 1) * count / ranges;
+
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        function(i,
+                                 workspaces_[worker],
+                                 f_b_instances_[worker],
+                                 h_instances_[worker]);
+                    }
+                });
+        }
+        else
+        {
+            if (workspaces_.empty()) workspaces_.resize(1);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                function(i, workspaces_[0], *f_b_, *h_);
+            }
+        }
+    }
+    /** \endcond */
+
 public:
     CohesiveStateProcessModelPtr f_a_;
     FactorizedStateProcessModelPtr f_b_;
@@ -704,8 +1245,35 @@ public:
 
     // sigma points
     std::vector<SigmaPoints> X_;
-    SigmaPoints Y_;
     SigmaPoints X_a_norm_;
+    SigmaPoints X_a_compressed_;
+
+protected:
+    /** \cond INTERNAL */
+    /**
+     * \brief Optional thread pool predicting the partitions in parallel
+     */
+    std::shared_ptr<ThreadPool> thread_pool_;
+
+    /**
+     * \brief Scratch sigma points of each worker
+     */
+    std::vector<Workspace> workspaces_;
+
+    /**
+     * \brief Model instances of the thread pool workers
+     */
+    WorkerInstances<FactorizedStateProcessModel> f_b_instances_;
+    WorkerInstances<ObservationModel> h_instances_;
+
+    /**
+     * \brief Information accumulators of the partition blocks
+     */
+    std::vector<
+        InformationAccumulator,
+        Eigen::aligned_allocator<InformationAccumulator>
+    > accumulators_;
+    /** \endcond */
 };
 
 }
@@ -34,6 +34,7 @@
 #include <Eigen/Core>
 
 #include <fl/util/math.hpp>
+#include <fl/util/random.hpp>
 #include <fl/util/traits.hpp>
 #include <fl/util/profiling.hpp>
 #include <fl/util/assertions.hpp>
@@ -138,7 +139,9 @@ public:
             const Scalar& max_kl_divergence = 0)
         : observation_model_(observation_model),
           process_model_(process_model),
-          max_kl_divergence_(max_kl_divergence)
+          max_kl_divergence_(max_kl_divergence),
+          stream_(fl::next_stream()),
+          step_(0)
     {
         static_assert_base(
             ProcessModel,
@@ -178,10 +181,22 @@ public:
 
         for(size_t block_index = 0; block_index < sampling_blocks_.size(); block_index++)
         {
+            // each particle draws from its own counter-based substream which
+            // only depends on the filter stream, the step and the particle
+            // index. The particles are hence independent of each other and
+            // of the order they are processed in.
+            const std::uint64_t block_stream = fl::substream(stream_, step_++);
+            const size_t block_size = sampling_blocks_[block_index].size();
+
             for(size_t particle_index = 0; particle_index < samples_.size(); particle_index++)
             {
-                for(size_t i = 0; i < sampling_blocks_[block_index].size(); i++)
-                    noises_[particle_index](sampling_blocks_[block_index][i]) = unit_gaussian_.sample();
+                fl::Philox4x32 generator(
+                    fl::seed(), fl::substream(block_stream, particle_index));
+                NormalDistribution unit_gaussian;
+
+                for(size_t i = 0; i < block_size; i++)
+                    noises_[particle_index](sampling_blocks_[block_index][i]) =
+                            unit_gaussian(generator);
 
                 next_samples_[particle_index] =
                         process_model_->predict_state(delta_time,
@@ -327,8 +342,10 @@ private:
     std::vector<std::vector<size_t>> sampling_blocks_;
     Scalar max_kl_divergence_;
 
-    // distribution for sampling
-    StandardGaussian<Scalar> unit_gaussian_;
+    // random streams for sampling
+    typedef typename NormalDistributionOf<Scalar>::Type NormalDistribution;
+    std::uint64_t stream_;
+    std::uint64_t step_;
 };
 
 }
@@ -25,9 +25,10 @@
 
 #include <Eigen/Dense>
 
-#include <vector>
+#include <bitset>
 #include <string>
 #include <cstddef>
+#include <initializer_list>
 #include <type_traits>
 
 #include <fl/util/traits.hpp>
@@ -78,6 +79,16 @@ struct Traits<Gaussian<Var>>
      */
     typedef Eigen::Matrix<Scalar, Dimension, 1> StandardVariate;
 
+    /**
+     * \brief Matrix of multiple variates stored column-wise
+     */
+    typedef Eigen::Matrix<Scalar, Dimension, Eigen::Dynamic> Variates;
+
+    /**
+     * \brief Matrix of multiple standard variates stored column-wise
+     */
+    typedef Eigen::Matrix<Scalar, Dimension, Eigen::Dynamic> StandardVariates;
+
     /**
      * \brief Second moment type
      */
@@ -196,8 +207,11 @@ public:
     typedef typename Traits<This>::Scalar           Scalar;
     typedef typename Traits<This>::SecondMoment     SecondMoment;
     typedef typename Traits<This>::StandardVariate  StandardVariate;
+    typedef typename Traits<This>::Variates         Variates;
+    typedef typename Traits<This>::StandardVariates StandardVariates;
 
     using Traits<This>::GaussianMappingBase::standard_variate_dimension;
+    using Traits<This>::GaussianMappingBase::sample;
 
 protected:
     /** \cond INTERNAL */
@@ -215,6 +229,7 @@ protected:
         DiagonalCovarianceMatrix, /**< Diagonal form of the of cov. mat. */
         DiagonalPrecisionMatrix,  /**< Diagonal form of the inv cov. mat. */
         DiagonalSquareRootMatrix, /**< Diagonal form of the Cholesky decomp. */
+        Factorization,            /**< LDLT decomp. of the cov. mat. */
         Rank,                     /**< Covariance Rank */
         Normalizer,               /**< Log probability normalizer */
 
@@ -233,9 +248,9 @@ public:
      *                  initialized to 0.
      */
     explicit Gaussian(int dim = DimensionOf<Variate>()):
-        Traits<This>::GaussianMappingBase(dim),
-        dirty_(Attributes, true)
+        Traits<This>::GaussianMappingBase(dim)
     {
+        dirty_.set();
         static_assert(Variate::SizeAtCompileTime != 0,
                       "Illegal static dimension");
         set_standard();
@@ -257,7 +272,7 @@ public:
     /**
      * \return Gaussian first moment
      */
-    virtual Variate mean() const
+    virtual const Variate& mean() const
     {
         return mean_;
     }
@@ -278,7 +293,7 @@ public:
      *       = {Valid Representations} \f$ \cup \f$ {#CovarianceMatrix}
      * \endcond
      */
-    virtual SecondMoment covariance() const
+    virtual const SecondMoment& covariance() const
     {
         if (dimension() == 0)
         {
@@ -362,7 +377,8 @@ public:
             {
             case CovarianceMatrix:
             case SquareRootMatrix:
-                precision_ = covariance().inverse();
+                precision_ = factorization().solve(
+                    SecondMoment::Identity(dimension(), dimension()));
                 break;
 
             case DiagonalCovarianceMatrix:
@@ -422,8 +438,7 @@ public:
             case CovarianceMatrix:
             case PrecisionMatrix:
             {
-                Eigen::LDLT<SecondMoment> ldlt;
-                ldlt.compute(covariance());
+                const Eigen::LDLT<SecondMoment>& ldlt = factorization();
                 Variate D_sqrt = ldlt.vectorD();
                 for(size_t i = 0; i < D_sqrt.rows(); ++i)
                 {
@@ -455,6 +470,35 @@ public:
         return square_root_;
     }
 
+    /**
+     * \return LDLT factorization \f$P^T L D L^T P\f$ of the covariance matrix
+     *
+     * The factorization is computed once and shared by all derived quantities
+     * such as the square root, the precision, the rank and the log normalizer.
+     * It remains valid until the Gaussian is modified. Along with the
+     * factorization, the scaled factor \f$L D^{1/2}\f$ used to whiten samples
+     * is cached.
+     *
+     * \throws see covariance()
+     *
+     * \cond INTERNAL
+     * \pre |{Valid Representations}| > 0
+     * \post {Valid Representations}
+     *       = {Valid Representations} \f$ \cup \f$ {#Factorization}
+     * \endcond
+     */
+    virtual const Eigen::LDLT<SecondMoment>& factorization() const
+    {
+        if (is_dirty(Factorization))
+        {
+            factorization_.compute(covariance());
+            update_whitening_factor();
+            updated_internally(Factorization);
+        }
+
+        return factorization_;
+    }
+
     /**
      * \return True if the covariance matrix has a full rank
      *
@@ -463,15 +507,28 @@ public:
      * \cond INTERNAL
      * \pre |{Valid Representations}| > 0
      * \post {Valid Representations}
-     *       = {Valid Representations} \f$ \cup \f$ {#CovarianceMatrix}
+     *       = {Valid Representations} \f$ \cup \f$ {#Factorization}
      * \endcond
      */
     virtual bool has_full_rank() const
     {
         if (is_dirty(Rank))
         {
-            full_rank_ =
-               covariance().colPivHouseholderQr().rank() == covariance().rows();
+            full_rank_ = true;
+
+            const Variate D = covariance_diagonal();
+            const Scalar threshold = D.cwiseAbs().maxCoeff()
+                                     * Scalar(D.rows())
+                                     * std::numeric_limits<Scalar>::epsilon();
+
+            for (int i = 0; i < D.rows(); ++i)
+            {
+                if (std::fabs(D(i)) <= threshold)
+                {
+                    full_rank_ = false;
+                    break;
+                }
+            }
 
             updated_internally(Rank);
         }
@@ -487,7 +544,7 @@ public:
      * \cond INTERNAL
      * \pre |{Valid Representations}| > 0
      * \post {Valid Representations}
-     *       = {Valid Representations} \f$ \cup \f$ {#CovarianceMatrix}
+     *       = {Valid Representations} \f$ \cup \f$ {#Factorization}
      * \endcond
      */
     virtual Scalar log_normalizer() const
@@ -496,9 +553,11 @@ public:
         {
             if (has_full_rank())
             {
+                const Variate D = covariance_diagonal();
+
                 log_normalizer_ = -0.5
-                        * (log(covariance().determinant())
-                           + double(covariance().rows()) * log(2.0 * M_PI));
+                        * (D.array().abs().log().sum()
+                           + double(D.rows()) * log(2.0 * M_PI));
             }
             else
             {
@@ -521,22 +580,79 @@ public:
      * \cond INTERNAL
      * \pre |{Valid Representations}| > 0
      * \post {Valid Representations}
-     *       = {Valid Representations} \f$ \cup \f$ {#PrecisionMatrix}
+     *       = {Valid Representations} \f$ \cup \f$ {#Factorization}
      * \endcond
      */
     virtual Scalar log_probability(const Variate& vector) const
     {
         if(has_full_rank())
         {
-            return log_normalizer() - 0.5
-                    * (vector - mean()).transpose()
-                    * precision()
-                    * (vector - mean());
+            Variate delta = vector - mean();
+
+            return log_normalizer() - 0.5 * squared_mahalanobis(delta)(0);
         }
 
         return -std::numeric_limits<Scalar>::infinity();
     }
 
+    /**
+     * Evaluates the log probability of a set of samples at once.
+     *
+     * All samples are whitened by a single triangular solve against the
+     * cached scaled factor \f$L D^{1/2}\f$ of the covariance factorization
+     * followed by a column-wise squared norm reduction. Diagonal covariance
+     * representations are evaluated without factorizing.
+     *
+     * \param [in]  samples           \f$d \times N\f$ matrix (or an
+     *                                Eigen::Map) containing one sample
+     *                                per column
+     * \param [out] log_probabilities Vector receiving the \f$N\f$
+     *                                log probabilities. Besides plain
+     *                                vectors, Eigen::Map and block
+     *                                expressions of the right size are
+     *                                accepted.
+     *
+     * \throws see has_full_rank()
+     * \throws WrongSizeException
+     *
+     * \cond INTERNAL
+     * \pre |{Valid Representations}| > 0
+     * \post {Valid Representations}
+     *       = {Valid Representations} \f$ \cup \f$ {#Factorization}
+     * \endcond
+     */
+    template <typename Samples, typename LogProbabilities>
+    void log_probability(
+            const Eigen::MatrixBase<Samples>& samples,
+            const Eigen::MatrixBase<LogProbabilities>& log_probabilities) const
+    {
+        // Eigen's idiom for output arguments which may be temporaries such
+        // as blocks or maps
+        Eigen::MatrixBase<LogProbabilities>& result =
+            const_cast<Eigen::MatrixBase<LogProbabilities>&>(log_probabilities);
+
+        if (samples.rows() != dimension())
+        {
+            fl_throw(fl::WrongSizeException(samples.rows(), dimension()));
+        }
+
+        result.derived().resize(samples.cols());
+
+        if (!has_full_rank())
+        {
+            result.setConstant(-std::numeric_limits<Scalar>::infinity());
+            return;
+        }
+
+        Eigen::Matrix<
+            Scalar, Variate::SizeAtCompileTime, Samples::ColsAtCompileTime
+        > deltas = samples.colwise() - mean();
+
+        result = (log_normalizer()
+                  - 0.5 * squared_mahalanobis(deltas).array())
+                 .matrix().transpose();
+    }
+
     /**
      * \return a Gaussian sample of the type \c Vector determined by mapping a
      * noise sample into the Gaussian sample space
@@ -556,6 +672,46 @@ public:
         return mean() + square_root() * sample;
     }
 
+    /**
+     * \return A matrix of Gaussian samples determined by mapping a matrix of
+     * noise samples into the Gaussian sample space. All samples are mapped by
+     * a single matrix product \f$\mu + L Z\f$.
+     *
+     * \param samples   Noise samples, one per column
+     *
+     * \throws see square_root()
+     *
+     * \cond INTERNAL
+     * \pre |{Valid Representations}| > 0
+     * \post {Valid Representations}
+     *       = {Valid Representations} \f$ \cup \f$ {#SquareRootMatrix}
+     * \endcond
+     */
+    virtual Variates map_standard_normal(const StandardVariates& samples) const
+    {
+        Variates variates(dimension(), samples.cols());
+
+        variates.noalias() = square_root() * samples;
+        variates.colwise() += mean();
+
+        return variates;
+    }
+
+    /**
+     * \return A matrix of \c count Gaussian samples, one per column
+     *
+     * \param count   Number of samples
+     *
+     * The standard normal variates are drawn in bulk and mapped at once using
+     * map_standard_normal(const StandardVariates&).
+     *
+     * \throws see square_root()
+     */
+    virtual Variates sample(int count) const
+    {
+        return map_standard_normal(this->standard_gaussian().sample(count));
+    }
+
     /**
      * Sets the Gaussian to a standard distribution with zero mean and identity
      * covariance.
@@ -772,8 +928,121 @@ public:
         updated_externally(DiagonalPrecisionMatrix);
     }
 
+    /**
+     * Applies the low rank modification
+     * \f$\Sigma \leftarrow \Sigma + \sigma V V^T\f$ to the covariance matrix.
+     *
+     * Instead of refactorizing the modified covariance from scratch at
+     * \f$O(n^3)\f$, the cached factorization is updated column by column at
+     * a total cost of \f$O(n^2k)\f$ where \f$k\f$ is the number of columns
+     * of \f$V\f$.
+     *
+     * \param V     \f$n \times k\f$ update matrix
+     * \param sign  Sign \f$\sigma\f$ of the update. A negative sign results in
+     *              a downdate. The downdated covariance must remain positive
+     *              semi-definite.
+     *
+     * \cond INTERNAL
+     * \pre |{Valid Representations}| > 0
+     * \post {Valid Representations} = {#CovarianceMatrix, #Factorization}
+     * \endcond
+     *
+     * \throws WrongSizeException
+     */
+    template <typename UpdateMatrix>
+    void rank_update(const Eigen::MatrixBase<UpdateMatrix>& V, Scalar sign = 1)
+    {
+        if (V.rows() != dimension())
+        {
+            fl_throw(fl::WrongSizeException(V.rows(), dimension()));
+        }
+
+        // ensure that both the covariance and its factorization are available
+        factorization();
+
+        covariance_.noalias() += sign * V * V.transpose();
+        for (int i = 0; i < V.cols(); ++i)
+        {
+            factorization_.rankUpdate(V.col(i), sign);
+        }
+        update_whitening_factor();
+
+        updated_externally(CovarianceMatrix);
+        updated_internally(Factorization);
+    }
+
 protected:
     /** \cond INTERNAL */
+    /**
+     * \return The diagonal D of the covariance factorization. If the
+     *         covariance is represented in one of the diagonal forms, the
+     *         diagonal of the covariance is returned instead without
+     *         factorizing.
+     */
+    Variate covariance_diagonal() const
+    {
+        switch (select_first_representation({DiagonalCovarianceMatrix,
+                                             DiagonalSquareRootMatrix,
+                                             DiagonalPrecisionMatrix}))
+        {
+        case DiagonalCovarianceMatrix:
+        case DiagonalSquareRootMatrix:
+        case DiagonalPrecisionMatrix:
+            return covariance().diagonal();
+
+        default:
+            return factorization().vectorD();
+        }
+    }
+
+    /**
+     * \return The squared Mahalanobis distances
+     *         \f$\delta_i^T\Sigma^{-1}\delta_i\f$ of all columns of the given
+     *         matrix as a row vector
+     *
+     * \param deltas  Centered samples, one sample per column. The matrix is
+     *                used as workspace and is overwritten by the whitened
+     *                samples.
+     */
+    template <typename Deltas>
+    Eigen::Matrix<Scalar, 1, Deltas::ColsAtCompileTime>
+    squared_mahalanobis(Eigen::MatrixBase<Deltas>& deltas) const
+    {
+        switch (select_first_representation({DiagonalCovarianceMatrix,
+                                             DiagonalSquareRootMatrix,
+                                             DiagonalPrecisionMatrix}))
+        {
+        case DiagonalCovarianceMatrix:
+        case DiagonalSquareRootMatrix:
+        case DiagonalPrecisionMatrix:
+            return (deltas.array().square().colwise()
+                    / covariance().diagonal().array()).colwise().sum();
+
+        default:
+        {
+            const Eigen::LDLT<SecondMoment>& ldlt = factorization();
+
+            // whitening against L D^{1/2} reduces the squared Mahalanobis
+            // distance to the squared column norm
+            deltas = ldlt.transpositionsP() * deltas;
+            whitening_factor_.template triangularView<Eigen::Lower>()
+                .solveInPlace(deltas);
+
+            return deltas.colwise().squaredNorm();
+        }
+        }
+    }
+
+    /**
+     * Recomputes the scaled factor \f$L D^{1/2}\f$ from the current
+     * factorization
+     */
+    void update_whitening_factor() const
+    {
+        whitening_factor_ = factorization_.matrixL();
+        whitening_factor_ *= factorization_.vectorD().cwiseSqrt().asDiagonal();
+    }
+
     /**
      * Flags the specified attribute as valid and the rest of attributes as
      * dirty.
@@ -782,7 +1051,7 @@ protected:
      */
     virtual void updated_externally(Attribute attribute) const noexcept
     {
-        std::fill(dirty_.begin(), dirty_.end(), true);
+        dirty_.set();
         updated_internally(attribute);
     }
 
@@ -793,7 +1062,7 @@ protected:
      */
     virtual void updated_internally(Attribute attribute) const noexcept
     {
-        dirty_[attribute] = false;
+        dirty_.reset(attribute);
     }
 
     /**
@@ -839,7 +1108,7 @@ protected:
      * most efficiently other  representations.
      */
     virtual Attribute select_first_representation(
-            const std::vector<Attribute>& representations) const noexcept
+            std::initializer_list<Attribute> representations) const noexcept
     {
         for (auto& rep: representations)  if (!is_dirty(rep)) return rep;
         return Attributes;
@@ -852,9 +1121,11 @@ protected:
     mutable SecondMoment covariance_;  /**< \brief cov. form */
     mutable SecondMoment precision_;   /**< \brief cov. inverse form */
     mutable SecondMoment square_root_; /**< \brief cov. square root form */
+    mutable Eigen::LDLT<SecondMoment> factorization_; /**< \brief LDLT */
+    mutable SecondMoment whitening_factor_; /**< \brief LDLT factor L D^1/2 */
     mutable bool full_rank_;           /**< \brief full rank flag */
     mutable Scalar log_normalizer_;    /**< \brief log normalizing constant */
-    mutable std::vector<bool> dirty_;  /**< \brief data validity flags */
+    mutable std::bitset<Attributes> dirty_; /**< \brief data validity flags */
     /** \endcond */
 };
 
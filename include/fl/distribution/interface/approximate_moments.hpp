@@ -37,12 +37,21 @@ namespace fl
  *                          first moment type.
  * \tparam SecondMoment     Second central moment type (e.g. Variance or the
  *                          Covariance)
+ * \tparam MeanResult       Return type of the first moment accessor
+ * \tparam CovarianceResult Return type of the second moment accessor
  *
  * The ApproximateMoments interface provides access to a numerical approximation
- * of the first moments of a distribution.
+ * of the first moments of a distribution. By default the moments are returned
+ * by const reference to avoid copying potentially large covariance matrices on
+ * every access. This requires the implementation to store the moments.
+ * Distributions which assemble their moments on demand, such as joint
+ * distributions, return them by value instead.
  *
  */
-template <typename Variate, typename SecondMoment>
+template <typename Variate,
+          typename SecondMoment,
+          typename MeanResult = const Variate&,
+          typename CovarianceResult = const SecondMoment&>
 class ApproximateMoments
 {
 public:
@@ -56,7 +65,7 @@ public:
      *
      * \f$ \mu_{approx} \approx \sum\limits_i x_i p(x_i)\f$
      */
-    virtual Variate approximate_mean() const = 0;
+    virtual MeanResult approximate_mean() const = 0;
 
     /**
      * \return Second centeral moment, the covariance
@@ -64,7 +73,7 @@ public:
      * \f$ \Sigma_{approx} \approx
      *     \sum\limits_i (x_i - \mu)(x_i - \mu)^T \f$
      */
-    virtual SecondMoment approximate_covariance() const = 0;
+    virtual CovarianceResult approximate_covariance() const = 0;
 };
 
 }
@@ -41,14 +41,21 @@ namespace fl
  *                        simply the second central moment, the variance or
  *                        covariance \f$Var(X) = Cov(X, X)\f$. Both have the
  *                        same type \c SecondMoment.
+ * \tparam MeanResult     Return type of mean(), see ApproximateMoments
+ * \tparam CovarianceResult Return type of covariance(), see
+ *                          ApproximateMoments
  *
  *
  * The Moments interface provides access to the exact first moments of
  * a distribution. The moments represent a subset of the approximate moments.
  */
-template <typename Variate, typename SecondMoment>
+template <typename Variate,
+          typename SecondMoment,
+          typename MeanResult = const Variate&,
+          typename CovarianceResult = const SecondMoment&>
 class Moments:
-    public ApproximateMoments<Variate, SecondMoment>
+    public ApproximateMoments<
+               Variate, SecondMoment, MeanResult, CovarianceResult>
 {
 public:    
     /**
@@ -60,8 +67,11 @@ public:
      * \return First moment of the underlying distribution, the mean
      *
      * \f$ \mu = \sum\limits_i x_i p(x_i)\f$
+     *
+     * A returned reference remains valid as long as the distribution exists
+     * and is not modified.
      */
-    virtual Variate mean() const = 0;
+    virtual MeanResult mean() const = 0;
 
     /**
      * \return Second centered moment of the underlying distribution,
@@ -70,12 +80,12 @@ public:
      * \f$ \Sigma =
      *     \sum\limits_i (x_i - \mu)(x_i - \mu)^T \f$
      */
-    virtual SecondMoment covariance() const = 0;
+    virtual CovarianceResult covariance() const = 0;
 
     /**
      * \copydoc ApproximateMoments::approximate_mean
      */
-    virtual Variate approximate_mean() const
+    virtual MeanResult approximate_mean() const
     {
         return mean();
     }
@@ -83,7 +93,7 @@ public:
     /**
      * \copydoc ApproximateMoments::approximate_covariance
      */
-    virtual SecondMoment approximate_covariance() const
+    virtual CovarianceResult approximate_covariance() const
     {
         return covariance();
     }
@@ -103,6 +103,15 @@ public:
         standard_gaussian_.dimension(snv_dimension);
     }
 
+protected:
+    /**
+     * \return The SNV generator used for sampling
+     */
+    const StandardGaussian<StandardVariate>& standard_gaussian() const
+    {
+        return standard_gaussian_;
+    }
+
 private:
     /**
      * \brief SNV generator
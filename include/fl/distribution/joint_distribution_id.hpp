@@ -59,7 +59,10 @@ struct Traits<
     typedef Eigen::Matrix<Scalar, Dimension, Dimension> SecondMoment;
     typedef std::tuple<Distribution...> MarginalDistributions;
 
-    typedef Moments<Variate, SecondMoment> MomentsInterface;
+    /* the joint moments are assembled on demand and returned by value */
+    typedef Moments<
+                Variate, SecondMoment, Variate, SecondMoment
+            > MomentsInterface;
 };
 
 /**
@@ -86,20 +89,27 @@ public:
      */
     virtual ~JointDistribution() { }
 
+    /**
+     * \return Joint mean composed of the marginal means
+     */
     virtual Variate mean() const
     {
         Variate mu = Variate(dimension(), 1);
 
-        mean_<sizeof...(Distribution)>(distributions_, mu);
+        collect_mean<sizeof...(Distribution)>(distributions_, mu);
 
         return mu;
     }
 
+    /**
+     * \return Block diagonal joint covariance composed of the marginal
+     *         covariances
+     */
     virtual SecondMoment covariance() const
     {
         SecondMoment cov = SecondMoment::Zero(dimension(), dimension());
 
-        covariance<sizeof...(Distribution)>(distributions_, cov);
+        collect_covariance<sizeof...(Distribution)>(distributions_, cov);
 
         return cov;
     }
@@ -130,7 +140,9 @@ private:
     }
 
     template <int Size, int k = 0>
-    void mean_(const MarginalDistributions& distr_tuple, Variate& mu, int offset = 0) const
+    void collect_mean(const MarginalDistributions& distr_tuple,
+                      Variate& mu,
+                      int offset = 0) const
     {
         auto&& distribution = std::get<k>(distr_tuple);
         const int dim = distribution.dimension();
@@ -139,13 +151,14 @@ private:
 
         if (Size == k + 1) return;
 
-        mean_<Size, k + (k + 1 < Size ? 1 : 0)>(distr_tuple, mu, offset + dim);
+        collect_mean<Size, k + (k + 1 < Size ? 1 : 0)>(
+            distr_tuple, mu, offset + dim);
     }
 
     template <int Size, int k = 0>
-    void covariance(const MarginalDistributions& distr,
-                    SecondMoment& cov,
-                    const int offset = 0) const
+    void collect_covariance(const MarginalDistributions& distr,
+                            SecondMoment& cov,
+                            const int offset = 0) const
     {
         auto& distribution = std::get<k>(distr);
         const int dim = distribution.dimension();
@@ -154,7 +167,8 @@ private:
 
         if (Size == k + 1) return;
 
-        covariance<Size, k + (k + 1 < Size ? 1 : 0)>(distr, cov, offset + dim);
+        collect_covariance<Size, k + (k + 1 < Size ? 1 : 0)>(
+            distr, cov, offset + dim);
     }
 };
 
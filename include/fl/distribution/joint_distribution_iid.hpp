@@ -57,7 +57,10 @@ struct Traits<
     typedef Eigen::Matrix<Scalar, Dimension, Dimension> SecondMoment;
     typedef Eigen::Matrix<Distribution, Count, 1> MarginalDistributions;
 
-    typedef Moments<Variate, SecondMoment> MomentsInterface;
+    /* the joint moments are assembled on demand and returned by value */
+    typedef Moments<
+                Variate, SecondMoment, Variate, SecondMoment
+            > MomentsInterface;
 };
 
 /**
@@ -98,12 +101,15 @@ public:
      */
     virtual ~JointDistribution() { }
 
+    /**
+     * \return Joint mean composed of the marginal means
+     */
     virtual Variate mean() const
     {
         Variate mu = Variate(dimension(), 1);
 
         int offset = 0;
-        for (int i = 0; i < Traits<This>::MarginalCount; ++i)
+        for (int i = 0; i < distributions_.rows(); ++i)
         {
             const MarginalDistribution& marginal = distributions_(i);
             int dim =  marginal.dimension();
@@ -116,6 +122,10 @@ public:
         return mu;
     }
 
+    /**
+     * \return Block diagonal joint covariance composed of the marginal
+     *         covariances
+     */
     virtual SecondMoment covariance() const
     {
         SecondMoment cov = SecondMoment::Zero(dimension(), dimension());
@@ -15,6 +15,7 @@
 
 #include <fl/util/random.hpp>
 #include <fl/util/traits.hpp>
+#include <fl/util/ziggurat_normal_distribution.hpp>
 #include <fl/util/math.hpp>
 #include <fl/distribution/interface/sampling.hpp>
 #include <fl/exception/exception.hpp>
@@ -22,17 +23,86 @@
 namespace fl
 {
 
+/**
+ * \ingroup random
+ *
+ * \brief Selects the default normal variate generator for the given scalar
+ *        type.
+ *
+ * The Ziggurat generator is used by default. Defining
+ * USE_STD_NORMAL_DISTRIBUTION selects \c std::normal_distribution instead.
+ */
+template <typename Scalar>
+struct DefaultNormalDistribution
+{
+#ifdef USE_STD_NORMAL_DISTRIBUTION
+    typedef std::normal_distribution<Scalar> Type;
+#else
+    typedef ZigguratNormalDistribution<Scalar> Type;
+#endif
+};
+
+/**
+ * \ingroup random
+ *
+ * \brief Default normal variate generator of a variate type, which is either a
+ *        floating point scalar or an Eigen vector
+ */
+template <typename Variate>
+struct NormalDistributionOf
+{
+    typedef typename DefaultNormalDistribution<
+                typename Variate::Scalar
+            >::Type Type;
+};
+
+/** \cond INTERNAL */
+template <> struct NormalDistributionOf<float>
+{
+    typedef DefaultNormalDistribution<float>::Type Type;
+};
+
+template <> struct NormalDistributionOf<double>
+{
+    typedef DefaultNormalDistribution<double>::Type Type;
+};
+
+template <> struct NormalDistributionOf<long double>
+{
+    typedef DefaultNormalDistribution<long double>::Type Type;
+};
+/** \endcond */
+
 /**
  * \ingroup distributions
+ *
+ * \tparam StandardVariate      Variate type
+ * \tparam NormalDistribution   Scalar normal variate generator, e.g.
+ *                              ZigguratNormalDistribution or
+ *                              \c std::normal_distribution
  */
-template <typename StandardVariate>
+template <
+    typename StandardVariate,
+    typename NormalDistribution =
+        typename NormalDistributionOf<StandardVariate>::Type
+>
 class StandardGaussian:
         public Sampling<StandardVariate>
 {
+public:
+    /**
+     * \brief Matrix type holding multiple standard variates, one per column
+     */
+    typedef Eigen::Matrix<
+                typename StandardVariate::Scalar,
+                StandardVariate::RowsAtCompileTime,
+                Eigen::Dynamic
+            > StandardVariates;
+
 public:
     explicit StandardGaussian(size_t dim = DimensionOf<StandardVariate>())
         : dimension_ (dim),
-          generator_(fl::seed()),
+          generator_(fl::seed(), fl::next_stream()),
           gaussian_distribution_(0.0, 1.0)
     {
     }
@@ -50,6 +120,25 @@ public:
         return gaussian_sample;
     }
 
+    /**
+     * \return A matrix of \c count standard normal samples, one per column
+     *
+     * \param count   Number of samples
+     *
+     * The matrix is filled in one contiguous sweep over its storage.
+     */
+    virtual StandardVariates sample(int count) const
+    {
+        StandardVariates gaussian_samples(dimension(), count);
+
+        fill_normal(gaussian_distribution_,
+                    generator_,
+                    gaussian_samples.data(),
+                    gaussian_samples.size());
+
+        return gaussian_samples;
+    }
+
     virtual int dimension() const
     {
         return dimension_;
@@ -72,8 +161,8 @@ public:
 
 private:
     int dimension_;
-    mutable fl::mt11213b generator_;
-    mutable std::normal_distribution<> gaussian_distribution_;
+    mutable fl::Philox4x32 generator_;
+    mutable NormalDistribution gaussian_distribution_;
 };
 
 
@@ -81,7 +170,7 @@ private:
 /**
  * Floating point implementation for Scalar types float, double and long double
  */
-template <typename Scalar>
+template <typename Scalar, typename NormalDistribution>
 class StandardGaussianFloatingPointScalarImpl
 {
     static_assert(
@@ -90,7 +179,7 @@ class StandardGaussianFloatingPointScalarImpl
 
 public:
     StandardGaussianFloatingPointScalarImpl()
-        : generator_(fl::seed()),
+        : generator_(fl::seed(), fl::next_stream()),
           gaussian_distribution_(Scalar(0.), Scalar(1.))
     { }
 
@@ -99,9 +188,21 @@ public:
         return gaussian_distribution_(generator_);
     }
 
+    Eigen::Matrix<Scalar, Eigen::Dynamic, 1> sample_impl(int count) const
+    {
+        Eigen::Matrix<Scalar, Eigen::Dynamic, 1> gaussian_samples(count);
+
+        fill_normal(gaussian_distribution_,
+                    generator_,
+                    gaussian_samples.data(),
+                    gaussian_samples.size());
+
+        return gaussian_samples;
+    }
+
 protected:
-    mutable fl::mt11213b generator_;
-    mutable std::normal_distribution<Scalar> gaussian_distribution_;
+    mutable fl::Philox4x32 generator_;
+    mutable NormalDistribution gaussian_distribution_;
 };
 /** \endcond */
 
@@ -110,10 +211,13 @@ protected:
  * Float floating point StandardGaussian specialization
  * \ingroup distributions
  */
-template <>
-class StandardGaussian<float>
+template <typename NormalDistribution>
+class StandardGaussian<float, NormalDistribution>
         : public Sampling<float>,
-          public StandardGaussianFloatingPointScalarImpl<float>
+          public StandardGaussianFloatingPointScalarImpl<
+                     float,
+                     NormalDistribution
+                 >
 {
 public:
     /**
@@ -123,16 +227,29 @@ public:
     {
         return this->sample_impl();
     }
+
+    /**
+     * \return A vector of \c count samples
+     *
+     * \param count   Number of samples
+     */
+    virtual Eigen::Matrix<float, Eigen::Dynamic, 1> sample(int count) const
+    {
+        return this->sample_impl(count);
+    }
 };
 
 /**
  * Double floating point StandardGaussian specialization
  * \ingroup distributions
  */
-template <>
-class StandardGaussian<double>
+template <typename NormalDistribution>
+class StandardGaussian<double, NormalDistribution>
         : public Sampling<double>,
-          public StandardGaussianFloatingPointScalarImpl<double>
+          public StandardGaussianFloatingPointScalarImpl<
+                     double,
+                     NormalDistribution
+                 >
 {
 public:
     /**
@@ -142,16 +259,29 @@ public:
     {
         return this->sample_impl();
     }
+
+    /**
+     * \return A vector of \c count samples
+     *
+     * \param count   Number of samples
+     */
+    virtual Eigen::Matrix<double, Eigen::Dynamic, 1> sample(int count) const
+    {
+        return this->sample_impl(count);
+    }
 };
 
 /**
  * Long double floating point StandardGaussian specialization
  * \ingroup distributions
  */
-template <>
-class StandardGaussian<long double>
+template <typename NormalDistribution>
+class StandardGaussian<long double, NormalDistribution>
         : public Sampling<long double>,
-          public StandardGaussianFloatingPointScalarImpl<long double>
+          public StandardGaussianFloatingPointScalarImpl<
+                     long double,
+                     NormalDistribution
+                 >
 {
 public:
     /**
@@ -161,6 +291,16 @@ public:
     {
         return this->sample_impl();
     }
+
+    /**
+     * \return A vector of \c count samples
+     *
+     * \param count   Number of samples
+     */
+    virtual Eigen::Matrix<long double, Eigen::Dynamic, 1> sample(int count) const
+    {
+        return this->sample_impl(count);
+    }
 };
 
 }
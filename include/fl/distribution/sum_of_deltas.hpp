@@ -89,9 +89,10 @@ struct Traits<SumOfDeltas<Var>>
     typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Weights;
 
     /**
-     * \brief Moments interface of the SumOfDeltas distribution
+     * \brief Moments interface of the SumOfDeltas distribution. The moments
+     * are computed from the deltas on demand and returned by value.
      */
-    typedef Moments<Var, SecondMoment> MomentsBase;
+    typedef Moments<Var, SecondMoment, Var, SecondMoment> MomentsBase;
 };
 
 /**
@@ -190,10 +191,10 @@ public:
      */
     virtual SecondMoment covariance() const
     {
-        Variate mu = mean();
+        const Variate mu = mean();
         SecondMoment cov(SecondMoment::Zero(dimension(), dimension()));
         for(size_t i = 0; i < deltas_.size(); i++)
-            cov += weights_[i] * (deltas_[i]-mu) * (deltas_[i]-mu).transpose();
+            cov += weights_[i] * (deltas_[i] - mu) * (deltas_[i] - mu).transpose();
 
         return cov;
     }
@@ -0,0 +1,386 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file fixed_lag_smoother.hpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#ifndef FL__FILTER__FIXED_LAG_SMOOTHER_HPP
+#define FL__FILTER__FIXED_LAG_SMOOTHER_HPP
+
+#include <vector>
+#include <memory>
+
+#include <Eigen/Dense>
+
+#include <fl/util/traits.hpp>
+#include <fl/exception/exception.hpp>
+#include <fl/filter/filter_interface.hpp>
+
+namespace fl
+{
+
+template <typename Filter> class FixedLagSmoother;
+
+/**
+ * Traits of the FixedLagSmoother
+ */
+template <typename Filter>
+struct Traits<FixedLagSmoother<Filter>>
+{
+    typedef FixedLagSmoother<Filter> Smoother;
+
+    /*
+     * Required concept (interface) types
+     *
+     * - Ptr
+     * - State
+     * - Input
+     * - Observation
+     * - StateDistribution
+     */
+    typedef std::shared_ptr<Smoother> Ptr;
+    typedef typename Traits<Filter>::State State;
+    typedef typename Traits<Filter>::Input Input;
+    typedef typename Traits<Filter>::Observation Observation;
+    typedef typename Traits<Filter>::StateDistribution StateDistribution;
+};
+
+/**
+ * \ingroup filters
+ *
+ * \brief Fixed-lag Rauch-Tung-Striebel smoother wrapping a Gaussian filter
+ *
+ * The smoother forwards all filter steps to the wrapped filter and records
+ * the last \f$L + 1\f$ filtered distributions, the predictions and the
+ * smoother gains
+ *
+ * \f$ G_t = \text{Cov}(x_t, x_{t+1}) \bar{\Sigma}_{t+1}^{-1} \f$
+ *
+ * in a ring buffer. The smoothed distributions of the recorded steps
+ *
+ * \f$ \tilde{x}_t = \hat{x}_t + G_t (\tilde{x}_{t+1} - \bar{x}_{t+1}) \f$,
+ * \f$ \tilde{\Sigma}_t = \hat{\Sigma}_t
+ *     + G_t (\tilde{\Sigma}_{t+1} - \bar{\Sigma}_{t+1}) G_t^T \f$
+ *
+ * are computed by a backward pass over the buffer on the first access after
+ * a step, i.e. with \f$O(L)\f$ work per step. The buffer is allocated once
+ * and never grows. Fixed-size states are processed without any allocation.
+ *
+ * The wrapped filter has to provide the cross-covariance
+ * \f$\text{Cov}(x_t, x_{t+1})\f$ of its last prediction via
+ * \c cross_covariance(), e.g. the Kalman filter and the regular and square
+ * root unscented Kalman filters. The smoother enables its computation via
+ * \c compute_cross_covariance(true).
+ *
+ * \tparam Filter   Wrapped filter type
+ */
+template <typename Filter>
+class FixedLagSmoother
+    : public FilterInterface<FixedLagSmoother<Filter>>
+{
+protected:
+    /** \cond INTERNAL */
+    typedef FixedLagSmoother<Filter> This;
+    /** \endcond */
+
+public:
+    typedef typename Traits<This>::State State;
+    typedef typename Traits<This>::Input Input;
+    typedef typename Traits<This>::Observation Obsrv;
+    typedef typename Traits<This>::StateDistribution StateDistribution;
+    typedef typename StateDistribution::SecondMoment SecondMoment;
+
+protected:
+    /** \cond INTERNAL */
+    /**
+     * \brief Recorded step
+     */
+    struct Step
+    {
+        /** \brief Filtered distribution \f$\hat{x}_t, \hat{\Sigma}_t\f$ */
+        State mean;
+        SecondMoment covariance;
+
+        /** \brief Prediction \f$\bar{x}_{t+1}, \bar{\Sigma}_{t+1}\f$ */
+        State predicted_mean;
+        SecondMoment predicted_covariance;
+
+        /** \brief Smoother gain \f$G_t\f$ */
+        SecondMoment gain;
+    };
+    /** \endcond */
+
+public:
+    /**
+     * Creates a fixed-lag smoother
+     *
+     * \param filter    Wrapped filter
+     * \param lag       Number of steps \f$L\f$ the smoothed distributions
+     *                  reach back
+     */
+    FixedLagSmoother(const std::shared_ptr<Filter>& filter, size_t lag)
+        : filter_(filter),
+          steps_(lag + 1),
+          smoothed_(lag + 1),
+          first_(0),
+          count_(0),
+          smoothed_valid_(false)
+    {
+        filter_->compute_cross_covariance(true);
+    }
+
+    /**
+     * \copydoc FilterInterface::predict
+     *
+     * Records the prior as the filtered distribution of the current step and
+     * opens the next step with the predicted distribution. The oldest step is
+     * dropped if the buffer is full.
+     */
+    virtual void predict(double delta_time,
+                         const Input& input,
+                         const StateDistribution& prior_dist,
+                         StateDistribution& predicted_dist)
+    {
+        if (count_ == 0) push();
+
+        // the prior may alias the predicted distribution
+        Step& step = newest();
+        step.mean = prior_dist.mean();
+        step.covariance = prior_dist.covariance();
+
+        filter_->predict(delta_time, input, prior_dist, predicted_dist);
+
+        step.predicted_mean = predicted_dist.mean();
+        step.predicted_covariance = predicted_dist.covariance();
+
+        // G^T = Sigma_predicted^-1 Cov(x_t, x_t+1)^T
+        step.gain.noalias() = step.predicted_covariance.ldlt()
+                                  .solve(filter_->cross_covariance()
+                                             .transpose())
+                                  .transpose();
+
+        push();
+        newest().mean = step.predicted_mean;
+        newest().covariance = step.predicted_covariance;
+
+        smoothed_valid_ = false;
+    }
+
+    /**
+     * \copydoc FilterInterface::update
+     *
+     * Records the posterior as the filtered distribution of the current step
+     */
+    virtual void update(const Obsrv& observation,
+                        const StateDistribution& predicted_dist,
+                        StateDistribution& posterior_dist)
+    {
+        filter_->update(observation, predicted_dist, posterior_dist);
+
+        if (count_ == 0) push();
+
+        newest().mean = posterior_dist.mean();
+        newest().covariance = posterior_dist.covariance();
+
+        smoothed_valid_ = false;
+    }
+
+    /**
+     * \copydoc FilterInterface::predict_and_update
+     */
+    virtual void predict_and_update(double delta_time,
+                                    const Input& input,
+                                    const Obsrv& observation,
+                                    const StateDistribution& prior_dist,
+                                    StateDistribution& posterior_dist)
+    {
+        predict(delta_time, input, prior_dist, posterior_dist);
+        update(observation, posterior_dist, posterior_dist);
+    }
+
+    /**
+     * \return Smoothed distribution of the step the given number of steps
+     *         before the current one. The distribution of the current step,
+     *         age 0, is the filtered one.
+     *
+     * \param age   Age in [0, size())
+     *
+     * \throws OutOfBoundsException if no step of the given age is recorded
+     */
+    const StateDistribution& smoothed(size_t age) const
+    {
+        if (age >= count_)
+        {
+            fl_throw(OutOfBoundsException(age, count_));
+        }
+
+        smooth();
+
+        return smoothed_[slot(count_ - 1 - age)];
+    }
+
+    /**
+     * \return Smoothed distribution of the oldest recorded step, i.e. of the
+     *         step lag() steps ago once the buffer is filled
+     *
+     * \throws OutOfBoundsException if no step has been recorded yet
+     */
+    const StateDistribution& lagged() const
+    {
+        return smoothed(count_ == 0 ? 0 : count_ - 1);
+    }
+
+    /**
+     * \return Number of recorded steps, at most lag() + 1
+     */
+    size_t size() const
+    {
+        return count_;
+    }
+
+    /**
+     * \return Number of steps \f$L\f$ the smoothed distributions reach back
+     */
+    size_t lag() const
+    {
+        return steps_.size() - 1;
+    }
+
+    /**
+     * Drops all recorded steps. The buffer memory is kept.
+     */
+    void clear()
+    {
+        first_ = 0;
+        count_ = 0;
+        smoothed_valid_ = false;
+    }
+
+    const std::shared_ptr<Filter>& filter()
+    {
+        return filter_;
+    }
+
+protected:
+    /** \cond INTERNAL */
+    /**
+     * \return Buffer slot of the i-th recorded step, counted from the oldest
+     */
+    size_t slot(size_t i) const
+    {
+        return (first_ + i) % steps_.size();
+    }
+
+    /**
+     * \return Most recent step
+     */
+    Step& newest()
+    {
+        return steps_[slot(count_ - 1)];
+    }
+
+    /**
+     * Opens a new step and drops the oldest one if the buffer is full
+     */
+    void push()
+    {
+        if (count_ == steps_.size())
+        {
+            first_ = slot(1);
+        }
+        else
+        {
+            ++count_;
+        }
+    }
+
+    /**
+     * Backward pass over the recorded steps, from the current step to the
+     * oldest one
+     */
+    void smooth() const
+    {
+        if (smoothed_valid_) return;
+
+        const Step& last = steps_[slot(count_ - 1)];
+
+        // dynamic-size distributions are sized once
+        if (smoothed_[0].dimension() != last.mean.rows())
+        {
+            for (auto& distribution: smoothed_)
+            {
+                distribution.dimension(last.mean.rows());
+            }
+        }
+
+        smoothed_[slot(count_ - 1)].mean(last.mean);
+        smoothed_[slot(count_ - 1)].covariance(last.covariance);
+
+        for (size_t i = count_ - 1; i > 0; --i)
+        {
+            const Step& step = steps_[slot(i - 1)];
+            const StateDistribution& next = smoothed_[slot(i)];
+
+            mean_ = step.mean;
+            mean_.noalias() +=
+                step.gain * (next.mean() - step.predicted_mean);
+
+            difference_ = next.covariance() - step.predicted_covariance;
+            product_.noalias() = step.gain * difference_;
+            covariance_ = step.covariance;
+            covariance_.noalias() += product_ * step.gain.transpose();
+
+            smoothed_[slot(i - 1)].mean(mean_);
+            smoothed_[slot(i - 1)].covariance(covariance_);
+        }
+
+        smoothed_valid_ = true;
+    }
+    /** \endcond */
+
+protected:
+    std::shared_ptr<Filter> filter_;
+
+    /** \cond INTERNAL */
+    /**
+     * \brief Ring buffer of the recorded steps
+     */
+    std::vector<Step> steps_;
+
+    /**
+     * \brief Smoothed distributions, same slots as the steps
+     */
+    mutable std::vector<StateDistribution> smoothed_;
+
+    size_t first_;
+    size_t count_;
+    mutable bool smoothed_valid_;
+
+    /**
+     * \brief Backward pass buffers
+     */
+    mutable State mean_;
+    mutable SecondMoment covariance_;
+    mutable SecondMoment difference_;
+    mutable SecondMoment product_;
+    /** \endcond */
+};
+
+}
+
+#endif
@@ -23,6 +23,8 @@
 #define FL__FILTER__GAUSSIAN__GAUSSIAN_FILTER_KF_HPP
 
 #include <map>
+#include <cmath>
+#include <algorithm>
 #include <tuple>
 #include <memory>
 #include <typeinfo>
@@ -101,6 +103,15 @@ struct Traits<
      * the dimension of the \c State
      */
     typedef Gaussian<State> StateDistribution;
+
+    /**
+     * \brief KalmanGain Matrix
+     */
+    typedef Eigen::Matrix<
+                typename StateDistribution::Scalar,
+                State::RowsAtCompileTime,
+                Observation::RowsAtCompileTime
+            > KalmanGain;
 };
 
 /**
@@ -139,6 +150,7 @@ public:
     typedef typename Traits<This>::ObservationModel ObservationModel;
     typedef typename Traits<This>::ProcessModel ProcessModel;
     typedef typename Traits<This>::StateDistribution StateDistribution;
+    typedef typename Traits<This>::KalmanGain KalmanGain;
 
 public:
     /**
@@ -150,7 +162,11 @@ public:
     GaussianFilter(const std::shared_ptr<ProcessModel>& process_model,
                    const std::shared_ptr<ObservationModel>& obsrv_model)
         : process_model_(process_model),
-          obsrv_model_(obsrv_model) { }
+          obsrv_model_(obsrv_model),
+          sequential_update_(false),
+          steady_state_(false),
+          steady_prediction_(false),
+          steady_state_delta_time_(0.) { }
 
     /**
      * \copydoc FilterInterface::predict
@@ -170,20 +186,74 @@ public:
      * \f$ \bar{x}_{t} =  A \hat{x}_t\f$ and
      *
      * \f$ \bar{\Sigma}_{t} = A\hat{\Sigma}_{t}A^T + Q \f$
+     *
+     * The cross-covariance \f$\hat{\Sigma}_{t}A^T\f$ of the prior and the
+     * predicted state is kept, see cross_covariance().
      */
     virtual void predict(double delta_time,
                          const Input& input,
                          const StateDistribution& prior_dist,
                          StateDistribution& predicted_dist)
     {
-        auto&& A = (process_model_->A() * delta_time).eval();
-        auto&& Q = (process_model_->covariance() * delta_time).eval();
+        steady_prediction_ =
+            steady_state_ && delta_time == steady_state_delta_time_;
+
+        if (steady_prediction_)
+        {
+            mean_.noalias() = steady_state_A_ * prior_dist.mean();
+
+            predicted_dist.mean(mean_);
+            predicted_dist.covariance(steady_predicted_covariance_);
+            cross_covariance_ = steady_cross_covariance_;
+            return;
+        }
+
+        auto&& A = process_model_->discretized_A(delta_time);
+        auto&& Q = process_model_->discretized_covariance(delta_time);
+
+        cross_covariance_.noalias() = prior_dist.covariance() * A.transpose();
 
         predicted_dist.mean(
             A * prior_dist.mean());
 
         predicted_dist.covariance(
-            A * prior_dist.covariance() * A.transpose() + Q);
+            A * cross_covariance_ + Q);
+    }
+
+    /**
+     * Predicts several consecutive steps of the same length at once, e.g.
+     * while no measurements arrive. The transition and the noise covariance
+     * of all steps are composed by repeated squaring, see
+     * LinearGaussianProcessModel::fast_forward(), and applied in a single
+     * prediction.
+     *
+     * \param delta_time        Length of a single step
+     * \param steps             Number of steps
+     * \param input             Control input
+     * \param prior_dist        Prior state distribution
+     * \param predicted_dist    Predicted state distribution after all steps
+     */
+    virtual void predict(double delta_time,
+                         size_t steps,
+                         const Input&,
+                         const StateDistribution& prior_dist,
+                         StateDistribution& predicted_dist)
+    {
+        steady_prediction_ = false;
+
+        process_model_->fast_forward(delta_time,
+                                     steps,
+                                     fast_forward_A_,
+                                     fast_forward_covariance_);
+
+        cross_covariance_.noalias() =
+            prior_dist.covariance() * fast_forward_A_.transpose();
+
+        predicted_dist.mean(
+            fast_forward_A_ * prior_dist.mean());
+
+        predicted_dist.covariance(
+            fast_forward_A_ * cross_covariance_ + fast_forward_covariance_);
     }
 
     /**
@@ -206,6 +276,9 @@ public:
      * with the KalmanGain
      *
      * \f$ K = \bar{\Sigma}_{t}H^T (H\bar{\Sigma}_{t}H^T+R)^{-1}\f$.
+     *
+     * See sequential_update(bool) for the inversion free alternative and
+     * compute_steady_state() for the steady state mode.
      */
     virtual void update(const Obsrv& y,
                         const StateDistribution& predicted_dist,
@@ -214,6 +287,26 @@ public:
         auto&& H = obsrv_model_->H();
         auto&& R = obsrv_model_->covariance();
 
+        // the cached gain and posterior covariance only apply to a
+        // steady state prediction
+        if (steady_prediction_)
+        {
+            steady_prediction_ = false;
+
+            mean_ = predicted_dist.mean()
+                    + steady_state_gain_ * (y - H * predicted_dist.mean());
+
+            posterior_dist.mean(mean_);
+            posterior_dist.covariance(steady_posterior_covariance_);
+            return;
+        }
+
+        if (sequential_update_ && R.isDiagonal())
+        {
+            update_sequentially(y, H, R, predicted_dist, posterior_dist);
+            return;
+        }
+
         auto&& mean = predicted_dist.mean();
         auto&& cov_xx = predicted_dist.covariance();
 
@@ -237,9 +330,241 @@ public:
         update(observation, posterior_dist, posterior_dist);
     }
 
+    /**
+     * \return Cross-covariance \f$\text{Cov}(x_t, x_{t+1})\f$ of the prior
+     *         and the predicted state of the last predict() call, i.e.
+     *         \f$\hat{\Sigma}_{t}A^T\f$. Smoothers use it to compute
+     *         their gains.
+     */
+    const typename StateDistribution::SecondMoment& cross_covariance() const
+    {
+        return cross_covariance_;
+    }
+
+    /**
+     * The cross-covariance is part of the regular prediction and therefore
+     * always available. This exists for compatibility with the sigma point
+     * filters, see FixedLagSmoother.
+     */
+    void compute_cross_covariance(bool) { }
+
+    /**
+     * \return True, see compute_cross_covariance(bool)
+     */
+    bool compute_cross_covariance() const
+    {
+        return true;
+    }
+
+    const std::shared_ptr<ProcessModel>& process_model()
+    {
+        return process_model_;
+    }
+
+    const std::shared_ptr<ObservationModel>& observation_model()
+    {
+        return obsrv_model_;
+    }
+
+    /**
+     * Enables or disables the sequential update. If enabled and the
+     * observation noise covariance \f$R\f$ is diagonal, the observation
+     * components are incorporated one at a time as scalar measurements. This
+     * requires \f$O(mn^2)\f$ operations for an \f$m\f$ dimensional
+     * observation and an \f$n\f$ dimensional state and no matrix inversion.
+     * Otherwise the joint update is performed. The posterior is the same in
+     * both cases.
+     *
+     * \param enabled     Sequential update flag, disabled by default
+     */
+    void sequential_update(bool enabled)
+    {
+        sequential_update_ = enabled;
+    }
+
+    /**
+     * \return True if the sequential update is enabled
+     */
+    bool sequential_update() const
+    {
+        return sequential_update_;
+    }
+
+    /**
+     * Computes the steady state of the filter for time-invariant models and
+     * the given constant time step, and switches to the steady state mode.
+     *
+     * The steady state predicted covariance solves the discrete algebraic
+     * Riccati equation
+     *
+     * \f$ P = A (P - P H^T (H P H^T + R)^{-1} H P) A^T + Q \f$
+     *
+     * which is obtained by iterating the covariance recursion of the filter
+     * until convergence. In steady state mode the gain and both covariances
+     * are taken from the cache. predict() with the given time step and the
+     * subsequent update() reduce to \f$O(n^2)\f$ mean updates and the
+     * covariances of the passed distributions are ignored. A single filter
+     * may therefore track many targets sharing the same models. predict()
+     * with a different time step falls back to the regular prediction and
+     * the following update() to the regular update.
+     *
+     * The cache is not updated if the models change. Call this function
+     * again or disable_steady_state() in that case.
+     *
+     * \param delta_time       Constant time step
+     * \param tolerance        Convergence threshold of the maximum absolute
+     *                         change of the predicted covariance
+     * \param max_iterations   Maximum number of Riccati iterations
+     *
+     * \return True if the recursion converged. Otherwise the steady state
+     *         mode remains disabled.
+     */
+    bool compute_steady_state(double delta_time,
+                              double tolerance = 1.e-12,
+                              size_t max_iterations = 100000)
+    {
+        steady_state_ = false;
+        steady_prediction_ = false;
+
+        auto&& A = process_model_->discretized_A(delta_time);
+        auto&& Q = process_model_->discretized_covariance(delta_time);
+        auto&& H = obsrv_model_->H();
+        auto&& R = obsrv_model_->covariance();
+
+        auto P = Q;
+        auto P_next = Q;
+        auto P_posterior = Q;
+
+        for (size_t i = 0; i < max_iterations; ++i)
+        {
+            auto&& S = (H * P * H.transpose() + R).eval();
+            auto&& ldlt = S.ldlt();
+
+            // K^T = S^-1 H P
+            steady_state_gain_ = ldlt.solve(H * P).transpose();
+
+            P_posterior = P - steady_state_gain_ * H * P;
+            P_posterior = 0.5 * (P_posterior + P_posterior.transpose()).eval();
+
+            P_next = A * P_posterior * A.transpose() + Q;
+
+            const double change = (P_next - P).cwiseAbs().maxCoeff();
+
+            P = P_next;
+
+            if (!std::isfinite(change)) return false;
+
+            if (change <= tolerance * std::max(1., P.cwiseAbs().maxCoeff()))
+            {
+                auto&& S = (H * P * H.transpose() + R).eval();
+
+                steady_state_gain_ = S.ldlt().solve(H * P).transpose();
+                steady_posterior_covariance_ = P - steady_state_gain_ * H * P;
+                steady_predicted_covariance_ = P;
+                steady_cross_covariance_ =
+                    steady_posterior_covariance_ * A.transpose();
+                steady_state_A_ = A;
+                steady_state_delta_time_ = delta_time;
+                steady_state_ = true;
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Leaves the steady state mode
+     */
+    void disable_steady_state()
+    {
+        steady_state_ = false;
+        steady_prediction_ = false;
+    }
+
+    /**
+     * \return True if the filter operates in steady state mode
+     */
+    bool steady_state() const
+    {
+        return steady_state_;
+    }
+
+    /**
+     * \return Cached steady state Kalman gain
+     */
+    const KalmanGain& steady_state_gain() const
+    {
+        return steady_state_gain_;
+    }
+
+protected:
+    /** \cond INTERNAL */
+    /**
+     * Incorporates the observation components y(i) one after another. For
+     * each component with the sensor row \f$h_i\f$ and noise variance
+     * \f$r_i\f$
+     *
+     * \f$ s_i = h_i \Sigma h_i^T + r_i \f$
+     *
+     * \f$ x \leftarrow x + \Sigma h_i^T (y_i - h_i x) / s_i \f$
+     *
+     * \f$ \Sigma \leftarrow \Sigma - \Sigma h_i^T h_i \Sigma / s_i \f$
+     */
+    template <typename SensorMatrix, typename NoiseCovariance>
+    void update_sequentially(const Obsrv& y,
+                             const SensorMatrix& H,
+                             const NoiseCovariance& R,
+                             const StateDistribution& predicted_dist,
+                             StateDistribution& posterior_dist)
+    {
+        mean_ = predicted_dist.mean();
+        covariance_ = predicted_dist.covariance();
+
+        for (int i = 0; i < y.rows(); ++i)
+        {
+            projection_.noalias() = covariance_ * H.row(i).transpose();
+
+            const double s = H.row(i).dot(projection_) + R(i, i);
+            const double e = y(i) - H.row(i).dot(mean_);
+
+            mean_ += projection_ * (e / s);
+            covariance_.noalias() -=
+                projection_ * (projection_.transpose() / s);
+        }
+
+        posterior_dist.mean(mean_);
+        posterior_dist.covariance(covariance_);
+    }
+    /** \endcond */
+
 protected:
     std::shared_ptr<ProcessModel> process_model_;
     std::shared_ptr<ObservationModel> obsrv_model_;
+
+    /** \cond INTERNAL */
+    bool sequential_update_;
+    State mean_;
+    State projection_;
+    typename StateDistribution::SecondMoment covariance_;
+    typename StateDistribution::SecondMoment cross_covariance_;
+
+    typename ProcessModel::DynamicsMatrix fast_forward_A_;
+    typename ProcessModel::SecondMoment fast_forward_covariance_;
+
+    /**
+     * \brief Steady state cache
+     */
+    bool steady_state_;
+    bool steady_prediction_;
+    double steady_state_delta_time_;
+    KalmanGain steady_state_gain_;
+    typename ProcessModel::DynamicsMatrix steady_state_A_;
+    typename StateDistribution::SecondMoment steady_predicted_covariance_;
+    typename StateDistribution::SecondMoment steady_posterior_covariance_;
+    typename StateDistribution::SecondMoment steady_cross_covariance_;
+    /** \endcond */
 };
 
 }
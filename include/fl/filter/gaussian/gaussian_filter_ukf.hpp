@@ -24,10 +24,13 @@
 
 #include <map>
 #include <tuple>
+#include <vector>
 #include <memory>
+#include <algorithm>
 
 #include <fl/util/meta.hpp>
 #include <fl/util/traits.hpp>
+#include <fl/util/thread_pool.hpp>
 
 #include <fl/exception/exception.hpp>
 #include <fl/filter/filter_interface.hpp>
@@ -109,6 +112,24 @@ struct Traits<
     typedef PointSet<StateNoise, NumberOfPoints> StateNoisePointSet;
     typedef PointSet<ObsrvNoise, NumberOfPoints> ObsrvNoisePointSet;
 
+    /**
+     * \brief Column-wise batches of points passed to the models. The number
+     * of columns is bounded by the number of points, hence fixed-size
+     * batches never allocate.
+     */
+    typedef typename PointMatrixOf<
+                State, NumberOfPoints
+            >::Type StateMatrix;
+    typedef typename PointMatrixOf<
+                Observation, NumberOfPoints
+            >::Type ObsrvMatrix;
+    typedef typename PointMatrixOf<
+                StateNoise, NumberOfPoints
+            >::Type StateNoiseMatrix;
+    typedef typename PointMatrixOf<
+                ObsrvNoise, NumberOfPoints
+            >::Type ObsrvNoiseMatrix;
+
     /**
      * \brief KalmanGain Matrix
      */
@@ -153,6 +174,10 @@ protected:
     typedef typename Traits<This>::ObsrvPointSet ObsrvPointSet;
     typedef typename Traits<This>::StateNoisePointSet StateNoisePointSet;
     typedef typename Traits<This>::ObsrvNoisePointSet ObsrvNoisePointSet;
+    typedef typename Traits<This>::StateMatrix StateMatrix;
+    typedef typename Traits<This>::ObsrvMatrix ObsrvMatrix;
+    typedef typename Traits<This>::StateNoiseMatrix StateNoiseMatrix;
+    typedef typename Traits<This>::ObsrvNoiseMatrix ObsrvNoiseMatrix;
     /** \endcond */
 
 public:
@@ -201,7 +226,8 @@ public:
            * augmented Gaussian with the dimension global_dimension_
            */
           X_R(obsrv_model_->noise_dimension(),
-              PointSetTransform::number_of_points(global_dimension_))
+              PointSetTransform::number_of_points(global_dimension_)),
+          cross_covariance_enabled_(false)
     {
         /*
          * pre-compute the state noise points from the standard Gaussian
@@ -264,6 +290,43 @@ public:
          */
         X_r.resize(point_count);
         X_r.dimension(process_model_->state_dimension());
+
+        /*
+         * Determine the points which are exact copies of the first point,
+         * i.e. the mean. A point is a copy of the mean if it lies outside of
+         * the sigma point partitions of all random variables entering the
+         * model. The models are evaluated once for the first point and the
+         * result is broadcast to all copies.
+         *
+         * The prediction is a function of the state and state noise
+         * partitions, the observation prediction a function of the state and
+         * observation noise partitions.
+         */
+        const size_t state_dim = process_model_->state_dimension();
+        const size_t state_noise_dim = process_model_->noise_dimension();
+
+        predict_duplicates_.assign(point_count, false);
+        update_duplicates_.assign(point_count, false);
+
+        for (size_t i = 1; i < point_count; ++i)
+        {
+            const bool state_mean = PointSetTransform::is_mean_point(
+                i, global_dimension_, 0, state_dim);
+            const bool state_noise_mean = PointSetTransform::is_mean_point(
+                i, global_dimension_, state_dim, state_noise_dim);
+            const bool obsrv_noise_mean = PointSetTransform::is_mean_point(
+                i, global_dimension_, state_dim + state_noise_dim,
+                obsrv_model_->noise_dimension());
+
+            predict_duplicates_[i] = state_mean && state_noise_mean;
+            update_duplicates_[i] = state_mean && obsrv_noise_mean;
+        }
+
+        for (size_t i = 0; i < point_count; ++i)
+        {
+            if (!predict_duplicates_[i]) predict_points_.push_back(i);
+            if (!update_duplicates_[i]) update_points_.push_back(i);
+        }
     }
 
     /**
@@ -293,19 +356,15 @@ public:
                                       0,
                                       X_r);
 
+        /*
+         * Keep the centered prior points for the cross-covariance
+         */
+        if (cross_covariance_enabled_) prior_points_ = X_r.centered_points();
+
         /*
          * Predict each point X_r[i] and store the prediction back in X_r[i]
-         *
-         * X_r[i] = f(X_r[i], X_Q[i], u)
          */
-        const size_t point_count = X_r.count_points();
-        for (size_t i = 0; i < point_count; ++i)
-        {
-            X_r.point(i, process_model_->predict_state(delta_time,
-                                                       X_r.point(i),
-                                                       X_Q.point(i),
-                                                       input));
-        }
+        predict_points(delta_time, input);
 
         /*
          * Obtain the centered points matrix of the prediction. The columns of
@@ -342,6 +401,17 @@ public:
          */
         predicted_dist.mean(X_r.mean());
         predicted_dist.covariance(X * W.asDiagonal() * X.transpose());
+
+        /*
+         * The cross-covariance of the prior and the predicted state
+         *
+         * C = Sum W[i,i] * (X_prior[i]-mu_prior)(X_r[i]-mu_r)^T
+         */
+        if (cross_covariance_enabled_)
+        {
+            cross_covariance_.noalias() =
+                prior_points_ * W.asDiagonal() * X.transpose();
+        }
     }
 
     /**
@@ -358,8 +428,6 @@ public:
 
 //        std::cout << "point_set_transform_" << std::endl;
 
-        const size_t point_count = X_r.count_points();
-
 //        std::cout << "X_r.count_points() " << X_r.count_points() << std::endl;
 //        std::cout << "X_R.count_points() " << X_R.count_points() << std::endl;
 //        std::cout << "X_y.count_points() " << X_y.count_points() << std::endl;
@@ -368,17 +436,7 @@ public:
 //        std::cout << "X_R.dimension() " << X_R.dimension() << std::endl;
 //        std::cout << "X_y.dimension() " << X_y.dimension() << std::endl;
 
-        for (size_t i = 0; i < point_count; ++i)
-        {
-//            std::cout << "X_r.point(i) " << X_r.point(i).transpose() << std::endl;
-//            std::cout << "X_R.point(i) " << X_R.point(i).transpose() << std::endl;
-
-            X_y.point(i, obsrv_model_->predict_observation(X_r.point(i),
-                                                           X_R.point(i),
-                                                           0 /* delta time */));            
-
-//            std::cout << "X_y.point(i) " << X_y.point(i).transpose() << std::endl;
-        }
+        predict_observations();
 
 //        std::cout << "predict_observation" << std::endl;
 
@@ -409,8 +467,8 @@ public:
 //        std::cout << "cov_yy" << cov_yy << std::endl;
 //        std::cout << "cov_xy" << cov_xy << std::endl;
 
-        //const KalmanGain& K = cov_xy * cov_yy.inverse();
-        Eigen::MatrixXd K = cov_xy * cov_yy.inverse();
+        const KalmanGain K =
+            cov_yy.ldlt().solve(cov_xy.transpose()).transpose();
 
         posterior_dist.mean(X_r.mean() + K * innovation);
         posterior_dist.covariance(cov_xx - K * cov_yy * K.transpose());
@@ -429,6 +487,38 @@ public:
         update(observation, posterior_dist, posterior_dist);
     }
 
+    /**
+     * \return Cross-covariance \f$\text{Cov}(x_t, x_{t+1})\f$ of the prior
+     *         and the predicted state of the last predict() call. Smoothers
+     *         use it to compute their gains. The cross-covariance is only
+     *         computed if enabled by compute_cross_covariance(bool).
+     */
+    const typename StateDistribution::SecondMoment& cross_covariance() const
+    {
+        return cross_covariance_;
+    }
+
+    /**
+     * Enables or disables the computation of the cross-covariance in
+     * predict(). This keeps a copy of the prior points and costs an
+     * additional \f$n \times n\f$ product per prediction. Smoothers enable
+     * it, e.g. FixedLagSmoother.
+     *
+     * \param enabled     Cross-covariance flag, disabled by default
+     */
+    void compute_cross_covariance(bool enabled)
+    {
+        cross_covariance_enabled_ = enabled;
+    }
+
+    /**
+     * \return True if predict() computes the cross-covariance
+     */
+    bool compute_cross_covariance() const
+    {
+        return cross_covariance_enabled_;
+    }
+
     const std::shared_ptr<ProcessModel>& process_model()
     {
         return process_model_;
@@ -444,6 +534,196 @@ public:
         return point_set_transform_;
     }
 
+    /**
+     * Sets the thread pool used to evaluate the process and observation
+     * models on the points in parallel. Each point is evaluated independently
+     * and written to its own slot, hence the result does not depend on the
+     * number of threads. Models which are not thread safe are cloned once
+     * for each worker when they are first evaluated in parallel. If a model
+     * can neither be shared nor cloned, its points are evaluated serially.
+     *
+     * The clones are replaced automatically once the version of a model
+     * changes, i.e. after its parameters have been modified.
+     *
+     * \param thread_pool   Thread pool or a null pointer to evaluate all
+     *                      points in the calling thread (default)
+     */
+    void thread_pool(const std::shared_ptr<ThreadPool>& thread_pool)
+    {
+        thread_pool_ = thread_pool;
+
+        process_models_.reset();
+        obsrv_models_.reset();
+    }
+
+    /**
+     * \return Thread pool used to evaluate the models, null if the points are
+     *         evaluated serially
+     */
+    const std::shared_ptr<ThreadPool>& thread_pool() const
+    {
+        return thread_pool_;
+    }
+
+protected:
+    /** \cond INTERNAL */
+    /**
+     * Replaces the state points X_r by their predictions
+     */
+    void predict_points(double delta_time, const Input& input)
+    {
+        /*
+         * Predict each point X_r[i] and store the prediction back in X_r[i]
+         *
+         * X_r[i] = f(X_r[i], X_Q[i], u)
+         *
+         * The distinct points are passed to the model as column batches.
+         * Copies of the first point receive the prediction of the first point
+         */
+        gather_points(predict_points_, X_r.points(), states_);
+        gather_points(predict_points_, X_Q.points(), state_noises_);
+        state_predictions_.resize(states_.rows(), states_.cols());
+
+        evaluate_points(
+            process_model_,
+            process_models_,
+            predict_points_.size(),
+            [&](ProcessModel& process_model, size_t begin, size_t length)
+            {
+                process_model.predict_states(
+                    delta_time,
+                    states_.middleCols(begin, length),
+                    state_noises_.middleCols(begin, length),
+                    input,
+                    state_predictions_.middleCols(begin, length));
+            });
+
+        scatter_points(predict_points_,
+                       predict_duplicates_,
+                       state_predictions_,
+                       state_points_,
+                       X_r);
+    }
+
+    /**
+     * Computes the observation points X_y of the state points X_r
+     */
+    void predict_observations()
+    {
+        gather_points(update_points_, X_r.points(), obsrv_states_);
+        gather_points(update_points_, X_R.points(), obsrv_noises_);
+        obsrv_predictions_.resize(X_y.dimension(), obsrv_states_.cols());
+
+        evaluate_points(
+            obsrv_model_,
+            obsrv_models_,
+            update_points_.size(),
+            [&](ObservationModel& obsrv_model, size_t begin, size_t length)
+            {
+                obsrv_model.predict_observations(
+                    obsrv_states_.middleCols(begin, length),
+                    obsrv_noises_.middleCols(begin, length),
+                    0 /* delta time */,
+                    obsrv_predictions_.middleCols(begin, length));
+            });
+
+        scatter_points(update_points_,
+                       update_duplicates_,
+                       obsrv_predictions_,
+                       obsrv_points_,
+                       X_y);
+    }
+
+    /**
+     * Evaluates a model on a batch of points. Without a thread pool the
+     * entire batch is passed to the model in one call. Otherwise the batch is
+     * split into consecutive column ranges which are distributed dynamically
+     * among the workers.
+     *
+     * \param model         Model shared by the filter
+     * \param instances     Per-worker model instances
+     * \param count         Number of points in the batch
+     * \param evaluate      Callable evaluating the column range
+     *                      [begin, begin + length) given the model instance
+     *                      to use
+     */
+    template <typename Model, typename Evaluate>
+    void evaluate_points(const std::shared_ptr<Model>& model,
+                         WorkerInstances<Model>& instances,
+                         size_t count,
+                         Evaluate evaluate)
+    {
+        if (thread_pool_ && thread_pool_->size() > 1 && count > 1
+            && instances.assign(model, thread_pool_->size()))
+        {
+            // a few ranges per worker balance the load of uneven models
+            const size_t ranges = std::min(count, 4 * thread_pool_->size());
+
+            thread_pool_->parallel_for(
+                0, ranges,
+                [&](size_t range, size_t worker)
+                {
+                    const size_t begin = range * count / ranges;
+                    const size_t end = (range + 1) * count / ranges;
+
+                    evaluate(instances[worker], begin, end - begin);
+                });
+        }
+        else
+        {
+            evaluate(*model, 0, count);
+        }
+    }
+
+    /**
+     * Copies the points with the given indices into the columns of a batch
+     */
+    template <typename Points, typename Batch>
+    static void gather_points(const std::vector<size_t>& indices,
+                              const Points& points,
+                              Batch& batch)
+    {
+        batch.resize(points.rows(), indices.size());
+
+        for (size_t k = 0; k < indices.size(); ++k)
+        {
+            batch.col(k) = points.col(indices[k]);
+        }
+    }
+
+    /**
+     * Writes the k-th column of the batch to the point indices[k] and the
+     * first column to all duplicates of the first point.
+     *
+     * \param indices       Indices of the distinct points
+     * \param duplicates    Duplicate flags of all points
+     * \param batch         Evaluated distinct points
+     * \param buffer        Buffer holding all points
+     * \param point_set     Destination point set
+     */
+    template <typename Batch, typename Buffer, typename PointSet_>
+    static void scatter_points(const std::vector<size_t>& indices,
+                               const std::vector<bool>& duplicates,
+                               const Batch& batch,
+                               Buffer& buffer,
+                               PointSet_& point_set)
+    {
+        buffer.resize(batch.rows(), duplicates.size());
+
+        for (size_t k = 0; k < indices.size(); ++k)
+        {
+            buffer.col(indices[k]) = batch.col(k);
+        }
+
+        for (size_t i = 1; i < duplicates.size(); ++i)
+        {
+            if (duplicates[i]) buffer.col(i) = batch.col(0);
+        }
+
+        point_set.points(buffer);
+    }
+    /** \endcond */
+
 public:
     double threshold;
     double inv_sigma;
@@ -484,6 +764,75 @@ protected:
      * augmented Gaussian with the dimension #global_dimension_
      */
     ObsrvNoisePointSet X_R;
+
+    /**
+     * \brief Flags the points of the prediction which are copies of the first
+     * point
+     */
+    std::vector<bool> predict_duplicates_;
+
+    /**
+     * \brief Flags the points of the observation prediction which are copies
+     * of the first point
+     */
+    std::vector<bool> update_duplicates_;
+
+    /**
+     * \brief Indices of the distinct points of the prediction
+     */
+    std::vector<size_t> predict_points_;
+
+    /**
+     * \brief Indices of the distinct points of the observation prediction
+     */
+    std::vector<size_t> update_points_;
+
+    /**
+     * \brief Batch buffers of the distinct points passed to the models. Each
+     * buffer keeps its size across steps, i.e. is resized only once.
+     */
+    StateMatrix states_;
+    StateMatrix state_predictions_;
+    StateNoiseMatrix state_noises_;
+    StateMatrix obsrv_states_;
+    ObsrvNoiseMatrix obsrv_noises_;
+    ObsrvMatrix obsrv_predictions_;
+
+    /**
+     * \brief Buffers of all points written back to the point sets
+     */
+    StateMatrix state_points_;
+    ObsrvMatrix obsrv_points_;
+
+    /**
+     * \brief Centered prior state points of the last prediction
+     */
+    decltype(X_r.centered_points()) prior_points_;
+
+    /**
+     * \brief Cross-covariance of the prior and the predicted state
+     */
+    typename StateDistribution::SecondMoment cross_covariance_;
+
+    /**
+     * \brief Cross-covariance flag
+     */
+    bool cross_covariance_enabled_;
+
+    /**
+     * \brief Optional thread pool evaluating the points in parallel
+     */
+    std::shared_ptr<ThreadPool> thread_pool_;
+
+    /**
+     * \brief Process model instances of the thread pool workers
+     */
+    WorkerInstances<ProcessModel> process_models_;
+
+    /**
+     * \brief Observation model instances of the thread pool workers
+     */
+    WorkerInstances<ObservationModel> obsrv_models_;
     /** \endcond */
 
 public:
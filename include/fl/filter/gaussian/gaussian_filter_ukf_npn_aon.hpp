@@ -24,10 +24,13 @@
 
 #include <map>
 #include <tuple>
+#include <vector>
 #include <memory>
+#include <algorithm>
 
 #include <fl/util/meta.hpp>
 #include <fl/util/traits.hpp>
+#include <fl/util/thread_pool.hpp>
 
 #include <fl/exception/exception.hpp>
 #include <fl/filter/filter_interface.hpp>
@@ -111,6 +114,21 @@ struct Traits<
     typedef PointSet<Observation, NumberOfPoints> ObsrvPointSet;
     typedef PointSet<StateNoise, NumberOfPoints> StateNoisePointSet;
 
+    /**
+     * \brief Column-wise batches of points passed to the models. The number
+     * of columns is bounded by the number of points, hence fixed-size
+     * batches never allocate.
+     */
+    typedef typename PointMatrixOf<
+                State, NumberOfPoints
+            >::Type StateMatrix;
+    typedef typename PointMatrixOf<
+                Observation, NumberOfPoints
+            >::Type ObsrvMatrix;
+    typedef typename PointMatrixOf<
+                StateNoise, NumberOfPoints
+            >::Type StateNoiseMatrix;
+
     /**
      * \brief KalmanGain Matrix
      */
@@ -129,6 +147,10 @@ struct Traits<
  *
  * Gaussian for Non-Additive Process Noise & Additive Observation Noise
  *
+ * The update either factorizes the innovation covariance of the size of the
+ * observation or a matrix of the size of the number of points, whichever is
+ * cheaper for the given dimensions (see UpdateSpace).
+ *
  * \tparam ProcessModel
  * \tparam ObservationModel
  *
@@ -170,6 +192,9 @@ protected:
     typedef typename Traits<This>::StatePointSet StatePointSet;
     typedef typename Traits<This>::ObsrvPointSet ObsrvPointSet;
     typedef typename Traits<This>::StateNoisePointSet StateNoisePointSet;
+    typedef typename Traits<This>::StateMatrix StateMatrix;
+    typedef typename Traits<This>::ObsrvMatrix ObsrvMatrix;
+    typedef typename Traits<This>::StateNoiseMatrix StateNoiseMatrix;
     /** \endcond */
 
 public:
@@ -179,6 +204,21 @@ public:
     typedef typename Traits<This>::Observation Obsrv;    
     typedef typename Traits<This>::StateDistribution StateDistribution;    
 
+    /**
+     * \brief Algebraic form of the update
+     *
+     * Both forms yield the same posterior. They differ in the size of the
+     * matrix which is factorized.
+     */
+    enum class UpdateSpace
+    {
+        Automatic,   /**< \brief Selects the cheaper form in every update */
+        Observation, /**< \brief Factorizes the innovation covariance */
+        Point,       /**< \brief Factorizes a point count sized matrix */
+        Sequential   /**< \brief Processes one observation component at a
+                          time without factorization */
+    };
+
 public:
     /**
      * Creates a Gaussian filter
@@ -194,6 +234,8 @@ public:
         : process_model_(process_model),
           obsrv_model_(obsrv_model),
           point_set_transform_(point_set_transform),
+          update_space_(UpdateSpace::Automatic),
+          last_update_space_(UpdateSpace::Automatic),
           /*
            * Set the augmented Gaussian dimension.
            *
@@ -248,6 +290,40 @@ public:
          */
         X_r.resize(point_count);
         X_r.dimension(process_model_->state_dimension());
+
+        /*
+         * Determine the points which are exact copies of the first point,
+         * i.e. the mean. A point is a copy of the mean if it lies outside of
+         * the sigma point partitions of all random variables entering the
+         * model. The models are evaluated once for the first point and the
+         * result is broadcast to all copies.
+         *
+         * The prediction is a function of the state and state noise
+         * partitions. The observation prediction is a function of the state
+         * partition only since the observation noise is additive.
+         */
+        const size_t state_dim = process_model_->state_dimension();
+        const size_t state_noise_dim = process_model_->noise_dimension();
+
+        predict_duplicates_.assign(point_count, false);
+        update_duplicates_.assign(point_count, false);
+
+        for (size_t i = 1; i < point_count; ++i)
+        {
+            const bool state_mean = PointSetTransform::is_mean_point(
+                i, global_dimension_, 0, state_dim);
+            const bool state_noise_mean = PointSetTransform::is_mean_point(
+                i, global_dimension_, state_dim, state_noise_dim);
+
+            predict_duplicates_[i] = state_mean && state_noise_mean;
+            update_duplicates_[i] = state_mean;
+        }
+
+        for (size_t i = 0; i < point_count; ++i)
+        {
+            if (!predict_duplicates_[i]) predict_points_.push_back(i);
+            if (!update_duplicates_[i]) update_points_.push_back(i);
+        }
     }
 
     /**
@@ -281,15 +357,33 @@ public:
          * Predict each point X_r[i] and store the prediction back in X_r[i]
          *
          * X_r[i] = f(X_r[i], X_Q[i], u)
+         *
+         * The distinct points are passed to the model as column batches.
+         * Copies of the first point receive the prediction of the first point
          */
-        const size_t point_count = X_r.count_points();
-        for (size_t i = 0; i < point_count; ++i)
-        {
-            X_r.point(i, process_model_->predict_state(delta_time,
-                                                       X_r.point(i),
-                                                       X_Q.point(i),
-                                                       input));
-        }
+        gather_points(predict_points_, X_r.points(), states_);
+        gather_points(predict_points_, X_Q.points(), state_noises_);
+        state_predictions_.resize(states_.rows(), states_.cols());
+
+        evaluate_points(
+            process_model_,
+            process_models_,
+            predict_points_.size(),
+            [&](ProcessModel& process_model, size_t begin, size_t length)
+            {
+                process_model.predict_states(
+                    delta_time,
+                    states_.middleCols(begin, length),
+                    state_noises_.middleCols(begin, length),
+                    input,
+                    state_predictions_.middleCols(begin, length));
+            });
+
+        scatter_points(predict_points_,
+                       predict_duplicates_,
+                       state_predictions_,
+                       state_points_,
+                       X_r);
 
         /*
          * Obtain the centered points matrix of the prediction. The columns of
@@ -330,6 +424,9 @@ public:
 
     /**
      * \copydoc FilterInterface::update
+     *
+     * The algebraic form is determined by update_space(). The form taken is
+     * reported by last_update_space().
      */
     virtual void update(const Obsrv& y,
                         const StateDistribution& predicted_dist,
@@ -340,14 +437,29 @@ public:
                                       0,
                                       X_r);
 
-        const size_t point_count = X_r.count_points();
-        for (size_t i = 0; i < point_count; ++i)
-        {
-            X_y.point(i, obsrv_model_->predict_observation(X_r.point(i),
-                                                           0 /* delta time */));
-        }
+        gather_points(update_points_, X_r.points(), obsrv_states_);
+        obsrv_predictions_.resize(X_y.dimension(), obsrv_states_.cols());
+
+        evaluate_points(
+            obsrv_model_,
+            obsrv_models_,
+            update_points_.size(),
+            [&](ObservationModel& obsrv_model, size_t begin, size_t length)
+            {
+                obsrv_model.predict_observations(
+                    obsrv_states_.middleCols(begin, length),
+                    0 /* delta time */,
+                    obsrv_predictions_.middleCols(begin, length));
+            });
+
+        scatter_points(update_points_,
+                       update_duplicates_,
+                       obsrv_predictions_,
+                       obsrv_points_,
+                       X_y);
 
-        fl::invert_diagonal_Vector(X_r.covariance_weights_vector(), inv_W);
+        W = X_r.covariance_weights_vector();
+        fl::invert_diagonal_Vector(W, inv_W);
         fl::invert_diagonal_Vector(obsrv_model_->noise_covariance_vector(), inv_R);
 
         X = X_r.centered_points();
@@ -364,14 +476,17 @@ public:
             }
         }
 
-        C  = (Y.transpose() * inv_R.asDiagonal() * Y).eval();
-        C += inv_W.asDiagonal();
-        C  = C.inverse();
+        last_update_space_ = select_update_space(Y.rows(), Y.cols(), X.rows());
 
-        correction = X * C * Y.transpose() * inv_R.asDiagonal() * innovation;
+        switch (last_update_space_)
+        {
+        case UpdateSpace::Observation: update_in_observation_space(); break;
+        case UpdateSpace::Sequential: update_sequentially(); break;
+        default: update_in_point_space(); break;
+        }
 
         posterior_dist.mean(predicted_dist.mean() +  correction);
-        posterior_dist.covariance(X * C * X.transpose());
+        posterior_dist.covariance(posterior_covariance);
     }
 
     /**
@@ -387,6 +502,75 @@ public:
         update(observation, posterior_dist, posterior_dist);
     }
 
+    /**
+     * Sets the algebraic form of the update. By default the form is selected
+     * automatically in every update based on the observation dimension and
+     * the number of points.
+     *
+     * \param update_space     UpdateSpace::Automatic, UpdateSpace::Observation,
+     *                         UpdateSpace::Point or UpdateSpace::Sequential.
+     *                         The sequential update requires
+     *                         \f$O(mp^2)\f$ operations for an \f$m\f$
+     *                         dimensional observation and \f$p\f$ points.
+     *                         The points only cover the state and the process
+     *                         noise, i.e. \f$p\f$ does not depend on
+     *                         \f$m\f$. It is never selected automatically.
+     */
+    void update_space(UpdateSpace update_space)
+    {
+        update_space_ = update_space;
+    }
+
+    /**
+     * \return Configured algebraic form of the update
+     */
+    UpdateSpace update_space() const
+    {
+        return update_space_;
+    }
+
+    /**
+     * \return Algebraic form used by the last update, UpdateSpace::Observation,
+     *         UpdateSpace::Point or UpdateSpace::Sequential.
+     *         UpdateSpace::Automatic if no update has been performed yet.
+     */
+    UpdateSpace last_update_space() const
+    {
+        return last_update_space_;
+    }
+
+    /**
+     * \return The cheaper update form for the given dimensions
+     *
+     * The observation space form factorizes the \f$m\times m\f$ innovation
+     * covariance, the point space form the \f$p\times p\f$ matrix
+     * \f$Y^T R^{-1} Y + W^{-1}\f$ where \f$m\f$ is the observation dimension
+     * and \f$p\f$ the number of points. The estimated floating point
+     * operations of both forms including the products with the \f$n\f$
+     * dimensional state points are compared.
+     *
+     * \param obsrv_dimension  Observation dimension \f$m\f$
+     * \param point_count      Number of points \f$p\f$
+     * \param state_dimension  State dimension \f$n\f$
+     */
+    static UpdateSpace cheaper_update_space(double obsrv_dimension,
+                                            double point_count,
+                                            double state_dimension)
+    {
+        const double m = obsrv_dimension;
+        const double p = point_count;
+        const double n = state_dimension;
+
+        const double observation_space_cost =
+            m * m * p + m * m * m / 3. + n * m * (p + m);
+        const double point_space_cost =
+            m * p * p + p * p * p / 3. + n * p * (p + n);
+
+        return observation_space_cost < point_space_cost
+                   ? UpdateSpace::Observation
+                   : UpdateSpace::Point;
+    }
+
     const std::shared_ptr<ProcessModel>& process_model()
     {
         return process_model_;
@@ -402,6 +586,227 @@ public:
         return point_set_transform_;
     }
 
+    /**
+     * Sets the thread pool used to evaluate the process and observation
+     * models on the points in parallel. Each point is evaluated independently
+     * and written to its own slot, hence the result does not depend on the
+     * number of threads. Models which are not thread safe are cloned once
+     * for each worker when they are first evaluated in parallel. If a model
+     * can neither be shared nor cloned, its points are evaluated serially.
+     *
+     * The clones are replaced automatically once the version of a model
+     * changes, i.e. after its parameters have been modified.
+     *
+     * \param thread_pool   Thread pool or a null pointer to evaluate all
+     *                      points in the calling thread (default)
+     */
+    void thread_pool(const std::shared_ptr<ThreadPool>& thread_pool)
+    {
+        thread_pool_ = thread_pool;
+
+        process_models_.reset();
+        obsrv_models_.reset();
+    }
+
+    /**
+     * \return Thread pool used to evaluate the models, null if the points are
+     *         evaluated serially
+     */
+    const std::shared_ptr<ThreadPool>& thread_pool() const
+    {
+        return thread_pool_;
+    }
+
+protected:
+    /** \cond INTERNAL */
+    /**
+     * Evaluates a model on a batch of points. Without a thread pool the
+     * entire batch is passed to the model in one call. Otherwise the batch is
+     * split into consecutive column ranges which are distributed dynamically
+     * among the workers.
+     *
+     * \param model         Model shared by the filter
+     * \param instances     Per-worker model instances
+     * \param count         Number of points in the batch
+     * \param evaluate      Callable evaluating the column range
+     *                      [begin, begin + length) given the model instance
+     *                      to use
+     */
+    template <typename Model, typename Evaluate>
+    void evaluate_points(const std::shared_ptr<Model>& model,
+                         WorkerInstances<Model>& instances,
+                         size_t count,
+                         Evaluate evaluate)
+    {
+        if (thread_pool_ && thread_pool_->size() > 1 && count > 1
+            && instances.assign(model, thread_pool_->size()))
+        {
+            // a few ranges per worker balance the load of uneven models
+            const size_t ranges = std::min(count, 4 * thread_pool_->size());
+
+            thread_pool_->parallel_for(
+                0, ranges,
+                [&](size_t range, size_t worker)
+                {
+                    const size_t begin = range * count / ranges;
+                    const size_t end = (range + 1) * count / ranges;
+
+                    evaluate(instances[worker], begin, end - begin);
+                });
+        }
+        else
+        {
+            evaluate(*model, 0, count);
+        }
+    }
+
+    /**
+     * \return The form used for the next update
+     */
+    UpdateSpace select_update_space(int obsrv_dimension,
+                                    int point_count,
+                                    int state_dimension) const
+    {
+        if (update_space_ != UpdateSpace::Automatic) return update_space_;
+
+        return cheaper_update_space(
+                   obsrv_dimension, point_count, state_dimension);
+    }
+
+    /**
+     * Computes the correction and the posterior covariance using the
+     * factorization of the innovation covariance
+     *
+     * \f$ S = Y W Y^T + R \f$
+     *
+     * \f$ \Sigma_{xy} = X W Y^T \f$
+     *
+     * \f$ \Sigma^+ = X W X^T - \Sigma_{xy} S^{-1} \Sigma_{xy}^T \f$
+     */
+    void update_in_observation_space()
+    {
+        innovation_covariance.noalias() = Y * W.asDiagonal() * Y.transpose();
+        innovation_covariance.diagonal() += inv_R.cwiseInverse();
+        cross_covariance.noalias() = X * W.asDiagonal() * Y.transpose();
+
+        innovation_ldlt.compute(innovation_covariance);
+
+        correction.noalias() =
+            cross_covariance * innovation_ldlt.solve(innovation);
+
+        posterior_covariance.noalias() = X * W.asDiagonal() * X.transpose();
+        posterior_covariance.noalias() -=
+            cross_covariance
+            * innovation_ldlt.solve(cross_covariance.transpose());
+    }
+
+    /**
+     * Computes the correction and the posterior covariance using the
+     * factorization of the point space matrix
+     *
+     * \f$ C^{-1} = Y^T R^{-1} Y + W^{-1} \f$
+     *
+     * \f$ \Sigma^+ = X C X^T \f$
+     */
+    void update_in_point_space()
+    {
+        C.noalias() = Y.transpose() * inv_R.asDiagonal() * Y;
+        C.diagonal() += inv_W;
+
+        point_ldlt.compute(C);
+
+        correction.noalias() =
+            X * point_ldlt.solve(
+                    Y.transpose() * inv_R.asDiagonal() * innovation);
+
+        posterior_covariance.noalias() =
+            X * point_ldlt.solve(X.transpose());
+    }
+
+    /**
+     * Computes the correction and the posterior covariance by conditioning
+     * on the observation components one after another in the space of the
+     * point weights. Starting from \f$a = 0\f$ and \f$C = W\f$, each
+     * component with the row \f$Y_i\f$ and noise variance \f$r_i\f$ updates
+     *
+     * \f$ g = C Y_i^T,\quad s = Y_i g + r_i \f$
+     *
+     * \f$ a \leftarrow a + g (y_i - \mu_{y,i} - Y_i a) / s \f$
+     *
+     * \f$ C \leftarrow C - g g^T / s \f$
+     *
+     * The result equals the point space form with
+     * \f$C = (Y^T R^{-1} Y + W^{-1})^{-1}\f$.
+     */
+    void update_sequentially()
+    {
+        point_mean.setZero(W.rows());
+        C = W.asDiagonal();
+
+        for (int i = 0; i < Y.rows(); ++i)
+        {
+            point_gain.noalias() = C * Y.row(i).transpose();
+
+            const double s = Y.row(i).dot(point_gain) + 1. / inv_R(i, 0);
+            const double e = innovation(i, 0) - Y.row(i).dot(point_mean);
+
+            point_mean += point_gain * (e / s);
+            C.noalias() -= point_gain * (point_gain.transpose() / s);
+        }
+
+        correction.noalias() = X * point_mean;
+        posterior_covariance.noalias() = X * C * X.transpose();
+    }
+
+    /**
+     * Copies the points with the given indices into the columns of a batch
+     */
+    template <typename Points, typename Batch>
+    static void gather_points(const std::vector<size_t>& indices,
+                              const Points& points,
+                              Batch& batch)
+    {
+        batch.resize(points.rows(), indices.size());
+
+        for (size_t k = 0; k < indices.size(); ++k)
+        {
+            batch.col(k) = points.col(indices[k]);
+        }
+    }
+
+    /**
+     * Writes the k-th column of the batch to the point indices[k] and the
+     * first column to all duplicates of the first point.
+     *
+     * \param indices       Indices of the distinct points
+     * \param duplicates    Duplicate flags of all points
+     * \param batch         Evaluated distinct points
+     * \param buffer        Buffer holding all points
+     * \param point_set     Destination point set
+     */
+    template <typename Batch, typename Buffer, typename PointSet_>
+    static void scatter_points(const std::vector<size_t>& indices,
+                               const std::vector<bool>& duplicates,
+                               const Batch& batch,
+                               Buffer& buffer,
+                               PointSet_& point_set)
+    {
+        buffer.resize(batch.rows(), duplicates.size());
+
+        for (size_t k = 0; k < indices.size(); ++k)
+        {
+            buffer.col(indices[k]) = batch.col(k);
+        }
+
+        for (size_t i = 1; i < duplicates.size(); ++i)
+        {
+            if (duplicates[i]) buffer.col(i) = batch.col(0);
+        }
+
+        point_set.points(buffer);
+    }
+    /** \endcond */
+
 public:
     double threshold;
     double inv_sigma;
@@ -412,6 +817,12 @@ protected:
     std::shared_ptr<PointSetTransform> point_set_transform_;
 
     /** \cond INTERNAL */
+    /**
+     * \brief Configured and last used algebraic form of the update
+     */
+    UpdateSpace update_space_;
+    UpdateSpace last_update_space_;
+
     /**
      * \brief The global dimension is dimension of the augmented Gaussian which
      * consists of state Gaussian, state noise Gaussian and the
@@ -435,6 +846,59 @@ protected:
      * Gaussian with the dimension #global_dimension_
      */
     StateNoisePointSet X_Q;
+
+    /**
+     * \brief Flags the points of the prediction which are copies of the first
+     * point
+     */
+    std::vector<bool> predict_duplicates_;
+
+    /**
+     * \brief Flags the points of the observation prediction which are copies
+     * of the first point
+     */
+    std::vector<bool> update_duplicates_;
+
+    /**
+     * \brief Indices of the distinct points of the prediction
+     */
+    std::vector<size_t> predict_points_;
+
+    /**
+     * \brief Indices of the distinct points of the observation prediction
+     */
+    std::vector<size_t> update_points_;
+
+    /**
+     * \brief Batch buffers of the distinct points passed to the models. Each
+     * buffer keeps its size across steps, i.e. is resized only once.
+     */
+    StateMatrix states_;
+    StateMatrix state_predictions_;
+    StateNoiseMatrix state_noises_;
+    StateMatrix obsrv_states_;
+    ObsrvMatrix obsrv_predictions_;
+
+    /**
+     * \brief Buffers of all points written back to the point sets
+     */
+    StateMatrix state_points_;
+    ObsrvMatrix obsrv_points_;
+
+    /**
+     * \brief Optional thread pool evaluating the points in parallel
+     */
+    std::shared_ptr<ThreadPool> thread_pool_;
+
+    /**
+     * \brief Process model instances of the thread pool workers
+     */
+    WorkerInstances<ProcessModel> process_models_;
+
+    /**
+     * \brief Observation model instances of the thread pool workers
+     */
+    WorkerInstances<ObservationModel> obsrv_models_;
     /** \endcond */
 
 public:
@@ -452,6 +916,17 @@ public:
     typename std::remove_const<
         decltype((Y.transpose() * inv_R.asDiagonal() * Y).eval())
     >::type C;
+    Eigen::LDLT<decltype(C)> point_ldlt;
+    decltype(W) point_mean;
+    decltype(W) point_gain;
+
+    typename std::remove_const<
+        decltype((Y * W.asDiagonal() * Y.transpose()).eval())
+    >::type innovation_covariance;
+    Eigen::LDLT<decltype(innovation_covariance)> innovation_ldlt;
+    KalmanGain cross_covariance;
+
+    typename StateDistribution::SecondMoment posterior_covariance;
     /** \endcond */
 };
 
@@ -0,0 +1,392 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file gaussian_filter_ukf_sr.hpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#ifndef FL__FILTER__GAUSSIAN__GAUSSIAN_FILTER_UKF_SR_HPP
+#define FL__FILTER__GAUSSIAN__GAUSSIAN_FILTER_UKF_SR_HPP
+
+#include <cmath>
+#include <memory>
+
+#include <Eigen/Dense>
+
+#include <fl/util/traits.hpp>
+#include <fl/util/math/linear_algebra.hpp>
+#include <fl/exception/exception.hpp>
+#include <fl/filter/gaussian/gaussian_filter_ukf.hpp>
+
+namespace fl
+{
+
+template <typename...> class GaussianFilter;
+
+/**
+ * \brief Tag selecting the square root form of the sigma point Kalman filter
+ */
+enum class SquareRootCovariance : bool { };
+
+/**
+ * GaussianFilter Traits
+ */
+template <typename ProcessModel,
+          typename ObservationModel,
+          typename PointSetTransform>
+struct Traits<
+           GaussianFilter<
+               ProcessModel,
+               ObservationModel,
+               PointSetTransform,
+               SquareRootCovariance>>
+    : Traits<GaussianFilter<ProcessModel, ObservationModel, PointSetTransform>>
+{
+    typedef GaussianFilter<
+                ProcessModel,
+                ObservationModel,
+                PointSetTransform,
+                SquareRootCovariance
+            > Filter;
+
+    typedef std::shared_ptr<Filter> Ptr;
+};
+
+/**
+ * Square root sigma point Kalman filter \cite van2001square .
+ *
+ * The filter keeps the state distribution in the factor form
+ * \f$\Sigma = S S^T\f$ with a lower triangular \f$S\f$. The point set
+ * transform uses the factor directly instead of refactorizing the covariance
+ * in every step. The factors of the predicted state and observation
+ * distributions are obtained by a QR decomposition of the weighted centered
+ * points and a rank-1 update with the first point. The posterior factor is
+ * obtained by rank-1 downdates of the predicted factor. The resulting
+ * covariances are positive semi-definite by construction.
+ *
+ * The models and the evaluation of the points are the same as in the regular
+ * sigma point filter GaussianFilter<ProcessModel, ObservationModel,
+ * PointSetTransform>.
+ *
+ * \ingroup filters
+ * \ingroup sigma_point_kalman_filters
+ */
+template<
+    typename ProcessModel,
+    typename ObservationModel,
+    typename PointSetTransform>
+class GaussianFilter<
+          ProcessModel,
+          ObservationModel,
+          PointSetTransform,
+          SquareRootCovariance>
+    : public GaussianFilter<ProcessModel, ObservationModel, PointSetTransform>
+{
+protected:
+    /** \cond INTERNAL */
+    typedef GaussianFilter<
+                ProcessModel,
+                ObservationModel,
+                PointSetTransform
+            > Base;
+    /** \endcond */
+
+public:
+    /* public concept interface types */
+    typedef typename Base::State State;
+    typedef typename Base::Input Input;
+    typedef typename Base::Obsrv Obsrv;
+    typedef typename Base::StateDistribution StateDistribution;
+
+protected:
+    /** \cond INTERNAL */
+    typedef typename StateDistribution::SecondMoment StateSquareRoot;
+    typedef typename State::Scalar Scalar;
+
+    typedef Eigen::Matrix<
+                Scalar,
+                Obsrv::RowsAtCompileTime,
+                Obsrv::RowsAtCompileTime
+            > ObsrvSquareRoot;
+
+    typedef Eigen::Matrix<
+                Scalar,
+                State::RowsAtCompileTime,
+                Obsrv::RowsAtCompileTime
+            > CrossCovariance;
+
+    /*
+     * Stacked weighted points reduced by the QR decomposition. The number of
+     * rows is bounded by the number of points.
+     */
+    typedef Eigen::Matrix<
+                Scalar,
+                Eigen::Dynamic,
+                State::RowsAtCompileTime,
+                Eigen::ColMajor,
+                Traits<Base>::NumberOfPoints,
+                State::RowsAtCompileTime
+            > StackedStatePoints;
+
+    typedef Eigen::Matrix<
+                Scalar,
+                Eigen::Dynamic,
+                Obsrv::RowsAtCompileTime,
+                Eigen::ColMajor,
+                Traits<Base>::NumberOfPoints,
+                Obsrv::RowsAtCompileTime
+            > StackedObsrvPoints;
+
+    using Base::X;
+    using Base::Y;
+    using Base::W;
+    using Base::X_r;
+    using Base::X_y;
+    using Base::prediction;
+    using Base::innovation;
+    /** \endcond */
+
+public:
+    /**
+     * \copydoc GaussianFilter<ProcessModel, ObservationModel, PointSetTransform>::GaussianFilter
+     */
+    GaussianFilter(const std::shared_ptr<ProcessModel>& process_model,
+                   const std::shared_ptr<ObservationModel>& obsrv_model,
+                   const std::shared_ptr<PointSetTransform>& point_set_transform)
+        : Base(process_model, obsrv_model, point_set_transform)
+    { }
+
+    /**
+     * \copydoc FilterInterface::predict
+     *
+     * \throws Exception if the predicted covariance is not positive definite
+     */
+    virtual void predict(double delta_time,
+                         const Input& input,
+                         const StateDistribution& prior_dist,
+                         StateDistribution& predicted_dist)
+    {
+        this->point_set_transform_->forward(prior_dist,
+                                            this->global_dimension_,
+                                            0,
+                                            X_r);
+
+        if (this->cross_covariance_enabled_)
+        {
+            this->prior_points_ = X_r.centered_points();
+        }
+
+        this->predict_points(delta_time, input);
+
+        X = X_r.centered_points();
+        W = X_r.covariance_weights_vector();
+
+        weighted_square_root(X, W, stacked_state_points_, state_qr_, S_x);
+
+        predicted_dist.mean(X_r.mean());
+        predicted_dist.square_root(S_x);
+
+        if (this->cross_covariance_enabled_)
+        {
+            this->cross_covariance_.noalias() =
+                this->prior_points_ * W.asDiagonal() * X.transpose();
+        }
+    }
+
+    /**
+     * \copydoc FilterInterface::update
+     *
+     * \throws Exception if the posterior covariance is not positive definite
+     */
+    virtual void update(const Obsrv& y,
+                        const StateDistribution& predicted_dist,
+                        StateDistribution& posterior_dist)
+    {
+        this->point_set_transform_->forward(predicted_dist,
+                                            this->global_dimension_,
+                                            0,
+                                            X_r);
+
+        this->predict_observations();
+
+        W = X_r.covariance_weights_vector();
+        X = X_r.centered_points();
+        Y = X_y.centered_points();
+
+        prediction = X_y.mean();
+        innovation = (y - prediction);
+
+        weighted_square_root(X, W, stacked_state_points_, state_qr_, S_x);
+        weighted_square_root(Y, W, stacked_obsrv_points_, obsrv_qr_, S_y);
+
+        for (int i = 0; i < y.rows(); ++i)
+        {
+            if (std::abs(innovation(i, 0)) > this->threshold)
+            {
+                update_factor(
+                    S_y,
+                    Obsrv::Unit(y.rows(), i),
+                    this->inv_sigma);
+            }
+        }
+
+        /*
+         * K = P_xy (S_y S_y^T)^-1 is obtained by two triangular solves
+         */
+        P_xy.noalias() = X * W.asDiagonal() * Y.transpose();
+
+        K_t = S_y.template triangularView<Eigen::Lower>().solve(
+                  P_xy.transpose());
+        S_y.template triangularView<Eigen::Lower>().transpose()
+            .solveInPlace(K_t);
+        K = K_t.transpose();
+
+        /*
+         * S_x S_x^T - K P_yy K^T = S_x S_x^T - (K S_y) (K S_y)^T
+         */
+        U.noalias() = K * S_y.template triangularView<Eigen::Lower>();
+
+        for (int i = 0; i < U.cols(); ++i)
+        {
+            update_factor(S_x, U.col(i), -1.);
+        }
+
+        posterior_dist.mean(X_r.mean() + K * innovation);
+        posterior_dist.square_root(S_x);
+    }
+
+    /**
+     * \copydoc FilterInterface::predict_and_update
+     */
+    virtual void predict_and_update(double delta_time,
+                                    const Input& input,
+                                    const Obsrv& observation,
+                                    const StateDistribution& prior_dist,
+                                    StateDistribution& posterior_dist)
+    {
+        predict(delta_time, input, prior_dist, posterior_dist);
+        update(observation, posterior_dist, posterior_dist);
+    }
+
+protected:
+    /** \cond INTERNAL */
+    /**
+     * Computes the lower triangular factor S of
+     * \f$ \sum_i w_i x_i x_i^T = S S^T \f$
+     *
+     * All points with non-negative weights except the first are stacked
+     * into one matrix which is reduced to a triangular factor by a QR
+     * decomposition. The first point and points with negative weights enter
+     * by rank-1 updates.
+     *
+     * \param [in]  points          Centered points, one per column
+     * \param [in]  weights         Covariance weights
+     * \param [out] stacked_points  Buffer of the stacked points
+     * \param [out] qr              QR decomposition of the stacked points
+     * \param [out] factor          Lower triangular factor
+     *
+     * \throws Exception if the result is not positive definite
+     */
+    template <
+        typename Points, typename Weights,
+        typename Stack, typename QR, typename Factor>
+    void weighted_square_root(const Points& points,
+                              const Weights& weights,
+                              Stack& stacked_points,
+                              QR& qr,
+                              Factor& factor)
+    {
+        const int dim = points.rows();
+        const int point_count = points.cols();
+
+        int stacked = 0;
+        for (int i = 1; i < point_count; ++i)
+        {
+            if (weights(i) >= 0.) ++stacked;
+        }
+
+        stacked_points.resize(stacked, dim);
+        for (int i = 1, k = 0; i < point_count; ++i)
+        {
+            if (weights(i) < 0.) continue;
+
+            stacked_points.row(k++) = std::sqrt(weights(i)) * points.col(i).transpose();
+        }
+
+        qr.compute(stacked_points);
+
+        factor.setZero(dim, dim);
+        const int rank = std::min(stacked, dim);
+        factor.topRows(rank) = qr.matrixQR().topRows(rank)
+                                  .template triangularView<Eigen::Upper>();
+        factor.transposeInPlace();
+
+        // QR determines the factor up to the signs of its columns
+        for (int i = 0; i < dim; ++i)
+        {
+            if (factor(i, i) < 0.) factor.col(i) = -factor.col(i);
+        }
+
+        update_factor(factor, points.col(0), weights(0));
+
+        for (int i = 1; i < point_count; ++i)
+        {
+            if (weights(i) < 0.)
+            {
+                update_factor(factor, points.col(i), weights(i));
+            }
+        }
+    }
+
+    /**
+     * Rank-1 update of a factor
+     *
+     * \throws Exception if a downdate fails
+     */
+    template <typename Factor, typename Vector>
+    void update_factor(Factor& factor,
+                       const Eigen::MatrixBase<Vector>& x,
+                       double w)
+    {
+        if (!cholesky_update(factor, x, w))
+        {
+            fl_throw(Exception("Square root UKF: downdated covariance is not "
+                               "positive definite"));
+        }
+    }
+    /** \endcond */
+
+protected:
+    /** \cond INTERNAL */
+    StateSquareRoot S_x;
+    ObsrvSquareRoot S_y;
+    CrossCovariance P_xy;
+    CrossCovariance K;
+    CrossCovariance U;
+    Eigen::Matrix<
+        Scalar, Obsrv::RowsAtCompileTime, State::RowsAtCompileTime
+    > K_t;
+    StackedStatePoints stacked_state_points_;
+    StackedObsrvPoints stacked_obsrv_points_;
+    Eigen::HouseholderQR<StackedStatePoints> state_qr_;
+    Eigen::HouseholderQR<StackedObsrvPoints> obsrv_qr_;
+    /** \endcond */
+};
+
+}
+
+#endif
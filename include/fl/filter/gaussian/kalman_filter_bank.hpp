@@ -0,0 +1,454 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file kalman_filter_bank.hpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#ifndef FL__FILTER__GAUSSIAN__KALMAN_FILTER_BANK_HPP
+#define FL__FILTER__GAUSSIAN__KALMAN_FILTER_BANK_HPP
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+#include <Eigen/Dense>
+
+#include <fl/util/traits.hpp>
+#include <fl/util/thread_pool.hpp>
+#include <fl/exception/exception.hpp>
+#include <fl/distribution/gaussian.hpp>
+
+#include <fl/model/process/linear_process_model.hpp>
+#include <fl/model/observation/linear_observation_model.hpp>
+
+namespace fl
+{
+
+template <typename ProcessModel, typename ObservationModel>
+class KalmanFilterBank;
+
+/**
+ * Traits of the KalmanFilterBank
+ */
+template <typename State_, typename Input_, typename Observation_>
+struct Traits<
+           KalmanFilterBank<
+               LinearGaussianProcessModel<State_, Input_>,
+               LinearGaussianObservationModel<Observation_, State_>>>
+{
+    typedef LinearGaussianProcessModel<State_, Input_> ProcessModel;
+    typedef LinearGaussianObservationModel<
+                Observation_, State_
+            > ObservationModel;
+
+    typedef State_ State;
+    typedef Input_ Input;
+    typedef Observation_ Observation;
+    typedef typename State::Scalar Scalar;
+
+    /**
+     * \brief Distribution of a single track
+     */
+    typedef Gaussian<State> StateDistribution;
+
+    /**
+     * \brief Means of all tracks, one per column
+     */
+    typedef Eigen::Matrix<
+                Scalar, State::RowsAtCompileTime, Eigen::Dynamic
+            > StateMatrix;
+
+    /**
+     * \brief Observations of all tracks, one per column
+     */
+    typedef Eigen::Matrix<
+                Scalar, Observation::RowsAtCompileTime, Eigen::Dynamic
+            > ObsrvMatrix;
+
+    /**
+     * \brief Covariances of all tracks, stored side by side. The covariance
+     * of the k-th track occupies the columns [k n, (k + 1) n).
+     */
+    typedef StateMatrix CovarianceMatrix;
+};
+
+/**
+ * \ingroup filters
+ *
+ * \brief Bank of Kalman filters tracking many independent targets which share
+ * the same linear Gaussian process and observation models.
+ *
+ * The means and covariances of all tracks are stored in two contiguous
+ * matrices (struct of arrays) instead of one Gaussian per track. All
+ * quantities that are linear in the tracks, e.g. the predicted means, the
+ * innovations and the products of the dynamics and sensor matrices with the
+ * stacked covariances, are computed by single matrix products over all
+ * tracks. The remaining per track kernels, i.e. the covariance prediction and
+ * the gain, are distributed over an optional thread pool.
+ *
+ * The filter follows the steps of the regular Kalman filter
+ * GaussianFilter<LinearGaussianProcessModel, LinearGaussianObservationModel>
+ * and yields the same estimates.
+ */
+template <typename State, typename Input, typename Obsrv>
+class KalmanFilterBank<
+          LinearGaussianProcessModel<State, Input>,
+          LinearGaussianObservationModel<Obsrv, State>>
+{
+protected:
+    /** \cond INTERNAL */
+    typedef KalmanFilterBank<
+                LinearGaussianProcessModel<State, Input>,
+                LinearGaussianObservationModel<Obsrv, State>
+            > This;
+
+    typedef typename Traits<This>::Scalar Scalar;
+    /** \endcond */
+
+public:
+    typedef typename Traits<This>::ProcessModel ProcessModel;
+    typedef typename Traits<This>::ObservationModel ObservationModel;
+    typedef typename Traits<This>::StateDistribution StateDistribution;
+    typedef typename Traits<This>::StateMatrix StateMatrix;
+    typedef typename Traits<This>::ObsrvMatrix ObsrvMatrix;
+    typedef typename Traits<This>::CovarianceMatrix CovarianceMatrix;
+
+public:
+    /**
+     * Creates a filter bank
+     *
+     * \param process_model     Process model shared by all tracks
+     * \param obsrv_model       Observation model shared by all tracks
+     * \param count             Initial number of tracks. The tracks are
+     *                          initialized with a standard Gaussian.
+     */
+    KalmanFilterBank(const std::shared_ptr<ProcessModel>& process_model,
+                     const std::shared_ptr<ObservationModel>& obsrv_model,
+                     size_t count = 0)
+        : process_model_(process_model),
+          obsrv_model_(obsrv_model)
+    {
+        resize(count);
+    }
+
+    /**
+     * Changes the number of tracks. Existing tracks are kept, new tracks are
+     * initialized with a standard Gaussian.
+     */
+    void resize(size_t count)
+    {
+        const int dim = process_model_->state_dimension();
+        const size_t old_count = this->count();
+
+        means_.conservativeResize(dim, count);
+        covariances_.conservativeResize(dim, dim * count);
+
+        for (size_t k = old_count; k < count; ++k)
+        {
+            means_.col(k).setZero();
+            covariance(k).setIdentity();
+        }
+    }
+
+    /**
+     * \return Number of tracks
+     */
+    size_t count() const
+    {
+        return means_.cols();
+    }
+
+    /**
+     * Sets the distribution of the k-th track
+     */
+    void distribution(size_t k, const StateDistribution& distribution)
+    {
+        means_.col(k) = distribution.mean();
+        covariance(k) = distribution.covariance();
+    }
+
+    /**
+     * \return Distribution of the k-th track
+     */
+    StateDistribution distribution(size_t k) const
+    {
+        StateDistribution distribution(dimension());
+        distribution.mean(means_.col(k));
+        distribution.covariance(covariance(k));
+        return distribution;
+    }
+
+    /**
+     * \return Mean of the k-th track
+     */
+    typename StateMatrix::ColXpr mean(size_t k)
+    {
+        return means_.col(k);
+    }
+
+    /**
+     * \return Mean of the k-th track
+     */
+    typename StateMatrix::ConstColXpr mean(size_t k) const
+    {
+        return means_.col(k);
+    }
+
+    /**
+     * \return Covariance of the k-th track
+     */
+    Eigen::Block<CovarianceMatrix> covariance(size_t k)
+    {
+        return covariances_.block(0, k * dimension(), dimension(), dimension());
+    }
+
+    /**
+     * \return Covariance of the k-th track
+     */
+    Eigen::Block<const CovarianceMatrix> covariance(size_t k) const
+    {
+        return covariances_.block(0, k * dimension(), dimension(), dimension());
+    }
+
+    /**
+     * \return Means of all tracks, one per column
+     */
+    const StateMatrix& means() const
+    {
+        return means_;
+    }
+
+    /**
+     * \return Covariances of all tracks, side by side
+     */
+    const CovarianceMatrix& covariances() const
+    {
+        return covariances_;
+    }
+
+    /**
+     * Predicts all tracks
+     *
+     * \f$ \bar{x}_k = A \hat{x}_k \f$,
+     * \f$ \bar{\Sigma}_k = A \hat{\Sigma}_k A^T + Q \f$
+     *
+     * The control input is unused by the linear model.
+     *
+     * \param delta_time    Time step
+     */
+    void predict(double delta_time, const Input&)
+    {
+        auto&& A = process_model_->discretized_A(delta_time);
+        auto&& Q = process_model_->discretized_covariance(delta_time);
+
+        means_buffer_.noalias() = A * means_;
+        means_.swap(means_buffer_);
+
+        // A [Sigma_1 ... Sigma_N] in one product
+        covariances_buffer_.noalias() = A * covariances_;
+
+        const int dim = dimension();
+
+        for_each_track(
+            [&](size_t k)
+            {
+                covariance(k).noalias() =
+                    covariances_buffer_.middleCols(k * dim, dim)
+                    * A.transpose();
+                covariance(k) += Q;
+            });
+    }
+
+    /**
+     * Updates all tracks with the observations of the respective columns
+     *
+     * \param y     Observations, one column per track
+     *
+     * \throws WrongSizeException if the number of observations does not
+     *         match the number of tracks
+     */
+    void update(const ObsrvMatrix& y)
+    {
+        if (size_t(y.cols()) != count())
+        {
+            fl_throw(WrongSizeException(
+                "Number of observations does not match the number of tracks"));
+        }
+
+        innovate(y);
+
+        for_each_track([&](size_t k) { update_track(k); });
+    }
+
+    /**
+     * Updates the tracks flagged as observed. The remaining tracks and their
+     * columns of \c y are left untouched.
+     *
+     * \f$ S_k = H \bar{\Sigma}_k H^T + R \f$,
+     * \f$ K_k = \bar{\Sigma}_k H^T S_k^{-1} \f$
+     *
+     * \f$ \hat{x}_k = \bar{x}_k + K_k (y_k - H \bar{x}_k) \f$,
+     * \f$ \hat{\Sigma}_k = \bar{\Sigma}_k - K_k H \bar{\Sigma}_k \f$
+     *
+     * \param y         Observations, one column per track
+     * \param observed  Flags the tracks with an observation
+     *
+     * \throws WrongSizeException if the number of observations or flags does
+     *         not match the number of tracks
+     */
+    void update(const ObsrvMatrix& y, const std::vector<bool>& observed)
+    {
+        if (size_t(y.cols()) != count() || observed.size() != count())
+        {
+            fl_throw(WrongSizeException(
+                "Number of observations does not match the number of tracks"));
+        }
+
+        innovate(y);
+
+        for_each_track(
+            [&](size_t k)
+            {
+                if (observed[k]) update_track(k);
+            });
+    }
+
+    /**
+     * Sets the thread pool used to run the per track kernels in parallel.
+     * The result does not depend on the number of threads.
+     *
+     * \param thread_pool   Thread pool or a null pointer to process all
+     *                      tracks in the calling thread (default)
+     */
+    void thread_pool(const std::shared_ptr<ThreadPool>& thread_pool)
+    {
+        thread_pool_ = thread_pool;
+    }
+
+    /**
+     * \return Thread pool running the per track kernels
+     */
+    const std::shared_ptr<ThreadPool>& thread_pool() const
+    {
+        return thread_pool_;
+    }
+
+    const std::shared_ptr<ProcessModel>& process_model()
+    {
+        return process_model_;
+    }
+
+    const std::shared_ptr<ObservationModel>& observation_model()
+    {
+        return obsrv_model_;
+    }
+
+protected:
+    /** \cond INTERNAL */
+    /**
+     * \return State dimension
+     */
+    int dimension() const
+    {
+        return means_.rows();
+    }
+
+    /**
+     * Computes the innovations and H [Sigma_1 ... Sigma_N] of all tracks in
+     * one product each
+     */
+    void innovate(const ObsrvMatrix& y)
+    {
+        auto&& H = obsrv_model_->H();
+
+        innovations_ = y;
+        innovations_.noalias() -= H * means_;
+        projections_.noalias() = H * covariances_;
+    }
+
+    /**
+     * Updates the k-th track given the innovations and projections computed
+     * by innovate()
+     */
+    void update_track(size_t k)
+    {
+        auto&& H = obsrv_model_->H();
+        auto&& R = obsrv_model_->covariance();
+
+        const int dim = dimension();
+
+        auto&& H_Sigma = projections_.middleCols(k * dim, dim);
+
+        auto&& S = (H_Sigma * H.transpose() + R).eval();
+        auto&& K_t = S.ldlt().solve(H_Sigma).eval();
+
+        means_.col(k).noalias() += K_t.transpose() * innovations_.col(k);
+        covariance(k).noalias() -= K_t.transpose() * H_Sigma;
+    }
+
+    /**
+     * Calls kernel(k) for all tracks k. With a thread pool the tracks are
+     * split into consecutive ranges which are distributed among the workers.
+     */
+    template <typename Kernel>
+    void for_each_track(Kernel kernel)
+    {
+        const size_t track_count = count();
+
+        if (thread_pool_ && thread_pool_->size() > 1 && track_count > 1)
+        {
+            const size_t ranges =
+                std::min(track_count, 4 * thread_pool_->size());
+
+            thread_pool_->parallel_for(
+                0, ranges,
+                [&](size_t range, size_t)
+                {
+                    const size_t begin = range * track_count / ranges;
+                    const size_t end = (range + 1) * track_count / ranges;
+
+                    for (size_t k = begin; k < end; ++k) kernel(k);
+                });
+        }
+        else
+        {
+            for (size_t k = 0; k < track_count; ++k) kernel(k);
+        }
+    }
+    /** \endcond */
+
+protected:
+    std::shared_ptr<ProcessModel> process_model_;
+    std::shared_ptr<ObservationModel> obsrv_model_;
+
+    /** \cond INTERNAL */
+    StateMatrix means_;
+    CovarianceMatrix covariances_;
+
+    StateMatrix means_buffer_;
+    CovarianceMatrix covariances_buffer_;
+    ObsrvMatrix innovations_;
+    ObsrvMatrix projections_;
+
+    std::shared_ptr<ThreadPool> thread_pool_;
+    /** \endcond */
+};
+
+}
+
+#endif
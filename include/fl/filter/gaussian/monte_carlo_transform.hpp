@@ -227,9 +227,11 @@ public:
         const size_t point_count = number_of_points(global_dimension);
         const double w = 1./double(point_count);        
 
+        point_set.points(gaussian.sample(point_count));
+
         for (int i = 0; i < point_count; ++i)
         {
-            point_set.point(i, gaussian.sample(), w);
+            point_set.weight(i, w);
 
             //point_set.point(i, cov_sqrt * lt.col(rand() % table_size), w);
         }
@@ -244,6 +246,20 @@ public:
     {
         return PointCountPolicy::number_of_points(dimension);
     }
+
+    /**
+     * \copydoc PointSetTransform::is_mean_point(size_t,
+     *                                           size_t,
+     *                                           size_t,
+     *                                           size_t)
+     *
+     * All points are drawn independently, hence none of them is a copy of
+     * the mean.
+     */
+    static constexpr bool is_mean_point(size_t, size_t, size_t, size_t)
+    {
+        return false;
+    }
 };
 
 }
@@ -0,0 +1,556 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file parallel_kalman_filter.hpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#ifndef FL__FILTER__GAUSSIAN__PARALLEL_KALMAN_FILTER_HPP
+#define FL__FILTER__GAUSSIAN__PARALLEL_KALMAN_FILTER_HPP
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+#include <Eigen/Dense>
+
+#include <fl/util/traits.hpp>
+#include <fl/util/thread_pool.hpp>
+#include <fl/distribution/gaussian.hpp>
+
+#include <fl/model/process/linear_process_model.hpp>
+#include <fl/model/observation/linear_observation_model.hpp>
+
+namespace fl
+{
+
+template <typename ProcessModel, typename ObservationModel>
+class ParallelKalmanFilter;
+
+/**
+ * Traits of the ParallelKalmanFilter
+ */
+template <typename State_, typename Input_, typename Observation_>
+struct Traits<
+           ParallelKalmanFilter<
+               LinearGaussianProcessModel<State_, Input_>,
+               LinearGaussianObservationModel<Observation_, State_>>>
+{
+    typedef LinearGaussianProcessModel<State_, Input_> ProcessModel;
+    typedef LinearGaussianObservationModel<
+                Observation_, State_
+            > ObservationModel;
+
+    typedef State_ State;
+    typedef Input_ Input;
+    typedef Observation_ Observation;
+    typedef typename State::Scalar Scalar;
+
+    typedef Gaussian<State> StateDistribution;
+
+    /**
+     * \brief State distributions of a whole sequence
+     */
+    typedef std::vector<StateDistribution> StateDistributions;
+
+    /**
+     * \brief Observations of a whole sequence
+     */
+    typedef std::vector<Observation> Observations;
+};
+
+/**
+ * \ingroup filters
+ *
+ * \brief Parallel-in-time Kalman filter and Rauch-Tung-Striebel smoother for
+ * the offline processing of long observation sequences.
+ *
+ * The filtering and the smoothing recursions are expressed as associative
+ * operations on per step elements (Särkkä and García-Fernández, Temporal
+ * Parallelization of Bayesian Smoothers, 2021). The elements of all steps
+ * are constructed independently and combined by an in-place parallel prefix
+ * scan. With a thread pool of sufficient size the span is
+ * \f$O(\log T)\f$ for \f$T\f$ steps at about twice the work of the
+ * sequential recursion. The scan levels are distributed over an optional
+ * thread pool, without one the scan is evaluated in the calling thread.
+ *
+ * The steps share the same time step and thus the same discretization of the
+ * process model. The results match the sequential
+ * GaussianFilter<LinearGaussianProcessModel, LinearGaussianObservationModel>
+ * calling predict_and_update() for every observation up to numerical
+ * precision.
+ */
+template <typename State, typename Input, typename Obsrv>
+class ParallelKalmanFilter<
+          LinearGaussianProcessModel<State, Input>,
+          LinearGaussianObservationModel<Obsrv, State>>
+{
+protected:
+    /** \cond INTERNAL */
+    typedef ParallelKalmanFilter<
+                LinearGaussianProcessModel<State, Input>,
+                LinearGaussianObservationModel<Obsrv, State>
+            > This;
+
+    typedef typename Traits<This>::Scalar Scalar;
+    /** \endcond */
+
+public:
+    typedef typename Traits<This>::ProcessModel ProcessModel;
+    typedef typename Traits<This>::ObservationModel ObservationModel;
+    typedef typename Traits<This>::StateDistribution StateDistribution;
+    typedef typename Traits<This>::StateDistributions StateDistributions;
+    typedef typename Traits<This>::Observations Observations;
+
+protected:
+    /** \cond INTERNAL */
+    typedef typename ProcessModel::DynamicsMatrix StateMatrix;
+
+    /**
+     * Filtering element representing
+     * \f$p(x_k \mid x_{j-1}, y_{j:k}) = {\cal N}(x_k \mid A x_{j-1} + b, C)\f$
+     * together with the likelihood
+     * \f$p(y_{j:k} \mid x_{j-1}) \propto
+     *    {\cal N}_I(x_{j-1} \mid \eta, J)\f$ in information form
+     */
+    struct FilterElement
+    {
+        StateMatrix A;
+        State b;
+        StateMatrix C;
+        State eta;
+        StateMatrix J;
+    };
+
+    /**
+     * Smoothing element representing
+     * \f$p(x_k \mid x_{j+1}, y_{1:T}) = {\cal N}(x_k \mid E x_{j+1} + g, L)\f$
+     */
+    struct SmootherElement
+    {
+        StateMatrix E;
+        State g;
+        StateMatrix L;
+    };
+    /** \endcond */
+
+public:
+    /**
+     * Creates a parallel Kalman filter
+     *
+     * \param process_model     Process model instance
+     * \param obsrv_model       Observation model instance
+     */
+    ParallelKalmanFilter(const std::shared_ptr<ProcessModel>& process_model,
+                         const std::shared_ptr<ObservationModel>& obsrv_model)
+        : process_model_(process_model),
+          obsrv_model_(obsrv_model)
+    { }
+
+    /**
+     * Filters the whole observation sequence. The k-th posterior is the
+     * result of predicting the (k-1)-th posterior, or the prior for k = 0,
+     * by delta_time and updating it with the k-th observation.
+     *
+     * \param delta_time    Time step between two consecutive observations
+     * \param input         Control input, unused by the linear model
+     * \param observations  Observations \f$y_{1:T}\f$
+     * \param prior_dist    Prior state distribution
+     * \param posteriors    Filtered state distributions, one per observation
+     */
+    void filter(double delta_time,
+                const Input&,
+                const Observations& observations,
+                const StateDistribution& prior_dist,
+                StateDistributions& posteriors)
+    {
+        const size_t steps = observations.size();
+
+        filter_elements_.resize(steps);
+        create_filter_elements(delta_time, observations, prior_dist);
+
+        scan(filter_elements_,
+             false,
+             [this](const FilterElement& earlier, FilterElement& later)
+             {
+                 combine(earlier, later);
+             });
+
+        posteriors.resize(steps, StateDistribution(prior_dist.dimension()));
+
+        for_each_step(
+            steps,
+            [&](size_t k)
+            {
+                posteriors[k].mean(filter_elements_[k].b);
+                posteriors[k].covariance(filter_elements_[k].C);
+            });
+    }
+
+    /**
+     * Smoothes the whole observation sequence, i.e. computes
+     * \f$p(x_k \mid y_{1:T})\f$ for all k. The sequence is filtered first,
+     * see filter(), and subsequently smoothed backwards by a suffix scan.
+     *
+     * \param delta_time    Time step between two consecutive observations
+     * \param input         Control input, unused by the linear model
+     * \param observations  Observations \f$y_{1:T}\f$
+     * \param prior_dist    Prior state distribution
+     * \param smoothed      Smoothed state distributions, one per observation
+     */
+    void smooth(double delta_time,
+                const Input& input,
+                const Observations& observations,
+                const StateDistribution& prior_dist,
+                StateDistributions& smoothed)
+    {
+        filter(delta_time, input, observations, prior_dist, smoothed);
+
+        const size_t steps = observations.size();
+
+        smoother_elements_.resize(steps);
+        create_smoother_elements(delta_time, smoothed);
+
+        scan(smoother_elements_,
+             true,
+             [this](SmootherElement& earlier, const SmootherElement& later)
+             {
+                 combine(earlier, later);
+             });
+
+        for_each_step(
+            steps,
+            [&](size_t k)
+            {
+                smoothed[k].mean(smoother_elements_[k].g);
+                smoothed[k].covariance(smoother_elements_[k].L);
+            });
+    }
+
+    /**
+     * Sets the thread pool used to construct and combine the elements in
+     * parallel. The result does not depend on the number of threads.
+     *
+     * \param thread_pool   Thread pool or a null pointer to process all
+     *                      steps in the calling thread (default)
+     */
+    void thread_pool(const std::shared_ptr<ThreadPool>& thread_pool)
+    {
+        thread_pool_ = thread_pool;
+    }
+
+    /**
+     * \return Thread pool running the scan
+     */
+    const std::shared_ptr<ThreadPool>& thread_pool() const
+    {
+        return thread_pool_;
+    }
+
+    const std::shared_ptr<ProcessModel>& process_model()
+    {
+        return process_model_;
+    }
+
+    const std::shared_ptr<ObservationModel>& observation_model()
+    {
+        return obsrv_model_;
+    }
+
+protected:
+    /** \cond INTERNAL */
+    /**
+     * Creates the filtering elements. The first element incorporates the
+     * prior,
+     *
+     * \f$ A_1 = 0 \f$, \f$ b_1 = \bar{x}_1 + K_1 (y_1 - H \bar{x}_1) \f$,
+     * \f$ C_1 = (I - K_1 H) \bar{\Sigma}_1 \f$, \f$ \eta_1 = 0 \f$,
+     * \f$ J_1 = 0 \f$
+     *
+     * with the predicted prior \f$\bar{x}_1, \bar{\Sigma}_1\f$. All other
+     * elements are conditioned on the previous state,
+     *
+     * \f$ A_k = (I - K H) A \f$, \f$ b_k = K y_k \f$,
+     * \f$ C_k = (I - K H) Q \f$,
+     * \f$ \eta_k = A^T H^T S^{-1} y_k \f$, \f$ J_k = A^T H^T S^{-1} H A \f$
+     *
+     * with \f$ S = H Q H^T + R \f$ and \f$ K = Q H^T S^{-1} \f$. Only
+     * \f$b_k\f$ and \f$\eta_k\f$ depend on the observation, the remaining
+     * quantities are computed once.
+     */
+    void create_filter_elements(double delta_time,
+                                const Observations& y,
+                                const StateDistribution& prior_dist)
+    {
+        if (y.empty()) return;
+
+        auto&& A = process_model_->discretized_A(delta_time);
+        auto&& Q = process_model_->discretized_covariance(delta_time);
+        auto&& H = obsrv_model_->H();
+        auto&& R = obsrv_model_->covariance();
+
+        const int dim = prior_dist.dimension();
+        const StateMatrix I = StateMatrix::Identity(dim, dim);
+
+        // conditional elements
+        auto&& S = (H * Q * H.transpose() + R).eval();
+        auto&& ldlt = S.ldlt();
+
+        // S^-1 H and K = Q H^T S^-1
+        auto&& S_inv_H = ldlt.solve(H).eval();
+        auto&& K = (Q * S_inv_H.transpose()).eval();
+        auto&& H_A = (H * A).eval();
+
+        FilterElement element;
+        element.A = (I - K * H) * A;
+        element.C = (I - K * H) * Q;
+        element.J = H_A.transpose() * S_inv_H * A;
+
+        auto&& eta_gain = (A.transpose() * S_inv_H.transpose()).eval();
+
+        for_each_step(
+            y.size(),
+            [&](size_t k)
+            {
+                if (k == 0) return;
+
+                FilterElement& e = filter_elements_[k];
+                e.A = element.A;
+                e.C = element.C;
+                e.J = element.J;
+                e.b.noalias() = K * y[k];
+                e.eta.noalias() = eta_gain * y[k];
+            });
+
+        // first element with the prior
+        auto&& mean = (A * prior_dist.mean()).eval();
+        auto&& cov_xx = (A * prior_dist.covariance() * A.transpose() + Q)
+                            .eval();
+
+        auto&& S_1 = (H * cov_xx * H.transpose() + R).eval();
+        auto&& K_1 = (cov_xx * H.transpose() * S_1.inverse()).eval();
+
+        FilterElement& first = filter_elements_[0];
+        first.A = StateMatrix::Zero(dim, dim);
+        first.b = mean + K_1 * (y[0] - H * mean);
+        first.C = cov_xx - K_1 * H * cov_xx;
+        first.eta = State::Zero(dim);
+        first.J = StateMatrix::Zero(dim, dim);
+    }
+
+    /**
+     * Creates the smoothing elements from the filtered distributions
+     * \f$\hat{x}_k, \hat{\Sigma}_k\f$,
+     *
+     * \f$ E_k = \hat{\Sigma}_k A^T (A \hat{\Sigma}_k A^T + Q)^{-1} \f$,
+     * \f$ g_k = \hat{x}_k - E_k A \hat{x}_k \f$,
+     * \f$ L_k = \hat{\Sigma}_k - E_k A \hat{\Sigma}_k \f$
+     *
+     * and \f$ E_T = 0 \f$, \f$ g_T = \hat{x}_T \f$,
+     * \f$ L_T = \hat{\Sigma}_T \f$ for the last step.
+     */
+    void create_smoother_elements(double delta_time,
+                                  const StateDistributions& filtered)
+    {
+        if (filtered.empty()) return;
+
+        auto&& A = process_model_->discretized_A(delta_time);
+        auto&& Q = process_model_->discretized_covariance(delta_time);
+
+        const size_t last = filtered.size() - 1;
+
+        for_each_step(
+            filtered.size(),
+            [&](size_t k)
+            {
+                auto&& mean = filtered[k].mean();
+                auto&& cov_xx = filtered[k].covariance();
+
+                SmootherElement& e = smoother_elements_[k];
+
+                if (k == last)
+                {
+                    e.E = StateMatrix::Zero(mean.rows(), mean.rows());
+                    e.g = mean;
+                    e.L = cov_xx;
+                    return;
+                }
+
+                auto&& A_Sigma = (A * cov_xx).eval();
+                auto&& P = (A_Sigma * A.transpose() + Q).eval();
+
+                // E^T = P^-1 A Sigma
+                e.E = P.ldlt().solve(A_Sigma).transpose();
+                e.g = mean - e.E * (A * mean);
+                e.L = cov_xx - e.E * A_Sigma;
+            });
+    }
+
+    /**
+     * Combines two consecutive filtering elements, later = earlier (x) later,
+     *
+     * \f$ A_{ij} = A_j (I + C_i J_j)^{-1} A_i \f$,
+     * \f$ b_{ij} = A_j (I + C_i J_j)^{-1} (b_i + C_i \eta_j) + b_j \f$,
+     * \f$ C_{ij} = A_j (I + C_i J_j)^{-1} C_i A_j^T + C_j \f$,
+     *
+     * \f$ \eta_{ij} = A_i^T (I + J_j C_i)^{-1} (\eta_j - J_j b_i) + \eta_i \f$,
+     * \f$ J_{ij} = A_i^T (I + J_j C_i)^{-1} J_j A_i + J_i \f$
+     */
+    static void combine(const FilterElement& earlier, FilterElement& later)
+    {
+        const FilterElement& i = earlier;
+        FilterElement& j = later;
+
+        const int dim = i.b.rows();
+        const StateMatrix I = StateMatrix::Identity(dim, dim);
+
+        // A_j (I + C_i J_j)^-1 = ((I + J_j C_i)^-1 A_j^T)^T
+        auto&& lu = (I + j.J * i.C).partialPivLu();
+        auto&& A_j_M = lu.solve(j.A.transpose()).transpose().eval();
+
+        // A_i^T (I + J_j C_i)^-1 = ((I + C_i J_j)^-1 A_i)^T
+        auto&& A_i_N = (I + i.C * j.J).partialPivLu()
+                           .solve(i.A).transpose().eval();
+
+        auto&& eta = (A_i_N * (j.eta - j.J * i.b) + i.eta).eval();
+        auto&& J = (A_i_N * j.J * i.A + i.J).eval();
+
+        j.b = A_j_M * (i.b + i.C * j.eta) + j.b;
+        j.C = A_j_M * i.C * j.A.transpose() + j.C;
+        j.A = (A_j_M * i.A).eval();
+        j.eta = eta;
+        j.J = J;
+    }
+
+    /**
+     * Combines two consecutive smoothing elements,
+     * earlier = earlier (x) later,
+     *
+     * \f$ E_{ij} = E_i E_j \f$, \f$ g_{ij} = E_i g_j + g_i \f$,
+     * \f$ L_{ij} = E_i L_j E_i^T + L_i \f$
+     */
+    static void combine(SmootherElement& earlier, const SmootherElement& later)
+    {
+        earlier.g += earlier.E * later.g;
+        earlier.L += earlier.E * later.L * earlier.E.transpose();
+        earlier.E = (earlier.E * later.E).eval();
+    }
+
+    /**
+     * Inclusive in-place scan of the elements with an associative
+     * operation in \f$2 \lceil\log_2 T\rceil\f$ levels. The up-sweep reduces
+     * blocks of doubling size, the down-sweep propagates the block prefixes
+     * into the remaining elements. The targets of one level are disjoint
+     * from its sources and are processed in parallel.
+     *
+     * The forward scan calls op(elements[i - d], elements[i]) which stores
+     * the combination in the later element, the reverse scan calls
+     * op(elements[i], elements[i + d]) which stores it in the earlier
+     * element.
+     */
+    template <typename Element, typename Operation>
+    void scan(std::vector<Element>& elements, bool reverse, Operation op)
+    {
+        const size_t n = elements.size();
+
+        // maps the scan position to the element index
+        auto index = [n, reverse](size_t position)
+        {
+            return reverse ? n - 1 - position : position;
+        };
+
+        auto combine_level = [&](size_t first, size_t stride, size_t d)
+        {
+            if (first >= n) return;
+
+            for_each_step(
+                (n - 1 - first) / stride + 1,
+                [&](size_t k)
+                {
+                    const size_t target = index(first + k * stride);
+                    const size_t source = index(first + k * stride - d);
+
+                    if (reverse)
+                    {
+                        op(elements[target], elements[source]);
+                    }
+                    else
+                    {
+                        op(elements[source], elements[target]);
+                    }
+                });
+        };
+
+        size_t d = 1;
+
+        // up-sweep
+        for (; d < n; d *= 2)
+        {
+            combine_level(2 * d - 1, 2 * d, d);
+        }
+
+        // down-sweep
+        for (d /= 2; d >= 1; d /= 2)
+        {
+            combine_level(3 * d - 1, 2 * d, d);
+        }
+    }
+
+    /**
+     * Calls kernel(k) for all k in [0, steps). With a thread pool the steps
+     * are split into consecutive ranges which are distributed among the
+     * workers.
+     */
+    template <typename Kernel>
+    void for_each_step(size_t steps, Kernel kernel)
+    {
+        if (thread_pool_ && thread_pool_->size() > 1 && steps > 1)
+        {
+            const size_t ranges = std::min(steps, 4 * thread_pool_->size());
+
+            thread_pool_->parallel_for(
+                0, ranges,
+                [&](size_t range, size_t)
+                {
+                    const size_t begin = range * steps / ranges;
+                    const size_t end = (range + 1) * steps / ranges;
+
+                    for (size_t k = begin; k < end; ++k) kernel(k);
+                });
+        }
+        else
+        {
+            for (size_t k = 0; k < steps; ++k) kernel(k);
+        }
+    }
+    /** \endcond */
+
+protected:
+    std::shared_ptr<ProcessModel> process_model_;
+    std::shared_ptr<ObservationModel> obsrv_model_;
+
+    /** \cond INTERNAL */
+    std::vector<FilterElement> filter_elements_;
+    std::vector<SmootherElement> smoother_elements_;
+
+    std::shared_ptr<ThreadPool> thread_pool_;
+    /** \endcond */
+};
+
+}
+
+#endif
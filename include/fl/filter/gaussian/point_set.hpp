@@ -409,6 +409,29 @@ public:
         weights_[i] = weights;
     }
 
+    /**
+     * Sets all points at once. The point weights remain unchanged.
+     *
+     * \param points    Point matrix containing one point per column
+     *
+     * \throws WrongSizeException
+     */
+    template <typename Points>
+    void points(const Eigen::MatrixBase<Points>& points)
+    {
+        if (points.cols() != points_.cols())
+        {
+            fl_throw(WrongSizeException(points.cols(), points_.cols()));
+        }
+
+        if (points.rows() != points_.rows())
+        {
+            fl_throw(WrongSizeException(points.rows(), points_.rows()));
+        }
+
+        points_ = points;
+    }
+
     /**
      * Sets a given weight of a point at position i
      *
@@ -85,6 +85,16 @@ public:
          */
         derived->forward(Gaussian<Point>(), 1, 0, point_set);
 
+        /**
+         * - Asserts the existens of the mean point query \code
+         *   static bool is_mean_point(size_t i,
+         *                             size_t global_dimension,
+         *                             size_t dimension_offset,
+         *                             size_t dimension)
+         * \endcode
+         */
+        Derived::is_mean_point(0, 1, 0, 1);
+
         /** \endcond */
     }
 
@@ -157,6 +167,28 @@ public:
                  size_t global_dimension,
                  size_t dimension_offset,
                  PointSet& point_set) const;
+
+    /**
+     * \note This function is not explicitly definded nor implemented within
+     *       PointSetTransform. However, it is implicitly required to be
+     *       implemented in the Derived class.
+     *
+     * Determines whether the i-th point of a partitioned transform
+     * (see forward(const Gaussian&, size_t, size_t, PointSet&)) is an exact
+     * copy of the mean of the marginal Gaussian. If a point is a mean copy in
+     * all partitions of the joint Gaussian, it is identical to the first
+     * point. Filters use this to evaluate a model once per distinct point and
+     * to broadcast the result to all duplicates.
+     *
+     * \param i                 Point index
+     * \param global_dimension  Dimension of the global covariance
+     * \param dimension_offset  Dimension offset of the marginal Gaussian
+     * \param dimension         Dimension of the marginal Gaussian
+     */
+    static constexpr bool is_mean_point(size_t i,
+                                        size_t global_dimension,
+                                        size_t dimension_offset,
+                                        size_t dimension);
 #endif
 };
 
@@ -154,6 +154,30 @@ public:
         return (dimension != Eigen::Dynamic) ? 2 * dimension + 1 : -1;
     }
 
+    /**
+     * \copydoc PointSetTransform::is_mean_point(size_t,
+     *                                           size_t,
+     *                                           size_t,
+     *                                           size_t)
+     *
+     * The i-th and the (global_dimension + i)-th points are shifted only along
+     * the i-th column of the joint square root. All points outside of the
+     * range [dimension_offset + 1, dimension_offset + dimension] and their
+     * mirrored counterparts are therefore exact copies of the mean.
+     */
+    static constexpr bool is_mean_point(size_t i,
+                                        size_t global_dimension,
+                                        size_t dimension_offset,
+                                        size_t dimension)
+    {
+        return i == 0
+               || (i > global_dimension
+                   ? !in_partition(i - global_dimension,
+                                   dimension_offset,
+                                   dimension)
+                   : !in_partition(i, dimension_offset, dimension));
+    }
+
 public:
     /** \cond INTERNAL */
 
@@ -212,6 +236,17 @@ public:
     {
         return std::sqrt(dim + lambda_scalar(dim));
     }
+
+    /**
+     * \return True if the j-th column of the joint square root, j > 0,
+     *         belongs to the partition starting at dimension_offset
+     */
+    static constexpr bool in_partition(size_t j,
+                                       size_t dimension_offset,
+                                       size_t dimension)
+    {
+        return dimension_offset < j && j <= dimension_offset + dimension;
+    }
     /** \endcond */
 
 protected:
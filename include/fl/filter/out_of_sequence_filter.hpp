@@ -0,0 +1,673 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file out_of_sequence_filter.hpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#ifndef FL__FILTER__OUT_OF_SEQUENCE_FILTER_HPP
+#define FL__FILTER__OUT_OF_SEQUENCE_FILTER_HPP
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <algorithm>
+
+#include <Eigen/Dense>
+
+#include <fl/util/traits.hpp>
+#include <fl/util/profiling.hpp>
+#include <fl/exception/exception.hpp>
+#include <fl/filter/filter_interface.hpp>
+#include <fl/filter/gaussian/gaussian_filter_kf.hpp>
+
+namespace fl
+{
+
+/**
+ * \ingroup filters
+ *
+ * \brief Replay cost metrics of the OutOfSequenceFilter
+ */
+struct OutOfSequenceMetrics
+{
+    OutOfSequenceMetrics()
+        : in_sequence(0),
+          out_of_sequence(0),
+          retrodictions(0),
+          dropped(0),
+          replays(0),
+          replayed_steps(0),
+          max_replayed_steps(0),
+          replay_time(0.)
+    { }
+
+    /** \brief Number of measurements processed in order */
+    size_t in_sequence;
+
+    /** \brief Number of late measurements incorporated */
+    size_t out_of_sequence;
+
+    /** \brief Number of late measurements incorporated by retrodiction */
+    size_t retrodictions;
+
+    /** \brief Number of late measurements older than the history */
+    size_t dropped;
+
+    /** \brief Number of replays of the history */
+    size_t replays;
+
+    /** \brief Total number of filter steps repeated by all replays */
+    size_t replayed_steps;
+
+    /** \brief Maximum number of filter steps repeated by one replay */
+    size_t max_replayed_steps;
+
+    /** \brief Total wall time of all replays in seconds */
+    double replay_time;
+};
+
+/**
+ * \ingroup filters
+ *
+ * \brief One-step retrodiction of out-of-sequence measurements
+ *
+ * Incorporates a measurement taken at \f$\tau\f$ within the last filter
+ * step \f$(t_{k-1}, t_k)\f$ directly into the current posterior without
+ * replaying the step. Filters without a specialization do not support the
+ * retrodiction and the OutOfSequenceFilter falls back to the replay.
+ *
+ * \tparam Filter   Filter type
+ */
+template <typename Filter>
+struct Retrodiction
+{
+    /**
+     * \return False, i.e. the measurement has not been incorporated
+     */
+    template <typename... Args>
+    static bool apply(Args&&...)
+    {
+        return false;
+    }
+};
+
+/**
+ * \ingroup filters
+ *
+ * \brief Retrodiction of the Kalman filter
+ *
+ * Implements the exact single lag algorithm A1 of Bar-Shalom (Update with
+ * out-of-sequence measurements in tracking: exact solution, 2002). With
+ * \f$F\f$ and \f$Q\f$ denoting the transition and the noise covariance from
+ * \f$\tau\f$ to \f$t_k\f$, and \f$S\f$, \f$\nu\f$ the innovation
+ * covariance and the innovation of the update at \f$t_k\f$, the state at
+ * \f$\tau\f$ is retrodicted
+ *
+ * \f$ x_{\tau|k} = F^{-1}(x_{k|k} - Q H^T S^{-1} \nu) \f$
+ *
+ * \f$ P_{\tau|k} = F^{-1}(P_{k|k} + P_{vv} - P_{xv} - P_{xv}^T) F^{-T} \f$
+ *
+ * with \f$ P_{vv} = Q - Q H^T S^{-1} H Q \f$ and
+ * \f$ P_{xv} = Q - P_{k|k-1} H^T S^{-1} H Q \f$. The late measurement
+ * \f$y_\tau\f$ then updates the current state
+ *
+ * \f$ P_{xy} = (P_{k|k} - P_{xv}) F^{-T} H^T \f$,
+ * \f$ S_\tau = H P_{\tau|k} H^T + R \f$
+ *
+ * \f$ x_{k|\tau} = x_{k|k} + P_{xy} S_\tau^{-1} (y_\tau - H x_{\tau|k}) \f$,
+ * \f$ P_{k|\tau} = P_{k|k} - P_{xy} S_\tau^{-1} P_{xy}^T \f$.
+ *
+ * The result equals the replay if the transition of the process model
+ * composes over time, e.g. ContinuousLinearGaussianProcessModel.
+ */
+template <typename State, typename Input, typename Obsrv>
+struct Retrodiction<
+           GaussianFilter<
+               LinearGaussianProcessModel<State, Input>,
+               LinearGaussianObservationModel<Obsrv, State>>>
+{
+    typedef GaussianFilter<
+                LinearGaussianProcessModel<State, Input>,
+                LinearGaussianObservationModel<Obsrv, State>
+            > Filter;
+
+    typedef typename Filter::StateDistribution StateDistribution;
+
+    /**
+     * \param filter            Kalman filter
+     * \param delta_time        \f$t_k - \tau\f$
+     * \param observation       Observation \f$y_k\f$ of the last step
+     * \param predicted_dist    Prediction of the last step
+     * \param late_observation  Late observation \f$y_\tau\f$
+     * \param posterior_dist    Posterior of the last step, replaced by the
+     *                          posterior incorporating \f$y_\tau\f$
+     *
+     * \return False if the transition from \f$\tau\f$ to \f$t_k\f$ is not
+     *         invertible. The posterior is left untouched in this case.
+     */
+    static bool apply(Filter& filter,
+                      double delta_time,
+                      const Obsrv& observation,
+                      const StateDistribution& predicted_dist,
+                      const Obsrv& late_observation,
+                      StateDistribution& posterior_dist)
+    {
+        auto&& F = filter.process_model()->discretized_A(delta_time);
+        auto&& Q = filter.process_model()->discretized_covariance(delta_time);
+        auto&& H = filter.observation_model()->H();
+        auto&& R = filter.observation_model()->covariance();
+
+        auto&& lu = F.fullPivLu();
+        if (!lu.isInvertible()) return false;
+
+        auto&& F_inv = lu.inverse().eval();
+
+        auto&& P_predicted = predicted_dist.covariance();
+        auto&& P = posterior_dist.covariance();
+        auto&& x = posterior_dist.mean();
+
+        // innovation of the last update
+        auto&& S = (H * P_predicted * H.transpose() + R).eval();
+        auto&& ldlt = S.ldlt();
+        auto&& innovation = (observation - H * predicted_dist.mean()).eval();
+
+        // H^T S^-1 H Q
+        auto&& H_Q = (H * Q).eval();
+        auto&& M = (H.transpose() * ldlt.solve(H_Q)).eval();
+
+        auto&& P_vv = (Q - Q * M).eval();
+        auto&& P_xv = (Q - P_predicted * M).eval();
+
+        auto&& x_retro = (F_inv * (x - H_Q.transpose()
+                                           * ldlt.solve(innovation))).eval();
+        auto&& P_retro = (F_inv * (P + P_vv - P_xv - P_xv.transpose())
+                                * F_inv.transpose()).eval();
+
+        auto&& P_xy = ((P - P_xv) * F_inv.transpose() * H.transpose()).eval();
+        auto&& S_late = (H * P_retro * H.transpose() + R).eval();
+        auto&& late_ldlt = S_late.ldlt();
+
+        auto&& mean = (x + P_xy * late_ldlt.solve(
+                                 late_observation - H * x_retro)).eval();
+        auto&& covariance = (P - P_xy * late_ldlt.solve(P_xy.transpose()))
+                                .eval();
+
+        posterior_dist.mean(mean);
+        posterior_dist.covariance(0.5 * (covariance + covariance.transpose()));
+
+        return true;
+    }
+};
+
+/**
+ * \ingroup filters
+ *
+ * \brief Filter wrapper incorporating measurements with variable latency
+ *
+ * The wrapper keeps a bounded, time ordered history of the measurements,
+ * inputs, predictions and posteriors of the last steps. A measurement newer
+ * than the current state is processed regularly. A late measurement is
+ * inserted into the history at its timestamp and only the affected suffix of
+ * the history is replayed. Measurements older than the history are dropped.
+ *
+ * If the retrodiction is enabled and a late measurement falls into the last
+ * filter step, it is incorporated by Retrodiction<Filter>, e.g. the exact
+ * one-step retrodiction of the Kalman filter, instead of the replay.
+ *
+ * The history is allocated once with a fixed number of entries. The costs of
+ * the late measurements are recorded in the metrics().
+ *
+ * \tparam Filter   Wrapped filter type implementing the FilterInterface
+ */
+template <typename Filter>
+class OutOfSequenceFilter
+{
+public:
+    typedef typename Traits<Filter>::State State;
+    typedef typename Traits<Filter>::Input Input;
+    typedef typename Traits<Filter>::Observation Obsrv;
+    typedef typename Traits<Filter>::StateDistribution StateDistribution;
+
+protected:
+    /** \cond INTERNAL */
+    /**
+     * \brief History entry of one filter step
+     */
+    struct Entry
+    {
+        double time;
+        Input input;
+        Obsrv observation;
+        bool observed;
+
+        StateDistribution predicted;
+        StateDistribution posterior;
+
+        /** \brief The prediction originates from the previous posterior */
+        bool prediction_valid;
+
+        /** \brief The posterior incorporates all previous measurements */
+        bool posterior_valid;
+    };
+    /** \endcond */
+
+public:
+    /**
+     * Creates an out-of-sequence filter
+     *
+     * \param filter        Wrapped filter
+     * \param history_size  Maximum number of history entries, at least 2
+     */
+    OutOfSequenceFilter(const std::shared_ptr<Filter>& filter,
+                        size_t history_size)
+        : filter_(filter),
+          entries_(std::max(history_size, size_t(2))),
+          slots_(entries_.size()),
+          first_(0),
+          count_(0),
+          retrodiction_(false)
+    {
+        for (size_t i = 0; i < slots_.size(); ++i) slots_[i] = i;
+    }
+
+    /**
+     * Clears the history and sets the state distribution at the given time
+     */
+    void initialize(double time, const StateDistribution& distribution)
+    {
+        for (auto& entry: entries_)
+        {
+            entry.predicted = distribution;
+            entry.posterior = distribution;
+        }
+
+        first_ = 0;
+        count_ = 1;
+
+        Entry& anchor = entry(0);
+        anchor.time = time;
+        anchor.observed = false;
+        anchor.prediction_valid = false;
+        anchor.posterior_valid = true;
+    }
+
+    /**
+     * Incorporates a measurement taken at the given time
+     *
+     * \param time          Measurement time
+     * \param input         Control input since the previous step
+     * \param observation   Measurement
+     *
+     * \return False if the measurement is older than the history and has
+     *         been dropped
+     *
+     * \throws Exception if the filter has not been initialized
+     */
+    bool update(double time, const Input& input, const Obsrv& observation)
+    {
+        check_initialized();
+
+        if (time >= entry(count_ - 1).time)
+        {
+            if (count_ == entries_.size()) drop_oldest();
+
+            ++count_;
+            assign(entry(count_ - 1), time, input, observation);
+            step(count_ - 1);
+
+            ++metrics_.in_sequence;
+            return true;
+        }
+
+        // first entry after the measurement
+        size_t position = count_ - 1;
+        while (position > 0 && entry(position - 1).time > time) --position;
+
+        if (position == 0 || (position == 1 && count_ == entries_.size()))
+        {
+            ++metrics_.dropped;
+            return false;
+        }
+
+        ++metrics_.out_of_sequence;
+
+        if (count_ == entries_.size())
+        {
+            drop_oldest();
+            --position;
+        }
+
+        if (retrodiction_ && position == count_ - 1 && retrodict(time,
+                                                                 observation))
+        {
+            insert(position, time, input, observation);
+
+            entry(position).posterior_valid = false;
+            entry(position).prediction_valid = false;
+            entry(count_ - 1).prediction_valid = false;
+
+            ++metrics_.retrodictions;
+            return true;
+        }
+
+        insert(position, time, input, observation);
+        replay(position);
+
+        return true;
+    }
+
+    /**
+     * Predicts the current state to the given time without recording it
+     *
+     * \param time              Prediction time
+     * \param input             Control input
+     * \param predicted_dist    Predicted state distribution
+     *
+     * \throws Exception if the filter has not been initialized
+     */
+    void predict(double time,
+                 const Input& input,
+                 StateDistribution& predicted_dist)
+    {
+        check_initialized();
+
+        const Entry& newest = entry(count_ - 1);
+
+        filter_->predict(time - newest.time,
+                         input,
+                         newest.posterior,
+                         predicted_dist);
+    }
+
+    /**
+     * \return Current state distribution including all measurements
+     *
+     * \throws Exception if the filter has not been initialized
+     */
+    const StateDistribution& distribution() const
+    {
+        check_initialized();
+
+        return entry(count_ - 1).posterior;
+    }
+
+    /**
+     * \return Time of the current state distribution
+     *
+     * \throws Exception if the filter has not been initialized
+     */
+    double time() const
+    {
+        check_initialized();
+
+        return entry(count_ - 1).time;
+    }
+
+    /**
+     * \return Time of the oldest history entry. Older measurements are
+     *         dropped.
+     *
+     * \throws Exception if the filter has not been initialized
+     */
+    double horizon() const
+    {
+        check_initialized();
+
+        return entry(0).time;
+    }
+
+    /**
+     * \return Number of history entries
+     */
+    size_t size() const
+    {
+        return count_;
+    }
+
+    /**
+     * \return Maximum number of history entries
+     */
+    size_t history_size() const
+    {
+        return entries_.size();
+    }
+
+    /**
+     * Enables or disables the retrodiction of late measurements within the
+     * last step, see Retrodiction
+     *
+     * \param enabled     Retrodiction flag, disabled by default
+     */
+    void retrodiction(bool enabled)
+    {
+        retrodiction_ = enabled;
+    }
+
+    /**
+     * \return True if the retrodiction is enabled
+     */
+    bool retrodiction() const
+    {
+        return retrodiction_;
+    }
+
+    /**
+     * \return Replay cost metrics
+     */
+    const OutOfSequenceMetrics& metrics() const
+    {
+        return metrics_;
+    }
+
+    /**
+     * Resets the replay cost metrics
+     */
+    void reset_metrics()
+    {
+        metrics_ = OutOfSequenceMetrics();
+    }
+
+    const std::shared_ptr<Filter>& filter()
+    {
+        return filter_;
+    }
+
+protected:
+    /** \cond INTERNAL */
+    /**
+     * \throws Exception if the filter has not been initialized
+     */
+    void check_initialized() const
+    {
+        if (count_ == 0)
+        {
+            fl_throw(Exception("OutOfSequenceFilter is not initialized"));
+        }
+    }
+
+    /**
+     * \return i-th history entry, counted from the oldest
+     */
+    Entry& entry(size_t i)
+    {
+        return entries_[slot(i)];
+    }
+
+    const Entry& entry(size_t i) const
+    {
+        return entries_[slots_[(first_ + i) % slots_.size()]];
+    }
+
+    /**
+     * \return Index of the storage slot holding the i-th history entry
+     */
+    size_t& slot(size_t i)
+    {
+        return slots_[(first_ + i) % slots_.size()];
+    }
+
+    static void assign(Entry& entry,
+                       double time,
+                       const Input& input,
+                       const Obsrv& observation)
+    {
+        entry.time = time;
+        entry.input = input;
+        entry.observation = observation;
+        entry.observed = true;
+    }
+
+    /**
+     * Predicts the i-th entry from the posterior of its predecessor and
+     * updates it with its measurement
+     */
+    void step(size_t i)
+    {
+        const Entry& previous = entry(i - 1);
+        Entry& current = entry(i);
+
+        filter_->predict(current.time - previous.time,
+                         current.input,
+                         previous.posterior,
+                         current.predicted);
+
+        if (current.observed)
+        {
+            filter_->update(current.observation,
+                            current.predicted,
+                            current.posterior);
+        }
+        else
+        {
+            current.posterior = current.predicted;
+        }
+
+        current.prediction_valid = true;
+        current.posterior_valid = true;
+    }
+
+    /**
+     * Inserts a measurement before the entry at the given position. Only the
+     * slot indices are rotated, the entries themselves are not moved.
+     */
+    void insert(size_t position,
+                double time,
+                const Input& input,
+                const Obsrv& observation)
+    {
+        ++count_;
+
+        // move the free slot at the end of the history to the position
+        for (size_t i = count_ - 1; i > position; --i)
+        {
+            std::swap(slot(i), slot(i - 1));
+        }
+
+        assign(entry(position), time, input, observation);
+    }
+
+    /**
+     * Drops the oldest entry. Its successor becomes the new anchor of the
+     * history and is replayed first if its posterior is incomplete. Only the
+     * successor itself is replayed, later entries are left to the caller.
+     */
+    void drop_oldest()
+    {
+        if (!entry(1).posterior_valid) replay(1, 2);
+
+        entry(1).observed = false;
+        entry(1).prediction_valid = false;
+
+        first_ = (first_ + 1) % entries_.size();
+        --count_;
+    }
+
+    /**
+     * Replays the entries from the given position up to the entry before
+     * \c end, by default up to the newest entry. The replay starts at the
+     * latest valid posterior before the position.
+     */
+    void replay(size_t position, size_t end = 0)
+    {
+        if (end == 0) end = count_;
+
+        double start_time;
+        double end_time;
+        GET_TIME(start_time);
+
+        size_t start = position - 1;
+        while (!entry(start).posterior_valid) --start;
+
+        for (size_t i = start + 1; i < end; ++i)
+        {
+            step(i);
+        }
+
+        GET_TIME(end_time);
+
+        const size_t steps = end - 1 - start;
+
+        ++metrics_.replays;
+        metrics_.replayed_steps += steps;
+        metrics_.max_replayed_steps =
+            std::max(metrics_.max_replayed_steps, steps);
+        metrics_.replay_time += end_time - start_time;
+    }
+
+    /**
+     * Incorporates a measurement within the last step by retrodiction
+     */
+    bool retrodict(double time, const Obsrv& observation)
+    {
+        Entry& newest = entry(count_ - 1);
+
+        if (!newest.prediction_valid || !newest.observed) return false;
+
+        return Retrodiction<Filter>::apply(*filter_,
+                                           newest.time - time,
+                                           newest.observation,
+                                           newest.predicted,
+                                           observation,
+                                           newest.posterior);
+    }
+    /** \endcond */
+
+protected:
+    std::shared_ptr<Filter> filter_;
+
+    /** \cond INTERNAL */
+    /**
+     * \brief Storage of the history entries
+     */
+    std::vector<Entry> entries_;
+
+    /**
+     * \brief Ring buffer of the slot indices of the history entries
+     */
+    std::vector<size_t> slots_;
+    size_t first_;
+    size_t count_;
+
+    bool retrodiction_;
+    OutOfSequenceMetrics metrics_;
+    /** \endcond */
+};
+
+}
+
+#endif
@@ -29,6 +29,7 @@
 
 #include <fl/util/traits.hpp>
 #include <fl/util/meta.hpp>
+#include <fl/util/thread_pool.hpp>
 
 #include <fl/model/observation/observation_model_interface.hpp>
 
@@ -84,6 +85,13 @@ public:
     typedef typename Traits<This>::Noise Noise;
     typedef typename Traits<This>::Observation Observation;
 
+    typedef typename Traits<This>::ObservationModelBase::StateMatrix
+                StateMatrix;
+    typedef typename Traits<This>::ObservationModelBase::NoiseMatrix
+                NoiseMatrix;
+    typedef typename Traits<This>::ObservationModelBase::ObservationMatrix
+                ObservationMatrix;
+
 public:
     /**
      * Constructor a JointObservationModel which is a composition of mixture of
@@ -120,6 +128,24 @@ public:
         return prediction;
     }
 
+    /**
+     * \copydoc ObservationModelInterface::predict_observations
+     *
+     * Each sub-model predicts its block of rows of all observations at once.
+     */
+    virtual void predict_observations(
+        const Eigen::Ref<const StateMatrix>& states,
+        const Eigen::Ref<const NoiseMatrix>& noises,
+        double delta_time,
+        Eigen::Ref<ObservationMatrix> predictions)
+    {
+        predict_observations<sizeof...(Models)>(
+            models_,
+            delta_time,
+            states,
+            noises,
+            predictions);
+    }
 
     /**
      * \copydoc ObservationModelInterface::state_dimension
@@ -151,6 +177,37 @@ public:
         return expand_obsrv_dimension(CreateIndexSequence<sizeof...(Models)>());
     }
 
+    /**
+     * \copydoc ObservationModelInterface::is_thread_safe
+     *
+     * The joint model is thread safe if all sub-models are thread safe
+     */
+    virtual bool is_thread_safe() const
+    {
+        return expand_is_thread_safe(CreateIndexSequence<sizeof...(Models)>());
+    }
+
+    /**
+     * \copydoc ObservationModelInterface::clone
+     *
+     * The clone shares the thread safe sub-models and uses clones of all
+     * others.
+     */
+    virtual std::shared_ptr<typename Traits<This>::ObservationModelBase> clone() const
+    {
+        return expand_clone(CreateIndexSequence<sizeof...(Models)>());
+    }
+
+    /**
+     * \copydoc ObservationModelInterface::version
+     *
+     * The joint version changes whenever one of the sub-models changes
+     */
+    virtual size_t version() const
+    {
+        return expand_version(CreateIndexSequence<sizeof...(Models)>());
+    }
+
 protected:
     /**
      * \brief Contains the points to the sub-models which this joint model
@@ -161,6 +218,41 @@ protected:
 
 private:
     /** \cond INTERNAL */
+    template <int...Indices>
+    bool expand_is_thread_safe(IndexSequence<Indices...>) const
+    {
+        const auto& flags = { std::get<Indices>(models_)->is_thread_safe()... };
+
+        for (auto flag : flags) { if (!flag) return false; }
+
+        return true;
+    }
+
+    template <int...Indices>
+    size_t expand_version(IndexSequence<Indices...>) const
+    {
+        const auto& versions = { std::get<Indices>(models_)->version()... };
+
+        size_t version = 0;
+        for (auto v : versions) { version += v; }
+
+        return version;
+    }
+
+    template <int...Indices>
+    std::shared_ptr<typename Traits<This>::ObservationModelBase>
+    expand_clone(IndexSequence<Indices...>) const
+    {
+        const auto clones =
+            std::make_tuple(worker_instance(std::get<Indices>(models_))...);
+
+        const auto& valid = { bool(std::get<Indices>(clones))... };
+
+        for (auto flag : valid) { if (!flag) return nullptr; }
+
+        return std::make_shared<This>(std::get<Indices>(clones)...);
+    }
+
     template <int...Indices>
     constexpr size_t expand_state_dimension(IndexSequence<Indices...>) const
     {
@@ -237,6 +329,41 @@ private:
                     state_offset + state_dim,
                     noise_offset + noise_dim);
     }
+
+    template <int Size, int k = 0, typename Tuple>
+    void predict_observations(Tuple& models_tuple,
+                              double delta_time,
+                              const Eigen::Ref<const StateMatrix>& states,
+                              const Eigen::Ref<const NoiseMatrix>& noises,
+                              Eigen::Ref<ObservationMatrix> predictions,
+                              const int obsrv_offset = 0,
+                              const int state_offset = 0,
+                              const int noise_offset = 0)
+    {
+        auto&& model = std::get<k>(models_tuple);
+
+        const auto obsrv_dim = model->observation_dimension();
+        const auto state_dim = model->state_dimension();
+        const auto noise_dim = model->noise_dimension();
+
+        model->predict_observations(
+            states.middleRows(state_offset, state_dim),
+            noises.middleRows(noise_offset, noise_dim),
+            delta_time,
+            predictions.middleRows(obsrv_offset, obsrv_dim));
+
+        if (Size == k + 1) return;
+
+        predict_observations<Size, k + (k + 1 < Size ? 1 : 0)>(
+                    models_tuple,
+                    delta_time,
+                    states,
+                    noises,
+                    predictions,
+                    obsrv_offset + obsrv_dim,
+                    state_offset + state_dim,
+                    noise_offset + noise_dim);
+    }
     /** \endcond */
 };
 
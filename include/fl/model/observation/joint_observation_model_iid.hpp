@@ -28,6 +28,7 @@
 
 #include <fl/util/traits.hpp>
 #include <fl/util/meta.hpp>
+#include <fl/util/thread_pool.hpp>
 #include <fl/distribution/gaussian.hpp>
 
 #include <fl/model/observation/observation_model_interface.hpp>
@@ -93,6 +94,13 @@ public:
     typedef typename Traits<This>::State State;
     typedef typename Traits<This>::Noise Noise;
 
+    typedef typename Traits<This>::ObservationModelBase::StateMatrix
+                StateMatrix;
+    typedef typename Traits<This>::ObservationModelBase::NoiseMatrix
+                NoiseMatrix;
+    typedef typename Traits<This>::ObservationModelBase::ObservationMatrix
+                ObservationMatrix;
+
 public:
     explicit JointObservationModel(
             const std::shared_ptr<LocalObservationModel>& local_obsrv_model,
@@ -134,6 +142,33 @@ public:
         return y;
     }
 
+    /**
+     * \copydoc ObservationModelInterface::predict_observations
+     *
+     * The local model predicts the rows of one sub-observation of all
+     * observations at once.
+     */
+    virtual void predict_observations(
+        const Eigen::Ref<const StateMatrix>& states,
+        const Eigen::Ref<const NoiseMatrix>& noises,
+        double delta_time,
+        Eigen::Ref<ObservationMatrix> predictions)
+    {
+        int obsrv_dim = local_obsrv_model_->observation_dimension();
+        int noise_dim = local_obsrv_model_->noise_dimension();
+        int state_dim = local_obsrv_model_->state_dimension();
+
+        const int count = count_;
+        for (int i = 0; i < count; ++i)
+        {
+            local_obsrv_model_->predict_observations(
+                states.middleRows(i * state_dim, state_dim),
+                noises.middleRows(i * noise_dim, noise_dim),
+                delta_time,
+                predictions.middleRows(i * obsrv_dim, obsrv_dim));
+        }
+    }
+
     virtual size_t observation_dimension() const
     {
         return local_obsrv_model_->observation_dimension() * count_;
@@ -149,6 +184,35 @@ public:
         return local_obsrv_model_->noise_dimension() * count_;
     }
 
+    /**
+     * \copydoc ObservationModelInterface::is_thread_safe
+     */
+    virtual bool is_thread_safe() const
+    {
+        return local_obsrv_model_->is_thread_safe();
+    }
+
+    /**
+     * \copydoc ObservationModelInterface::clone
+     */
+    virtual std::shared_ptr<typename Traits<This>::ObservationModelBase>
+    clone() const
+    {
+        auto local_obsrv_model = worker_instance(local_obsrv_model_);
+
+        if (!local_obsrv_model) return nullptr;
+
+        return std::make_shared<This>(local_obsrv_model, count_);
+    }
+
+    /**
+     * \copydoc ObservationModelInterface::version
+     */
+    virtual size_t version() const
+    {
+        return local_obsrv_model_->version();
+    }
+
     const std::shared_ptr<LocalObservationModel>& local_observation_model()
     {
         return local_obsrv_model_;
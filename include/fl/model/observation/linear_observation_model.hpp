@@ -88,6 +88,13 @@ public:
     typedef typename Traits<This>::SecondMoment SecondMoment;
     typedef typename Traits<This>::SensorMatrix SensorMatrix;
 
+    typedef typename Traits<This>::ObservationModelBase::StateMatrix
+                StateMatrix;
+    typedef typename Traits<This>::ObservationModelBase::NoiseMatrix
+                NoiseMatrix;
+    typedef typename Traits<This>::ObservationModelBase::ObservationMatrix
+                ObservationMatrix;
+
     using Traits<This>::GaussianBase::mean;
     using Traits<This>::GaussianBase::covariance;
     using Traits<This>::GaussianBase::dimension;
@@ -122,12 +129,34 @@ public:
         H_ = sensor_matrix;
     }
 
+    /**
+     * \copydoc ObservationModelInterface::predict_observation
+     *
+     * The prediction only reads the model parameters and leaves the
+     * conditional distribution untouched.
+     */
     virtual Observation predict_observation(const State& state,
                                             const Noise& noise,
-                                            double delta_time)
+                                            double)
     {
-        condition(state);
-        return Traits<This>::GaussianBase::map_standard_normal(noise);
+        return H_ * state
+               + Traits<This>::GaussianBase::square_root() * noise;
+    }
+
+    /**
+     * \copydoc ObservationModelInterface::predict_observations
+     *
+     * All observations are predicted by two matrix products.
+     */
+    virtual void predict_observations(
+        const Eigen::Ref<const StateMatrix>& states,
+        const Eigen::Ref<const NoiseMatrix>& noises,
+        double,
+        Eigen::Ref<ObservationMatrix> predictions)
+    {
+        predictions.noalias() = H_ * states;
+        predictions.noalias() +=
+            Traits<This>::GaussianBase::square_root() * noises;
     }
 
     virtual size_t observation_dimension() const
@@ -145,6 +174,27 @@ public:
         return state_dimension_;
     }
 
+    /**
+     * \copydoc ObservationModelInterface::is_thread_safe
+     *
+     * The predictions only read the sensor matrix and the noise square root.
+     * The latter is computed here if it is outdated.
+     */
+    virtual bool is_thread_safe() const
+    {
+        Traits<This>::GaussianBase::square_root();
+
+        return true;
+    }
+
+    /**
+     * \copydoc ObservationModelInterface::clone
+     */
+    virtual std::shared_ptr<typename Traits<This>::ObservationModelBase>
+    clone() const
+    {
+        return std::make_shared<This>(*this);
+    }
 
 protected:
     size_t state_dimension_;
@@ -22,6 +22,9 @@
 #ifndef FL__MODEL__OBSERVATION__OBSERVATION_MODEL_INTERFACE_HPP
 #define FL__MODEL__OBSERVATION__OBSERVATION_MODEL_INTERFACE_HPP
 
+#include <Eigen/Dense>
+
+#include <memory>
 #include <cstdlib>
 
 namespace fl
@@ -33,6 +36,34 @@ namespace fl
 template <typename Observation, typename State, typename Noise, int Id = 0>
 class ObservationModelInterface
 {
+public:
+    /**
+     * \brief Matrix of observations, one observation per column
+     */
+    typedef Eigen::Matrix<
+                typename Observation::Scalar,
+                Observation::RowsAtCompileTime,
+                Eigen::Dynamic
+            > ObservationMatrix;
+
+    /**
+     * \brief Matrix of states, one state per column
+     */
+    typedef Eigen::Matrix<
+                typename State::Scalar,
+                State::RowsAtCompileTime,
+                Eigen::Dynamic
+            > StateMatrix;
+
+    /**
+     * \brief Matrix of noise variates, one variate per column
+     */
+    typedef Eigen::Matrix<
+                typename Noise::Scalar,
+                Noise::RowsAtCompileTime,
+                Eigen::Dynamic
+            > NoiseMatrix;
+
 public:
     /**
      * \param state
@@ -45,11 +76,78 @@ public:
                                             const Noise& noise,
                                             double delta_time) = 0;
 
+    /**
+     * Predicts a batch of observations. The i-th column of \c predictions is
+     * the prediction of the i-th columns of \c states and \c noises. The
+     * default implementation calls predict_observation() for each column.
+     * Models which can process all columns at once should override this.
+     *
+     * \param [in]  states         States, one per column
+     * \param [in]  noises         Noise variates, one per column
+     * \param [in]  delta_time     Time since the last observation
+     * \param [out] predictions    Predicted observations. Must not alias the
+     *                             arguments \c states and \c noises.
+     */
+    virtual void predict_observations(
+        const Eigen::Ref<const StateMatrix>& states,
+        const Eigen::Ref<const NoiseMatrix>& noises,
+        double delta_time,
+        Eigen::Ref<ObservationMatrix> predictions)
+    {
+        for (int i = 0; i < states.cols(); ++i)
+        {
+            predictions.col(i) = predict_observation(states.col(i),
+                                                     noises.col(i),
+                                                     delta_time);
+        }
+    }
+
     virtual size_t state_dimension() const = 0;    
     virtual size_t noise_dimension() const = 0;
     virtual size_t observation_dimension() const = 0;
 
     virtual int id() const { return Id; }
+
+    /**
+     * \return True if predict_observation() may be called concurrently on the
+     *         same instance. Filters evaluating points in parallel use clones
+     *         of models which are not thread safe.
+     *
+     * Filters query this in the calling thread before every parallel
+     * evaluation. Thread safe models may use it to compute lazily evaluated
+     * quantities up front.
+     */
+    virtual bool is_thread_safe() const { return false; }
+
+    /**
+     * \return An independent copy of this model for the use in a separate
+     *         thread or a null pointer if the model cannot be cloned. Derived
+     *         models must override this to return an instance of their own
+     *         type.
+     */
+    virtual std::shared_ptr<ObservationModelInterface> clone() const
+    {
+        return nullptr;
+    }
+
+    /**
+     * \return Number of modifications of the model parameters. Filters compare
+     *         it to the version of their clones in order to replace outdated
+     *         clones. Joint models combine the versions of their sub-models.
+     */
+    virtual size_t version() const { return version_; }
+
+protected:
+    /**
+     * Marks the model parameters as modified. Models which can be cloned
+     * call this from every parameter setter.
+     */
+    void parameters_changed() const noexcept { ++version_; }
+
+protected:
+    /** \cond INTERNAL */
+    mutable size_t version_ = 0;
+    /** \endcond */
 };
 
 /**
@@ -71,6 +169,35 @@ public:
     virtual Observation predict_observation(const State& state,
                                             double delta_time) = 0;
 
+    /**
+     * Predicts a batch of noise free observations. The default implementation
+     * calls predict_observation(const State&, double) for each column.
+     *
+     * \param [in]  states         States, one per column
+     * \param [in]  delta_time     Time since the last observation
+     * \param [out] predictions    Predicted observations. Must not alias
+     *                             \c states.
+     */
+    virtual void predict_observations(
+        const Eigen::Ref<
+            const typename ObservationModelInterface<
+                Observation, State, Noise, Id>::StateMatrix>& states,
+        double delta_time,
+        Eigen::Ref<
+            typename ObservationModelInterface<
+                Observation, State, Noise, Id>::ObservationMatrix> predictions)
+    {
+        for (int i = 0; i < states.cols(); ++i)
+        {
+            predictions.col(i) = predict_observation(states.col(i), delta_time);
+        }
+    }
+
+    using ObservationModelInterface<
+              Observation, State, Noise, Id>::predict_observation;
+    using ObservationModelInterface<
+              Observation, State, Noise, Id>::predict_observations;
+
     virtual Noise noise_covariance_vector() const = 0;
 };
 
@@ -0,0 +1,196 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file continuous_linear_process_model.hpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#ifndef FL__MODEL__PROCESS__CONTINUOUS_LINEAR_PROCESS_MODEL_HPP
+#define FL__MODEL__PROCESS__CONTINUOUS_LINEAR_PROCESS_MODEL_HPP
+
+#include <fl/util/traits.hpp>
+#include <fl/util/math/linear_algebra.hpp>
+#include <fl/distribution/gaussian.hpp>
+#include <fl/model/process/linear_process_model.hpp>
+
+namespace fl
+{
+
+// Forward declarations
+template <typename State, typename Input_>
+class ContinuousLinearGaussianProcessModel;
+
+/**
+ * Continuous-time linear Gaussian process model traits. The model shares all
+ * types with the LinearGaussianProcessModel.
+ */
+template <typename State_, typename Input_>
+struct Traits<ContinuousLinearGaussianProcessModel<State_, Input_>>
+    : Traits<LinearGaussianProcessModel<State_, Input_>>
+{
+    typedef LinearGaussianProcessModel<State_, Input_> LinearModelBase;
+};
+
+/**
+ * \ingroup process_models
+ *
+ * \brief Linear time-invariant process \f$\dot{x} = F x + w\f$ driven by
+ * white noise \f$w\f$ of spectral density \f$Q_c\f$.
+ *
+ * The drift matrix \f$F\f$ is set via A() and the spectral density via
+ * covariance(). In contrast to the LinearGaussianProcessModel, which scales
+ * the matrices by the time step, the process is discretized exactly,
+ *
+ * \f$ x_{t+\Delta t} = \Phi x_t + w_d \f$ with \f$\Phi = e^{F \Delta t}\f$ and
+ * \f$ w_d \sim {\cal N}(0, Q_d) \f$,
+ *
+ * using Van Loan's method. Filters may therefore take large and irregular
+ * time steps. \f$\Phi\f$, \f$Q_d\f$ and the square root of \f$Q_d\f$ are
+ * cached and only recomputed if the time step or the model change.
+ *
+ * The model can be used wherever a LinearGaussianProcessModel is expected,
+ * e.g. by the Kalman filter.
+ */
+template <typename State_, typename Input_ = Eigen::Matrix<double, 1, 1>>
+class ContinuousLinearGaussianProcessModel
+    : public Traits<
+                 ContinuousLinearGaussianProcessModel<State_, Input_>
+             >::LinearModelBase
+{
+public:
+    typedef ContinuousLinearGaussianProcessModel<State_, Input_> This;
+    typedef typename Traits<This>::LinearModelBase Base;
+
+    typedef typename Traits<This>::State State;
+    typedef typename Traits<This>::Input Input;
+    typedef typename Traits<This>::Noise Noise;
+    typedef typename Traits<This>::Scalar Scalar;
+    typedef typename Traits<This>::SecondMoment SecondMoment;
+    typedef typename Traits<This>::DynamicsMatrix DynamicsMatrix;
+
+    typedef typename Base::StateMatrix StateMatrix;
+    typedef typename Base::NoiseMatrix NoiseMatrix;
+
+    using Base::mean;
+    using Base::dimension;
+    using Base::discretized_A;
+
+public:
+    /**
+     * \param noise_density     Spectral density \f$Q_c\f$ of the white noise
+     * \param dimension         State dimension
+     */
+    ContinuousLinearGaussianProcessModel(
+            const SecondMoment& noise_density,
+            const int dimension = DimensionOf<State>())
+        : Base(noise_density, dimension),
+          discretized_noise_(dimension)
+    { }
+
+    /**
+     * \copydoc ProcessModelInterface::predict_state
+     */
+    virtual State predict_state(double delta_time,
+                                const State& state,
+                                const Noise& noise,
+                                const Input& input)
+    {
+        condition(delta_time, state, input);
+
+        return map_standard_normal(noise);
+    }
+
+    virtual void condition(const double& delta_time,
+                           const State& x,
+                           const Input& = Input())
+    {
+        this->delta_time_ = delta_time;
+
+        mean(discretized_A(delta_time) * x);
+    }
+
+    virtual State map_standard_normal(const Noise& sample) const
+    {
+        this->discretize(this->delta_time_);
+
+        return mean() + discretized_noise_.square_root() * sample;
+    }
+
+    /**
+     * \copydoc ProcessModelInterface::predict_states
+     *
+     * All states are predicted by two matrix products.
+     */
+    virtual void predict_states(
+        double delta_time,
+        const Eigen::Ref<const StateMatrix>& states,
+        const Eigen::Ref<const NoiseMatrix>& noises,
+        const Input&,
+        Eigen::Ref<StateMatrix> predictions)
+    {
+        this->delta_time_ = delta_time;
+
+        predictions.noalias() = discretized_A(delta_time) * states;
+        predictions.noalias() += discretized_noise_.square_root() * noises;
+    }
+
+    /**
+     * \copydoc ProcessModelInterface::is_thread_safe
+     *
+     * The discretization is cached per time step, hence the model is not
+     * thread safe. Each worker uses a clone with its own cache.
+     */
+    virtual bool is_thread_safe() const
+    {
+        return false;
+    }
+
+    /**
+     * \copydoc ProcessModelInterface::clone
+     */
+    virtual std::shared_ptr<typename Traits<This>::ProcessModelBase>
+    clone() const
+    {
+        return std::make_shared<This>(*this);
+    }
+
+protected:
+    /** \cond INTERNAL */
+    /**
+     * Computes \f$\Phi\f$ and \f$Q_d\f$ using Van Loan's method
+     */
+    virtual void compute_discretization(double delta_time) const
+    {
+        van_loan_discretization(this->A_,
+                                this->covariance(),
+                                delta_time,
+                                this->discretized_A_,
+                                this->discretized_covariance_);
+
+        discretized_noise_.covariance(this->discretized_covariance_);
+    }
+    /** \endcond */
+
+protected:
+    /** \cond INTERNAL */
+    mutable Gaussian<State> discretized_noise_;
+    /** \endcond */
+};
+
+}
+
+#endif
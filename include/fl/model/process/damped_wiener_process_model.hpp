@@ -100,6 +100,11 @@ public:
     typedef typename Traits<This>::Noise          Noise;
     typedef typename Traits<This>::NoiseGaussian   NoiseGaussian;
 
+    typedef typename Traits<This>::ProcessInterfaceBase::StateMatrix
+                StateMatrix;
+    typedef typename Traits<This>::ProcessInterfaceBase::NoiseMatrix
+                NoiseMatrix;
+
 public:
 
     /**
@@ -113,7 +118,8 @@ public:
     explicit
     DampedWienerProcessModel(size_t dim = DimensionOf<State>())
         : Traits<This>::GaussianMappingBase(dim),
-          gaussian_(dim)
+          gaussian_(dim),
+          discretization_valid_(false)
     {
         static_assert(IsDynamic<State::SizeAtCompileTime>() ||
                       DimensionOf<State>() > 0,
@@ -144,8 +150,9 @@ public:
                            const State&  state,
                            const Input&   input)
     {
+        discretize(delta_time);
+
         gaussian_.mean(mean(delta_time, state, input));
-        gaussian_.diagonal_covariance(covariance(delta_time));
     }
 
 
@@ -163,11 +170,54 @@ public:
         return map_standard_normal(noise);
     }
 
+    /**
+     * \copydoc ProcessModelInterface::predict_states
+     *
+     * The noise covariance and its square root are computed once for all
+     * states and reused in subsequent steps with the same time step.
+     */
+    virtual void predict_states(
+        double delta_time,
+        const Eigen::Ref<const StateMatrix>& states,
+        const Eigen::Ref<const NoiseMatrix>& noises,
+        const Input& input,
+        Eigen::Ref<StateMatrix> predictions)
+    {
+        discretize(delta_time);
+
+        const double dt = delta_time;
+        const Scalar d = damping_;
+
+        if (d == 0)
+        {
+            predictions = states;
+            predictions.colwise() += dt * input;
+        }
+        else
+        {
+            predictions = transition_factor_ * states;
+            predictions.colwise() += input_factor_ * input;
+
+            for (int i = 0; i < predictions.cols(); ++i)
+            {
+                // same limit for damping_ -> 0 as in mean()
+                if (!std::isfinite(predictions.col(i).norm()))
+                {
+                    predictions.col(i) = states.col(i) + d * input;
+                }
+            }
+        }
+
+        predictions.noalias() += gaussian_.square_root() * noises;
+    }
+
     virtual void parameters(const Scalar& damping,
                             const SecondMoment& noise_covariance)
     {
         damping_ = damping;
         noise_covariance_ = noise_covariance;
+        discretization_valid_ = false;
+        this->parameters_changed();
     }
 
     /**
@@ -205,6 +255,15 @@ public:
         return this->standard_variate_dimension();
     }
 
+    /**
+     * \copydoc ProcessModelInterface::clone
+     */
+    virtual std::shared_ptr<typename Traits<This>::ProcessInterfaceBase>
+    clone() const
+    {
+        return std::make_shared<This>(*this);
+    }
+
 protected:
     /**
      * \param delta_time    \f$\Delta t\f$
@@ -220,14 +279,15 @@ protected:
                const State& state,
                const Input& input)
     {
+        discretize(delta_time);
+
         // for readability ... the compiler optimizes this out
-        const double dt = delta_time;
         const Scalar d = damping_;
-        const double exp_ddt = std::exp(-d * dt);
 
         if(d == 0) return state + delta_time * input;
 
-        State state_expectation = (1.0 - exp_ddt) / d * input + exp_ddt * state;
+        State state_expectation =
+            input_factor_ * input + transition_factor_ * state;
 
         /*
          * if the damping_ is too small, the result might be nan, we thus return
@@ -273,6 +333,36 @@ protected:
         return factor * noise_covariance_;
     }
 
+    /**
+     * Discretizes the process for the given time step, i.e. computes the
+     * transition factor \f$e^{-\Delta t d}\f$, the input factor
+     * \f$\frac{1-e^{-\Delta t d}}{d}\f$ and the noise covariance. The
+     * results are kept until the time step or the parameters change. Hence,
+     * all points of a filter step as well as consecutive steps at a constant
+     * rate share the transcendental functions and the square root of the
+     * noise covariance.
+     *
+     * \param delta_time    \f$\Delta t\f$
+     */
+    void discretize(const Scalar& delta_time)
+    {
+        if (discretization_valid_ && delta_time == discretized_delta_time_)
+        {
+            return;
+        }
+
+        const double dt = delta_time;
+        const Scalar d = damping_;
+
+        transition_factor_ = std::exp(-d * dt);
+        input_factor_ = (1.0 - transition_factor_) / d;
+
+        gaussian_.diagonal_covariance(covariance(delta_time));
+
+        discretized_delta_time_ = delta_time;
+        discretization_valid_ = true;
+    }
+
 private:
     // conditional
     NoiseGaussian gaussian_;
@@ -280,6 +370,12 @@ private:
     // parameters
     Scalar damping_;
     SecondMoment noise_covariance_;
+
+    // discretization of the last time step
+    bool discretization_valid_;
+    Scalar discretized_delta_time_;
+    Scalar transition_factor_;
+    Scalar input_factor_;
 };
 
 }
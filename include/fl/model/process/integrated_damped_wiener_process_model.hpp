@@ -140,7 +140,8 @@ public:
     IntegratedDampedWienerProcessModel(int dof = Traits<This>::DegreeOfFreedom)
         : Traits<This>::GaussianMappingBase(dof),
           velocity_distribution_(dof),
-          position_distribution_(dof)
+          position_distribution_(dof),
+          discretization_valid_(false)
     {
         static_assert(IsDynamic<State::SizeAtCompileTime>() ||
                       DimensionOf<State>() > 0,
@@ -183,14 +184,14 @@ public:
                            const State& state,
                            const Input& input)
     {
+        discretize(delta_time);
+
         position_distribution_.mean(
             mean(state.topRows(position_distribution_.dimension()),
                  state.bottomRows(velocity_distribution_.dimension()),
                  input,
                  delta_time));
 
-        position_distribution_.covariance(covariance(delta_time));
-
         velocity_distribution_.condition(
             delta_time,
             state.bottomRows(velocity_distribution_.dimension()),
@@ -242,14 +243,25 @@ public:
         return this->standard_variate_dimension();
     }
 
+    /**
+     * \copydoc ProcessModelInterface::clone
+     */
+    virtual std::shared_ptr<typename Traits<This>::ProcessInterfaceBase>
+    clone() const
+    {
+        return std::make_shared<This>(*this);
+    }
+
     virtual void parameters(
             const double& damping,
             const SecondMoment& acceleration_covariance)
     {
         damping_ = damping;
         acceleration_covariance_ = acceleration_covariance;
+        discretization_valid_ = false;
 
         velocity_distribution_.parameters(damping, acceleration_covariance);
+        this->parameters_changed();
     }
 
 protected:
@@ -273,23 +285,13 @@ protected:
                const Input& acceleration,
                const double& delta_time)
     {
-        Input mean;
+        discretize(delta_time);
 
-        // for readability ... the compiler optimizes this out
-        const double dt = delta_time;
-        const Scalar d = damping_;
-        const double exp_ddt = std::exp(-d * dt);
+        Input mean;
 
         mean = position
-                + (exp_ddt + d * dt - 1.0) / std::pow(d, 2) * acceleration
-                + (1.0 - exp_ddt) / d  * velocity;
-
-        if(!std::isfinite(mean.norm()))
-        {
-            mean = position
-                    + 0.5 * std::pow(dt, 2) * acceleration
-                    + dt * velocity;
-        }
+                + acceleration_factor_ * acceleration
+                + velocity_factor_ * velocity;
 
         return mean;
     }
@@ -341,6 +343,45 @@ protected:
         return factor * acceleration_covariance_;
     }
 
+    /**
+     * Discretizes the process for the given time step, i.e. computes the
+     * acceleration factor \f$\frac{e^{-\Delta t d} + d\Delta t - 1}{d^2}\f$,
+     * the velocity factor \f$\frac{1-e^{-\Delta t d}}{d}\f$ and the
+     * position covariance. Both factors fall back to their limits
+     * \f$\frac{1}{2}\Delta t^2\f$ and \f$\Delta t\f$ for
+     * \f$d \rightarrow 0\f$. The results are kept until the time step or
+     * the parameters change.
+     *
+     * \param delta_time    \f$\Delta t\f$
+     */
+    void discretize(const Scalar& delta_time)
+    {
+        if (discretization_valid_ && delta_time == discretized_delta_time_)
+        {
+            return;
+        }
+
+        // for readability ... the compiler optimizes this out
+        const double dt = delta_time;
+        const Scalar d = damping_;
+        const double exp_ddt = std::exp(-d * dt);
+
+        acceleration_factor_ = (exp_ddt + d * dt - 1.0) / std::pow(d, 2);
+        velocity_factor_ = (1.0 - exp_ddt) / d;
+
+        if (!std::isfinite(acceleration_factor_) ||
+            !std::isfinite(velocity_factor_))
+        {
+            acceleration_factor_ = 0.5 * std::pow(dt, 2);
+            velocity_factor_ = dt;
+        }
+
+        position_distribution_.covariance(covariance(delta_time));
+
+        discretized_delta_time_ = delta_time;
+        discretization_valid_ = true;
+    }
+
 private:
     DampedWienerProcess velocity_distribution_;
     NoiseGaussian position_distribution_;
@@ -348,6 +389,12 @@ private:
     // model parameters
     Scalar damping_;
     SecondMoment acceleration_covariance_;
+
+    // discretization of the last time step
+    bool discretization_valid_;
+    Scalar discretized_delta_time_;
+    Scalar acceleration_factor_;
+    Scalar velocity_factor_;
 };
 
 }
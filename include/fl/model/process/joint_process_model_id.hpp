@@ -29,6 +29,7 @@
 
 #include <fl/util/traits.hpp>
 #include <fl/util/meta.hpp>
+#include <fl/util/thread_pool.hpp>
 
 #include <fl/model/process/process_model_interface.hpp>
 
@@ -84,6 +85,9 @@ public:
     typedef typename Traits<This>::Noise Noise;
     typedef typename Traits<This>::Input Input;
 
+    typedef typename Traits<This>::ProcessModelBase::StateMatrix StateMatrix;
+    typedef typename Traits<This>::ProcessModelBase::NoiseMatrix NoiseMatrix;
+
 public:
     /**
      * Constructor a JointProcessModel which is a composition of mixture of
@@ -117,6 +121,27 @@ public:
         return prediction;
     }
 
+    /**
+     * \copydoc ProcessModelInterface::predict_states
+     *
+     * Each sub-model predicts its block of rows of all states at once.
+     */
+    virtual void predict_states(
+        double delta_time,
+        const Eigen::Ref<const StateMatrix>& states,
+        const Eigen::Ref<const NoiseMatrix>& noises,
+        const Input& input,
+        Eigen::Ref<StateMatrix> predictions)
+    {
+        predict_states<sizeof...(Models)>(
+            models_,
+            delta_time,
+            states,
+            noises,
+            input,
+            predictions);
+    }
+
     /**
      * \brief Overridable default destructor
      */
@@ -152,6 +177,37 @@ public:
         return expand_input_dimension(CreateIndexSequence<sizeof...(Models)>());
     }
 
+    /**
+     * \copydoc ProcessModelInterface::is_thread_safe
+     *
+     * The joint model is thread safe if all sub-models are thread safe
+     */
+    virtual bool is_thread_safe() const
+    {
+        return expand_is_thread_safe(CreateIndexSequence<sizeof...(Models)>());
+    }
+
+    /**
+     * \copydoc ProcessModelInterface::clone
+     *
+     * The clone shares the thread safe sub-models and uses clones of all
+     * others.
+     */
+    virtual std::shared_ptr<typename Traits<This>::ProcessModelBase> clone() const
+    {
+        return expand_clone(CreateIndexSequence<sizeof...(Models)>());
+    }
+
+    /**
+     * \copydoc ProcessModelInterface::version
+     *
+     * The joint version changes whenever one of the sub-models changes
+     */
+    virtual size_t version() const
+    {
+        return expand_version(CreateIndexSequence<sizeof...(Models)>());
+    }
+
 protected:
     /**
      * \brief Contains the points to the sub-models which this joint model
@@ -162,6 +218,41 @@ protected:
 
 private:
     /** \cond INTERNAL */
+    template <int...Indices>
+    bool expand_is_thread_safe(IndexSequence<Indices...>) const
+    {
+        const auto& flags = { std::get<Indices>(models_)->is_thread_safe()... };
+
+        for (auto flag : flags) { if (!flag) return false; }
+
+        return true;
+    }
+
+    template <int...Indices>
+    size_t expand_version(IndexSequence<Indices...>) const
+    {
+        const auto& versions = { std::get<Indices>(models_)->version()... };
+
+        size_t version = 0;
+        for (auto v : versions) { version += v; }
+
+        return version;
+    }
+
+    template <int...Indices>
+    std::shared_ptr<typename Traits<This>::ProcessModelBase>
+    expand_clone(IndexSequence<Indices...>) const
+    {
+        const auto clones =
+            std::make_tuple(worker_instance(std::get<Indices>(models_))...);
+
+        const auto& valid = { bool(std::get<Indices>(clones))... };
+
+        for (auto flag : valid) { if (!flag) return nullptr; }
+
+        return std::make_shared<This>(std::get<Indices>(clones)...);
+    }
+
     template <int...Indices>
     constexpr size_t expand_state_dimension(IndexSequence<Indices...>) const
     {        
@@ -240,6 +331,44 @@ private:
                     noise_offset + noise_dim,
                     input_offset + input_dim);
     }
+
+    template <int Size, int k = 0, typename Tuple>
+    void predict_states(Tuple& models_tuple,
+                        double delta_time,
+                        const Eigen::Ref<const StateMatrix>& states,
+                        const Eigen::Ref<const NoiseMatrix>& noises,
+                        const Input& input,
+                        Eigen::Ref<StateMatrix> predictions,
+                        const int state_offset = 0,
+                        const int noise_offset = 0,
+                        const int input_offset = 0)
+    {
+        auto&& model = std::get<k>(models_tuple);
+
+        const auto state_dim = model->state_dimension();
+        const auto noise_dim = model->noise_dimension();
+        const auto input_dim = model->input_dimension();
+
+        model->predict_states(
+            delta_time,
+            states.middleRows(state_offset, state_dim),
+            noises.middleRows(noise_offset, noise_dim),
+            input.middleRows(input_offset, input_dim),
+            predictions.middleRows(state_offset, state_dim));
+
+        if (Size == k + 1) return;
+
+        predict_states<Size, k + (k + 1 < Size ? 1 : 0)>(
+                    models_tuple,
+                    delta_time,
+                    states,
+                    noises,
+                    input,
+                    predictions,
+                    state_offset + state_dim,
+                    noise_offset + noise_dim,
+                    input_offset + input_dim);
+    }
     /** \endcond */
 };
 
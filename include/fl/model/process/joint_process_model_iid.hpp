@@ -28,6 +28,7 @@
 
 #include <fl/util/traits.hpp>
 #include <fl/util/meta.hpp>
+#include <fl/util/thread_pool.hpp>
 
 #include <fl/model/process/process_model_interface.hpp>
 
@@ -95,6 +96,9 @@ public:
     typedef typename Traits<This>::Noise Noise;
     typedef typename Traits<This>::Input Input;
 
+    typedef typename Traits<This>::ProcessModelBase::StateMatrix StateMatrix;
+    typedef typename Traits<This>::ProcessModelBase::NoiseMatrix NoiseMatrix;
+
 public:
     explicit JointProcessModel(
             const std::shared_ptr<LocalProcessModel>& local_process_model,
@@ -131,6 +135,34 @@ public:
         return x;
     }
 
+    /**
+     * \copydoc ProcessModelInterface::predict_states
+     *
+     * The local model predicts the rows of one sub-state of all states at
+     * once.
+     */
+    virtual void predict_states(
+        double delta_time,
+        const Eigen::Ref<const StateMatrix>& states,
+        const Eigen::Ref<const NoiseMatrix>& noises,
+        const Input& input,
+        Eigen::Ref<StateMatrix> predictions)
+    {
+        int state_dim = local_process_model_->state_dimension();
+        int noise_dim = local_process_model_->noise_dimension();
+        int input_dim = local_process_model_->input_dimension();
+
+        for (int i = 0; i < count_; ++i)
+        {
+            local_process_model_->predict_states(
+                delta_time,
+                states.middleRows(i * state_dim, state_dim),
+                noises.middleRows(i * noise_dim, noise_dim),
+                input.middleRows(i * input_dim, input_dim),
+                predictions.middleRows(i * state_dim, state_dim));
+        }
+    }
+
     virtual size_t state_dimension() const
     {
         return local_process_model_->state_dimension() * count_;
@@ -146,6 +178,35 @@ public:
         return local_process_model_->input_dimension() * count_;
     }
 
+    /**
+     * \copydoc ProcessModelInterface::is_thread_safe
+     */
+    virtual bool is_thread_safe() const
+    {
+        return local_process_model_->is_thread_safe();
+    }
+
+    /**
+     * \copydoc ProcessModelInterface::clone
+     */
+    virtual std::shared_ptr<typename Traits<This>::ProcessModelBase>
+    clone() const
+    {
+        auto local_process_model = worker_instance(local_process_model_);
+
+        if (!local_process_model) return nullptr;
+
+        return std::make_shared<This>(local_process_model, count_);
+    }
+
+    /**
+     * \copydoc ProcessModelInterface::version
+     */
+    virtual size_t version() const
+    {
+        return local_process_model_->version();
+    }
+
     const std::shared_ptr<LocalProcessModel>& local_process_model()
     {
         return local_process_model_;
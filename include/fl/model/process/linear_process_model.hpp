@@ -79,6 +79,9 @@ public:
     typedef typename Traits<This>::SecondMoment SecondMoment;
     typedef typename Traits<This>::DynamicsMatrix DynamicsMatrix;
 
+    typedef typename Traits<This>::ProcessModelBase::StateMatrix StateMatrix;
+    typedef typename Traits<This>::ProcessModelBase::NoiseMatrix NoiseMatrix;
+
     using Traits<This>::GaussianBase::mean;
     using Traits<This>::GaussianBase::covariance;
     using Traits<This>::GaussianBase::dimension;
@@ -90,7 +93,8 @@ public:
             const int dimension = DimensionOf<State>()):
         Traits<This>::GaussianBase(dimension),
         A_(DynamicsMatrix::Identity(dimension, dimension)),
-        delta_time_(1.)
+        delta_time_(1.),
+        discretization_valid_(false)
     {
         assert(dimension > 0);
 
@@ -99,14 +103,34 @@ public:
 
     ~LinearGaussianProcessModel() { }        
 
+    /**
+     * \copydoc ProcessModelInterface::predict_state
+     *
+     * The prediction only reads the model parameters and leaves the
+     * conditional distribution untouched.
+     */
     virtual State predict_state(double delta_time,
                                 const State& state,
                                 const Noise& noise,
-                                const Input& input)
+                                const Input&)
     {
-        condition(delta_time, state, input);
+        return A_ * state + delta_time * (square_root() * noise);
+    }
 
-        return map_standard_normal(noise);
+    /**
+     * \copydoc ProcessModelInterface::predict_states
+     *
+     * All states are predicted by two matrix products.
+     */
+    virtual void predict_states(
+        double delta_time,
+        const Eigen::Ref<const StateMatrix>& states,
+        const Eigen::Ref<const NoiseMatrix>& noises,
+        const Input&,
+        Eigen::Ref<StateMatrix> predictions)
+    {
+        predictions.noalias() = A_ * states;
+        predictions.noalias() += delta_time * (square_root() * noises);
     }
 
     virtual size_t state_dimension() const
@@ -124,6 +148,28 @@ public:
         return DimensionOf<Input>();
     }
 
+    /**
+     * \copydoc ProcessModelInterface::is_thread_safe
+     *
+     * The predictions only read the dynamics matrix and the noise square
+     * root. The latter is computed here if it is outdated.
+     */
+    virtual bool is_thread_safe() const
+    {
+        square_root();
+
+        return true;
+    }
+
+    /**
+     * \copydoc ProcessModelInterface::clone
+     */
+    virtual std::shared_ptr<typename Traits<This>::ProcessModelBase>
+    clone() const
+    {
+        return std::make_shared<This>(*this);
+    }
+
     virtual void condition(const double& delta_time,
                            const State& x,
                            const Input& u = Input())
@@ -146,11 +192,139 @@ public:
     virtual void A(const DynamicsMatrix& dynamics_matrix)
     {
         A_ = dynamics_matrix;
+        discretization_valid_ = false;
+        this->parameters_changed();
+    }
+
+    /**
+     * \return Dynamics matrix scaled by the time step \f$A \Delta t\f$ as
+     *         used by the Kalman filter. The product is cached and only
+     *         recomputed if the time step or the dynamics matrix change.
+     *
+     * \param delta_time    \f$\Delta t\f$
+     */
+    virtual const DynamicsMatrix& discretized_A(double delta_time) const
+    {
+        discretize(delta_time);
+
+        return discretized_A_;
+    }
+
+    /**
+     * \return Noise covariance scaled by the time step \f$Q \Delta t\f$ as
+     *         used by the Kalman filter. The product is cached and only
+     *         recomputed if the time step or the covariance change.
+     *
+     * \param delta_time    \f$\Delta t\f$
+     */
+    virtual const SecondMoment& discretized_covariance(double delta_time) const
+    {
+        discretize(delta_time);
+
+        return discretized_covariance_;
+    }
+
+    /**
+     * Computes the transition and noise covariance of several consecutive
+     * steps of the same length at once, e.g. to skip missing measurements.
+     * The composition
+     *
+     * \f$ A_{2k} = A_k^2 \f$, \f$ Q_{2k} = A_k Q_k A_k^T + Q_k \f$
+     *
+     * is evaluated by repeated squaring with \f$O(\log k)\f$ matrix products.
+     *
+     * \param [in]  delta_time  Length \f$\Delta t\f$ of a single step
+     * \param [in]  steps       Number of steps \f$k\f$
+     * \param [out] A           Transition of the \f$k\f$ steps
+     * \param [out] Q           Noise covariance of the \f$k\f$ steps
+     */
+    virtual void fast_forward(double delta_time,
+                              size_t steps,
+                              DynamicsMatrix& A,
+                              SecondMoment& Q) const
+    {
+        const int dim = dimension();
+
+        DynamicsMatrix A_power = discretized_A(delta_time);
+        SecondMoment Q_power = discretized_covariance(delta_time);
+
+        A = DynamicsMatrix::Identity(dim, dim);
+        Q = SecondMoment::Zero(dim, dim);
+
+        while (steps > 0)
+        {
+            if (steps & 1)
+            {
+                Q = (A_power * Q * A_power.transpose() + Q_power).eval();
+                A = (A_power * A).eval();
+            }
+
+            steps >>= 1;
+
+            if (steps > 0)
+            {
+                Q_power = (A_power * Q_power * A_power.transpose()
+                           + Q_power).eval();
+                A_power = (A_power * A_power).eval();
+            }
+        }
+    }
+
+protected:
+    /** \cond INTERNAL */
+    typedef typename Traits<This>::GaussianBase::Attribute Attribute;
+
+    /**
+     * Invalidates the discretization cache whenever the noise covariance is
+     * set in any of its representations.
+     */
+    virtual void updated_externally(Attribute attribute) const noexcept
+    {
+        Traits<This>::GaussianBase::updated_externally(attribute);
+
+        discretization_valid_ = false;
+        this->parameters_changed();
+    }
+
+    /**
+     * Updates the cached discretized dynamics and noise covariance if the
+     * time step differs from the cached one
+     */
+    void discretize(double delta_time) const
+    {
+        if (discretization_valid_ && delta_time == discretized_delta_time_)
+        {
+            return;
+        }
+
+        compute_discretization(delta_time);
+
+        discretized_delta_time_ = delta_time;
+        discretization_valid_ = true;
+    }
+
+    /**
+     * Computes the discretized dynamics and noise covariance of the given
+     * time step into the cache. Models with a different discretization
+     * override this function.
+     */
+    virtual void compute_discretization(double delta_time) const
+    {
+        discretized_A_ = A_ * delta_time;
+        discretized_covariance_ = covariance() * delta_time;
     }
+    /** \endcond */
 
 protected:
     DynamicsMatrix A_;
-    double delta_time_;    
+    double delta_time_;
+
+    /** \cond INTERNAL */
+    mutable bool discretization_valid_;
+    mutable double discretized_delta_time_;
+    mutable DynamicsMatrix discretized_A_;
+    mutable SecondMoment discretized_covariance_;
+    /** \endcond */
 };
 
 }
@@ -22,6 +22,7 @@
 #ifndef FL__MODEL__PROCESS__PROCESS_MODEL_INTERFACE_HPP
 #define FL__MODEL__PROCESS__PROCESS_MODEL_INTERFACE_HPP
 
+#include <memory>
 #include <cstddef>
 #include <fl/util/traits.hpp>
 
@@ -42,6 +43,25 @@ namespace fl
 template <typename State, typename Noise, typename Input = internal::Empty>
 class ProcessModelInterface
 {
+public:
+    /**
+     * \brief Matrix of states, one state per column
+     */
+    typedef Eigen::Matrix<
+                typename State::Scalar,
+                State::RowsAtCompileTime,
+                Eigen::Dynamic
+            > StateMatrix;
+
+    /**
+     * \brief Matrix of noise variates, one variate per column
+     */
+    typedef Eigen::Matrix<
+                typename Noise::Scalar,
+                Noise::RowsAtCompileTime,
+                Eigen::Dynamic
+            > NoiseMatrix;
+
 public:
     /**
      * Sets the conditional arguments \f$x_t, u_t\f$ of \f$p(x\mid x_t, u_t)\f$
@@ -74,6 +94,35 @@ public:
                                 const Noise& noise,
                                 const Input& input) = 0;
 
+    /**
+     * Predicts a batch of states given the same input. The i-th column of
+     * \c predictions is the prediction of the i-th columns of \c states and
+     * \c noises. The default implementation calls predict_state() for each
+     * column. Models which can process all columns at once, e.g. by a single
+     * matrix product, should override this.
+     *
+     * \param [in]  delta_time     Prediction duration \f$\Delta t\f$
+     * \param [in]  states         Previous states, one per column
+     * \param [in]  noises         Noise variates, one per column
+     * \param [in]  input          Control input \f$u_t\f$
+     * \param [out] predictions    Predicted states. Must not alias the
+     *                             arguments \c states and \c noises.
+     */
+    virtual void predict_states(double delta_time,
+                                const Eigen::Ref<const StateMatrix>& states,
+                                const Eigen::Ref<const NoiseMatrix>& noises,
+                                const Input& input,
+                                Eigen::Ref<StateMatrix> predictions)
+    {
+        for (int i = 0; i < states.cols(); ++i)
+        {
+            predictions.col(i) = predict_state(delta_time,
+                                               states.col(i),
+                                               noises.col(i),
+                                               input);
+        }
+    }
+
     /**
      * \return \f$\dim(x_t)\f$, dimension of the state
      */
@@ -88,6 +137,47 @@ public:
      * \return \f$\dim(u_t)\f$, dimension of the control input
      */
     virtual constexpr size_t input_dimension() const = 0;
+
+    /**
+     * \return True if predict_state() may be called concurrently on the same
+     *         instance. Filters evaluating points in parallel use clones of
+     *         models which are not thread safe.
+     *
+     * Filters query this in the calling thread before every parallel
+     * evaluation. Thread safe models may use it to compute lazily evaluated
+     * quantities up front.
+     */
+    virtual bool is_thread_safe() const { return false; }
+
+    /**
+     * \return An independent copy of this model for the use in a separate
+     *         thread or a null pointer if the model cannot be cloned. Derived
+     *         models must override this to return an instance of their own
+     *         type.
+     */
+    virtual std::shared_ptr<ProcessModelInterface> clone() const
+    {
+        return nullptr;
+    }
+
+    /**
+     * \return Number of modifications of the model parameters. Filters compare
+     *         it to the version of their clones in order to replace outdated
+     *         clones. Joint models combine the versions of their sub-models.
+     */
+    virtual size_t version() const { return version_; }
+
+protected:
+    /**
+     * Marks the model parameters as modified. Models which can be cloned
+     * call this from every parameter setter.
+     */
+    void parameters_changed() const noexcept { ++version_; }
+
+protected:
+    /** \cond INTERNAL */
+    mutable size_t version_ = 0;
+    /** \endcond */
 };
 
 }
@@ -55,7 +55,7 @@ class DiscreteDistribution
 {
 public:
     template <typename T> DiscreteDistribution(std::vector<T> log_prob)
-        : generator_(RANDOM_SEED),
+        : generator_(fl::seed(), fl::next_stream()),
           uniform_distribution_(0., 1.)
     {
         // substract max to avoid numerical issues
@@ -113,7 +113,7 @@ public:
 private:
     std::vector<double> cumulative_prob_;
 
-    fl::mt11213b generator_;
+    fl::Philox4x32 generator_;
     std::uniform_real_distribution<double> uniform_distribution_;
 };
 
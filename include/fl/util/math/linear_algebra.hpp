@@ -280,6 +280,194 @@ void sqrt_diagonal_vector(const RegularMatrix& regular_matrix,
     }
 }
 
+/**
+ * \ingroup linear_algebra
+ *
+ * Performs the rank-1 update \f$ L L^T + w x x^T \f$ of the lower triangular
+ * Cholesky factor \f$L\f$ in place. A negative weight \f$w\f$ performs a
+ * downdate. The update applies one Givens rotation, the downdate one
+ * hyperbolic rotation per column which costs \f$O(n^2)\f$ instead of the
+ * \f$O(n^3)\f$ of a refactorization.
+ *
+ * \param [in,out] L   Lower triangular Cholesky factor. Only the lower
+ *                     triangular part is accessed.
+ * \param [in]     x   Update vector
+ * \param [in]     w   Weight of the update vector
+ *
+ * \return False if the downdated matrix is not positive definite. In this
+ *         case \f$L\f$ is left in an unspecified state.
+ */
+template <typename FactorMatrix, typename Vector>
+bool cholesky_update(FactorMatrix& L,
+                     const Eigen::MatrixBase<Vector>& x,
+                     double w)
+{
+    typedef typename FactorMatrix::Scalar Scalar;
+
+    const int dim = L.rows();
+    const bool downdate = w < 0.;
+
+    Eigen::Matrix<
+        Scalar,
+        FactorMatrix::RowsAtCompileTime, 1,
+        Eigen::ColMajor,
+        FactorMatrix::MaxRowsAtCompileTime, 1
+    > v = std::sqrt(std::abs(w)) * x;
+
+    for (int k = 0; k < dim; ++k)
+    {
+        if (v(k) == Scalar(0)) continue;
+
+        const Scalar l_kk = L(k, k);
+        const Scalar r2 = downdate ? l_kk * l_kk - v(k) * v(k)
+                                   : l_kk * l_kk + v(k) * v(k);
+
+        if (!(r2 > Scalar(0))) return false;
+
+        const Scalar r = std::sqrt(r2);
+        const Scalar c = l_kk / r;
+        const Scalar s = v(k) / r;
+
+        L(k, k) = r;
+
+        for (int i = k + 1; i < dim; ++i)
+        {
+            const Scalar l_ik = L(i, k);
+
+            if (downdate)
+            {
+                L(i, k) = c * l_ik - s * v(i);
+                v(i) = c * v(i) - s * l_ik;
+            }
+            else
+            {
+                L(i, k) = c * l_ik + s * v(i);
+                v(i) = c * v(i) - s * l_ik;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * \ingroup linear_algebra
+ *
+ * Computes the matrix exponential \f$e^A\f$ by the diagonal Padé
+ * approximation of degree 6 with scaling and squaring. \f$A\f$ is scaled by
+ * \f$2^{-s}\f$ such that \f$\|2^{-s}A\|_\infty \le \frac{1}{2}\f$ which
+ * bounds the relative approximation error below the double precision. The
+ * result is squared \f$s\f$ times afterwards.
+ *
+ * \param A     Square matrix
+ *
+ * \return \f$e^A\f$
+ */
+template <typename Matrix>
+typename Matrix::PlainObject
+matrix_exponential(const Eigen::MatrixBase<Matrix>& A)
+{
+    typedef typename Matrix::PlainObject Result;
+    typedef typename Matrix::Scalar Scalar;
+
+    const int dim = A.rows();
+    const int degree = 6;
+
+    int s = 0;
+    if (dim > 0)
+    {
+        const Scalar norm = A.cwiseAbs().rowwise().sum().maxCoeff();
+        if (norm > Scalar(0.5))
+        {
+            s = int(std::ceil(std::log2(norm / Scalar(0.5))));
+        }
+    }
+
+    const Result X = A * std::ldexp(Scalar(1), -s);
+
+    Result N = Result::Identity(dim, dim);
+    Result D = Result::Identity(dim, dim);
+    Result X_k = Result::Identity(dim, dim);
+
+    Scalar c = 1;
+    for (int k = 1; k <= degree; ++k)
+    {
+        c *= Scalar(degree - k + 1) / Scalar(k * (2 * degree - k + 1));
+        X_k = (X_k * X).eval();
+
+        N += c * X_k;
+        D += (k % 2 ? -c : c) * X_k;
+    }
+
+    Result E = D.partialPivLu().solve(N);
+
+    for (int i = 0; i < s; ++i)
+    {
+        E = (E * E).eval();
+    }
+
+    return E;
+}
+
+/**
+ * \ingroup linear_algebra
+ *
+ * Discretizes the continuous-time linear system
+ * \f$\dot{x} = F x + w\f$ with white noise of spectral density \f$Q_c\f$
+ * exactly for the time step \f$\Delta t\f$ using Van Loan's method. The
+ * matrix exponential
+ *
+ * \f$
+ *  \exp\left(\begin{pmatrix} -F & Q_c \\
+ *                            0  & F^T \end{pmatrix} \Delta t\right) =
+ *  \begin{pmatrix} \cdot & \Phi^{-1} Q_d \\
+ *                  0     & \Phi^T \end{pmatrix}
+ * \f$
+ *
+ * yields the transition matrix \f$\Phi = e^{F \Delta t}\f$ and the noise
+ * covariance \f$Q_d = \int_0^{\Delta t} e^{F \tau} Q_c e^{F^T \tau}
+ * d\tau\f$ at once.
+ *
+ * \param [in]  F           Drift matrix \f$F\f$
+ * \param [in]  Q_c         Noise spectral density \f$Q_c\f$
+ * \param [in]  delta_time  \f$\Delta t\f$
+ * \param [out] Phi         Transition matrix \f$\Phi\f$
+ * \param [out] Q_d         Discrete noise covariance \f$Q_d\f$
+ */
+template <typename DriftMatrix,
+          typename DensityMatrix,
+          typename TransitionMatrix,
+          typename CovarianceMatrix>
+void van_loan_discretization(const DriftMatrix& F,
+                             const DensityMatrix& Q_c,
+                             double delta_time,
+                             TransitionMatrix& Phi,
+                             CovarianceMatrix& Q_d)
+{
+    enum
+    {
+        Dim = DriftMatrix::RowsAtCompileTime,
+        BlockDim = Dim == Eigen::Dynamic ? Eigen::Dynamic : 2 * Dim
+    };
+
+    typedef Eigen::Matrix<
+                typename DriftMatrix::Scalar, BlockDim, BlockDim
+            > BlockMatrix;
+
+    const int dim = F.rows();
+
+    BlockMatrix M = BlockMatrix::Zero(2 * dim, 2 * dim);
+    M.topLeftCorner(dim, dim) = -delta_time * F;
+    M.topRightCorner(dim, dim) = delta_time * Q_c;
+    M.bottomRightCorner(dim, dim) = delta_time * F.transpose();
+
+    const BlockMatrix E = matrix_exponential(M);
+
+    Phi = E.bottomRightCorner(dim, dim).transpose();
+    Q_d = Phi * E.topRightCorner(dim, dim);
+    Q_d = (0.5 * (Q_d + Q_d.transpose())).eval();
+}
+
 /**
  * \ingroup linear_algebra
  *
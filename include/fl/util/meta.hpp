@@ -129,6 +129,29 @@ template <typename First, typename...T> struct FirstTypeIn<First, T...>
     typedef First Type;
 };
 
+/**
+ * \ingroup meta
+ *
+ * Provides the matrix type holding up to \c MaxCount points of type \c Point
+ * column-wise. If \c MaxCount and the point dimension are fixed, the matrix is
+ * stored in place with a dynamic number of columns and resizing it never
+ * allocates memory.
+ */
+template <typename Point, int MaxCount>
+struct PointMatrixOf
+{
+    typedef Eigen::Matrix<
+                typename Point::Scalar,
+                Point::RowsAtCompileTime,
+                Eigen::Dynamic,
+                Eigen::AutoAlign | (Point::RowsAtCompileTime == 1
+                                        ? Eigen::RowMajor
+                                        : Eigen::ColMajor),
+                Point::RowsAtCompileTime,
+                MaxCount
+            > Type;
+};
+
 /**
  * \ingroup meta
  *
@@ -24,7 +24,9 @@
 #define FL__UTIL__RANDOM_HPP
 
 #include <ctime>
+#include <atomic>
 #include <random>
+#include <cstdint>
 
 /**
  * \brief global seed
@@ -56,21 +58,240 @@ typedef std::mersenne_twister_engine<
                 0xffe50000, 17,
                 1812433253 > mt11213b;
 
+/** \cond INTERNAL */
+namespace internal
+{
+
 /**
- * \return A seed. If USE_RANDOM_SEED was set true the seed is set to the
- * current time, otherwise, the seed will be 1.
+ * \return Process wide root seed storage. The root seed is determined once on
+ * first use.
+ */
+inline std::uint64_t& root_seed()
+{
+    static std::uint64_t root = RANDOM_SEED;
+    return root;
+}
+
+/**
+ * \return Process wide stream counter
+ */
+inline std::atomic<std::uint64_t>& stream_counter()
+{
+    static std::atomic<std::uint64_t> counter(0);
+    return counter;
+}
+
+}
+/** \endcond */
+
+/**
+ * \return The root seed. If USE_RANDOM_SEED was set true the seed is set to
+ * the current time once on first use, otherwise, the seed will be 1. All
+ * generators of the library derive their streams from this seed.
  *
  * \ingroup random
  */
 inline unsigned int seed()
 {
-#ifdef USE_RANDOM_SEED
-    return (unsigned int) std::time(0);
-#else
-    return 1;
-#endif
+    return (unsigned int) internal::root_seed();
+}
+
+/**
+ * Sets the root seed and restarts the stream enumeration. Generators created
+ * after this call in the same order reproduce the same sequences.
+ *
+ * \param root_seed  New root seed
+ *
+ * \ingroup random
+ */
+inline void seed(unsigned int root_seed)
+{
+    internal::root_seed() = root_seed;
+    internal::stream_counter() = 0;
+}
+
+/**
+ * \return A new stream id which has not been handed out since the last reset
+ *         of the root seed. This function is thread safe and lock-free.
+ *
+ * \ingroup random
+ */
+inline std::uint64_t next_stream()
+{
+    return internal::stream_counter()++;
+}
+
+/**
+ * \return Id of the index-th substream of the given stream, e.g. the stream
+ *         of a particle or of a worker thread. Substreams are derived by a
+ *         SplitMix64 finalizer and therefore depend on the ids only.
+ *
+ * \param stream    Parent stream id
+ * \param index     Substream index
+ *
+ * \ingroup random
+ */
+inline std::uint64_t substream(std::uint64_t stream, std::uint64_t index)
+{
+    std::uint64_t z = stream * 0x9e3779b97f4a7c15ull + index + 1;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
 }
 
+/**
+ * \ingroup random
+ *
+ * \brief Counter-based random number engine Philox4x32-10
+ *        \cite salmon2011parallel
+ *
+ * The n-th output of a Philox stream is a pure function of the key (seed),
+ * the stream id and n. Streams are therefore independent of the order in which
+ * they are consumed and may be created for every thread, particle or sample
+ * without any shared state. This makes parallel sampling lock-free and
+ * reproducible regardless of the number of threads.
+ *
+ * The engine satisfies the UniformRandomBitGenerator requirements and can
+ * be used with the standard distributions.
+ */
+class Philox4x32
+{
+public:
+    typedef std::uint32_t result_type;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xffffffff; }
+
+public:
+    /**
+     * Creates a Philox4x32 engine
+     *
+     * \param seed      Key of the generator
+     * \param stream    Stream id. Different streams of the same seed are
+     *                  statistically independent.
+     */
+    explicit Philox4x32(std::uint64_t seed = fl::seed(),
+                        std::uint64_t stream = 0)
+    {
+        this->seed(seed, stream);
+    }
+
+    /**
+     * Resets the engine to the beginning of the given stream
+     *
+     * \param seed      Key of the generator
+     * \param stream    Stream id
+     */
+    void seed(std::uint64_t seed, std::uint64_t stream = 0)
+    {
+        key_[0] = std::uint32_t(seed);
+        key_[1] = std::uint32_t(seed >> 32);
+        block_ = 0;
+        stream_ = stream;
+        position_ = 4;
+    }
+
+    /**
+     * \return Next 32 random bits of the stream
+     */
+    result_type operator()()
+    {
+        if (position_ == 4)
+        {
+            generate_block(block_++, output_);
+            position_ = 0;
+        }
+
+        return output_[position_++];
+    }
+
+    /**
+     * Advances the engine by \c n outputs in constant time
+     */
+    void discard(unsigned long long n)
+    {
+        // number of outputs consumed after discarding
+        const std::uint64_t consumed = block_ * 4 - 4 + position_ + n;
+
+        block_ = consumed / 4;
+        position_ = unsigned(consumed % 4);
+
+        if (position_ == 0)
+        {
+            position_ = 4;
+        }
+        else
+        {
+            generate_block(block_++, output_);
+        }
+    }
+
+    /**
+     * Computes the four outputs of the given block of this stream
+     *
+     * \param [in]  block   Block index within the stream
+     * \param [out] output  The generated 32-bit words
+     */
+    void generate_block(std::uint64_t block, result_type output[4]) const
+    {
+        std::uint32_t counter[4] = { std::uint32_t(block),
+                                     std::uint32_t(block >> 32),
+                                     std::uint32_t(stream_),
+                                     std::uint32_t(stream_ >> 32) };
+        std::uint32_t key[2] = { key_[0], key_[1] };
+
+        for (int round = 0; round < 10; ++round)
+        {
+            if (round > 0)
+            {
+                key[0] += 0x9e3779b9;
+                key[1] += 0xbb67ae85;
+            }
+
+            const std::uint64_t product_0 =
+                std::uint64_t(0xd2511f53) * std::uint64_t(counter[0]);
+            const std::uint64_t product_1 =
+                std::uint64_t(0xcd9e8d57) * std::uint64_t(counter[2]);
+
+            const std::uint32_t hi_0 = std::uint32_t(product_0 >> 32);
+            const std::uint32_t lo_0 = std::uint32_t(product_0);
+            const std::uint32_t hi_1 = std::uint32_t(product_1 >> 32);
+            const std::uint32_t lo_1 = std::uint32_t(product_1);
+
+            counter[0] = hi_1 ^ counter[1] ^ key[0];
+            counter[1] = lo_1;
+            counter[2] = hi_0 ^ counter[3] ^ key[1];
+            counter[3] = lo_0;
+        }
+
+        for (int i = 0; i < 4; ++i) output[i] = counter[i];
+    }
+
+    /**
+     * \return Stream id of this engine
+     */
+    std::uint64_t stream() const { return stream_; }
+
+    friend bool operator==(const Philox4x32& a, const Philox4x32& b)
+    {
+        return a.key_[0] == b.key_[0] && a.key_[1] == b.key_[1]
+               && a.stream_ == b.stream_
+               && a.block_ == b.block_ && a.position_ == b.position_;
+    }
+
+    friend bool operator!=(const Philox4x32& a, const Philox4x32& b)
+    {
+        return !(a == b);
+    }
+
+private:
+    std::uint32_t key_[2];
+    std::uint64_t block_;
+    std::uint64_t stream_;
+    unsigned position_;
+    result_type output_[4];
+};
+
 }
 
 #endif
@@ -0,0 +1,367 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file thread_pool.hpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#ifndef FL__UTIL__THREAD_POOL_HPP
+#define FL__UTIL__THREAD_POOL_HPP
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+namespace fl
+{
+
+/**
+ * \ingroup util
+ *
+ * \brief Persistent pool of worker threads executing index based parallel
+ *        loops
+ *
+ * The worker threads are created once and sleep between jobs. The calling
+ * thread participates in every job as worker 0, i.e. a pool of size \f$n\f$
+ * owns \f$n-1\f$ threads.
+ *
+ * Indices are handed out dynamically, one at a time. The assignment of
+ * indices to workers is therefore not deterministic, however, as long as the
+ * i-th iteration only writes to the i-th result slot, the result is
+ * independent of the number of workers and of the scheduling.
+ *
+ * parallel_for() must not be called from within a running job of the same
+ * pool. Concurrent calls from different threads are serialized.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * Creates a thread pool
+     *
+     * \param workers   Number of workers including the calling thread. The
+     *                  default is the number of hardware threads.
+     */
+    explicit ThreadPool(size_t workers = default_size())
+        : task_(nullptr),
+          generation_(0),
+          running_(0),
+          stop_(false)
+    {
+        for (size_t worker = 1; worker < workers; ++worker)
+        {
+            threads_.emplace_back(&ThreadPool::work, this, worker);
+        }
+    }
+
+    /**
+     * Stops and joins all worker threads
+     */
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_.notify_all();
+
+        for (auto& thread: threads_)
+        {
+            thread.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * \return Number of workers including the calling thread
+     */
+    size_t size() const
+    {
+        return threads_.size() + 1;
+    }
+
+    /**
+     * \return Number of hardware threads, at least 1
+     */
+    static size_t default_size()
+    {
+        const size_t hardware_threads = std::thread::hardware_concurrency();
+        return hardware_threads > 0 ? hardware_threads : 1;
+    }
+
+    /**
+     * Calls function(i, worker) for all i in [begin, end) and returns once
+     * all calls have finished. The worker index in [0, size()) identifies the
+     * executing worker and may be used to select per-worker resources.
+     *
+     * \param begin     First index
+     * \param end       One past the last index
+     * \param function  Callable with the signature void(size_t, size_t)
+     *
+     * \throws Rethrows the first exception thrown by function
+     */
+    template <typename Function>
+    void parallel_for(size_t begin, size_t end, Function function)
+    {
+        if (end <= begin) return;
+
+        if (threads_.empty() || end - begin == 1)
+        {
+            for (size_t i = begin; i < end; ++i) function(i, 0);
+            return;
+        }
+
+        struct Loop
+        {
+            std::atomic<size_t> next;
+            size_t end;
+            Function& function;
+        } loop { {begin}, end, function };
+
+        // a single captured pointer is stored without a heap allocation
+        std::function<void(size_t)> task =
+            [&loop](size_t worker)
+            {
+                for (size_t i = loop.next++; i < loop.end; i = loop.next++)
+                {
+                    loop.function(i, worker);
+                }
+            };
+
+        run(task);
+    }
+
+protected:
+    /** \cond INTERNAL */
+
+    /**
+     * Executes the task on all workers and waits for completion
+     */
+    void run(const std::function<void(size_t)>& task)
+    {
+        std::lock_guard<std::mutex> call_lock(call_mutex_);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = &task;
+            error_ = nullptr;
+            running_ = threads_.size();
+            ++generation_;
+        }
+        start_.notify_all();
+
+        execute(0);
+
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait(lock, [this] { return running_ == 0; });
+            task_ = nullptr;
+            error = error_;
+            error_ = nullptr;
+        }
+
+        if (error) std::rethrow_exception(error);
+    }
+
+    /**
+     * Executes the current task and records the first exception
+     */
+    void execute(size_t worker)
+    {
+        try
+        {
+            (*task_)(worker);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_ = std::current_exception();
+        }
+    }
+
+    /**
+     * Worker thread main loop
+     */
+    void work(size_t worker)
+    {
+        size_t generation = 0;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_.wait(lock, [&]
+                {
+                    return stop_ || generation_ != generation;
+                });
+
+                if (stop_) return;
+                generation = generation_;
+            }
+
+            execute(worker);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--running_ == 0) done_.notify_one();
+        }
+    }
+    /** \endcond */
+
+protected:
+    /** \cond INTERNAL */
+    std::vector<std::thread> threads_;
+    std::mutex call_mutex_;
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    const std::function<void(size_t)>* task_;
+    std::exception_ptr error_;
+    size_t generation_;
+    size_t running_;
+    bool stop_;
+    /** \endcond */
+};
+
+/**
+ * \ingroup util
+ *
+ * \return An instance of the given object which may be used by a separate
+ *         worker thread. This is the object itself if it is thread safe,
+ *         otherwise a clone of it. A null pointer is returned if the object
+ *         cannot be cloned into its own type.
+ *
+ * \tparam Object   Type providing \c is_thread_safe() and \c clone(), e.g.
+ *                  a process or an observation model
+ */
+template <typename Object>
+std::shared_ptr<Object> worker_instance(const std::shared_ptr<Object>& object)
+{
+    if (object->is_thread_safe()) return object;
+
+    return std::dynamic_pointer_cast<Object>(object->clone());
+}
+
+/**
+ * \ingroup util
+ *
+ * \brief Provides one instance of an object per worker of a ThreadPool
+ *
+ * Worker 0 always uses the original instance. The remaining workers use the
+ * instances obtained by worker_instance(). The instances are created once and
+ * kept as long as the original object, its version and the number of workers
+ * stay the same. Clones thus keep their internal caches between jobs and are
+ * replaced as soon as the parameters of the original change.
+ *
+ * \tparam Object   Type providing \c is_thread_safe(), \c clone() and
+ *                  \c version(), e.g. a process or an observation model
+ */
+template <typename Object>
+class WorkerInstances
+{
+public:
+    WorkerInstances()
+        : version_(0),
+          thread_safe_(false),
+          valid_(false)
+    { }
+
+    /**
+     * Sets up the instances for the given number of workers. The instances
+     * are only recreated if the original object, its version, the number of
+     * workers or the thread safety of the object have changed since the last
+     * call.
+     *
+     * \param object    Original instance
+     * \param workers   Number of workers
+     *
+     * \return False if the object is not thread safe and cannot be cloned.
+     *         In this case only worker 0 has a valid instance.
+     */
+    bool assign(const std::shared_ptr<Object>& object, size_t workers)
+    {
+        const bool thread_safe = object->is_thread_safe();
+        const size_t version = object->version();
+
+        if (instances_.size() == workers
+            && workers > 0
+            && instances_[0] == object
+            && version_ == version
+            && thread_safe_ == thread_safe)
+        {
+            return valid_;
+        }
+
+        instances_.assign(workers, object);
+        version_ = version;
+        thread_safe_ = thread_safe;
+        valid_ = true;
+
+        if (thread_safe) return valid_;
+
+        for (size_t worker = 1; worker < workers; ++worker)
+        {
+            instances_[worker] =
+                std::dynamic_pointer_cast<Object>(object->clone());
+
+            if (!instances_[worker])
+            {
+                valid_ = false;
+                break;
+            }
+        }
+
+        return valid_;
+    }
+
+    /**
+     * Discards all instances. The next call of assign() creates new clones
+     * from the current state of the original.
+     */
+    void reset()
+    {
+        instances_.clear();
+    }
+
+    /**
+     * \return Instance of the given worker
+     */
+    Object& operator[](size_t worker) const
+    {
+        return *instances_[worker];
+    }
+
+protected:
+    /** \cond INTERNAL */
+    std::vector<std::shared_ptr<Object>> instances_;
+    size_t version_;
+    bool thread_safe_;
+    bool valid_;
+    /** \endcond */
+};
+
+}
+
+#endif
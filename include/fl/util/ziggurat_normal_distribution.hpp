@@ -0,0 +1,319 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file ziggurat_normal_distribution.hpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#ifndef FL__UTIL__ZIGGURAT_NORMAL_DISTRIBUTION_HPP
+#define FL__UTIL__ZIGGURAT_NORMAL_DISTRIBUTION_HPP
+
+#include <cmath>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace fl
+{
+
+/** \cond INTERNAL */
+namespace internal
+{
+
+/**
+ * Ziggurat tables of the standard normal density using 256 layers of equal
+ * area \f$V\f$. The table is computed once on first use.
+ *
+ * \c x[i] denotes the right edge of the i-th layer and \c f[i] the density
+ * \f$\exp(-x_i^2/2)\f$ at that edge. Layer 0 is the base strip including the
+ * tail beyond \f$R = x_1\f$.
+ */
+struct ZigguratNormalTables
+{
+    enum : int { Layers = 256 };
+
+    static constexpr double R = 3.6541528853610088;
+    static constexpr double V = 0.00492867323399;
+
+    double x[Layers + 1];
+    double f[Layers + 1];
+
+    ZigguratNormalTables()
+    {
+        x[0] = V / std::exp(-0.5 * R * R);
+        x[1] = R;
+        for (int i = 2; i < Layers; ++i)
+        {
+            x[i] = std::sqrt(
+                -2.0 * std::log(V / x[i - 1] + std::exp(-0.5 * x[i - 1] * x[i - 1])));
+        }
+        x[Layers] = 0.0;
+
+        for (int i = 0; i <= Layers; ++i)
+        {
+            f[i] = std::exp(-0.5 * x[i] * x[i]);
+        }
+    }
+
+    static const ZigguratNormalTables& instance()
+    {
+        static const ZigguratNormalTables tables;
+        return tables;
+    }
+};
+
+/**
+ * \return 64 random bits drawn from a 32-bit or 64-bit uniform random bit
+ *         generator
+ */
+template <typename Generator>
+inline std::uint64_t random_bits_64(Generator& generator)
+{
+    static_assert(Generator::min() == 0, "Generator must start at zero");
+    static_assert(std::uint64_t(Generator::max()) >= 0xffffffffull,
+                  "Generator must provide at least 32 random bits");
+
+    if (std::uint64_t(Generator::max()) == ~std::uint64_t(0))
+    {
+        return std::uint64_t(generator());
+    }
+
+    const std::uint64_t high = std::uint64_t(generator()) & 0xffffffffull;
+    const std::uint64_t low = std::uint64_t(generator()) & 0xffffffffull;
+
+    return (high << 32) | low;
+}
+
+/**
+ * \return Uniform random number in the open interval (0, 1)
+ */
+template <typename Generator>
+inline double open_unit_uniform(Generator& generator)
+{
+    return (double(random_bits_64(generator) >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+}
+/** \endcond */
+
+/**
+ * \ingroup random
+ *
+ * \brief Normal distribution generator based on the Ziggurat method
+ *        \cite marsaglia2000ziggurat
+ *
+ * \tparam RealType     Floating point result type
+ *
+ * ZigguratNormalDistribution is a drop-in replacement of
+ * \c std::normal_distribution. Roughly 99% of the samples are produced by a
+ * single table lookup, a multiplication and a comparison. Only the remaining
+ * samples fall back to the exact evaluation of the density wedges or the
+ * tail. In contrast to \c std::normal_distribution, the generator does not
+ * carry any state between calls and its call operator is const.
+ *
+ * The layer index and the uniform abscissa are taken from independent bits of
+ * a 64-bit random word which avoids the correlation of the original 32-bit
+ * formulation.
+ *
+ * fill() draws the same sequence of samples as repeated calls of the call
+ * operator. It is not faster than the call operator since the sample rate is
+ * bound by the uniform random bit generator.
+ */
+template <typename RealType = double>
+class ZigguratNormalDistribution
+{
+    static_assert(
+        std::is_floating_point<RealType>::value,
+        "RealType must be a floating point (float, double, long double)");
+
+public:
+    typedef RealType result_type;
+
+    /**
+     * \brief Distribution parameters (mean and standard deviation)
+     */
+    struct param_type
+    {
+        RealType mean;
+        RealType stddev;
+    };
+
+public:
+    /**
+     * Creates a normal distribution generator \f${\cal N}(\mu, \sigma^2)\f$
+     *
+     * \param mean      Mean \f$\mu\f$
+     * \param stddev    Standard deviation \f$\sigma\f$
+     */
+    explicit ZigguratNormalDistribution(RealType mean = RealType(0.),
+                                        RealType stddev = RealType(1.))
+        : param_{mean, stddev}
+    {
+        // make sure the tables exist before the first sample is drawn
+        internal::ZigguratNormalTables::instance();
+    }
+
+    /**
+     * \brief Resets the distribution state. The generator is stateless, this
+     *        exists for compatibility with \c std::normal_distribution.
+     */
+    void reset() { }
+
+    /**
+     * \return Distribution mean
+     */
+    RealType mean() const { return param_.mean; }
+
+    /**
+     * \return Distribution standard deviation
+     */
+    RealType stddev() const { return param_.stddev; }
+
+    /**
+     * \return A normal sample
+     *
+     * \param generator     Uniform random bit generator
+     */
+    template <typename Generator>
+    result_type operator()(Generator& generator) const
+    {
+        return param_.mean + param_.stddev * RealType(standard_sample(generator));
+    }
+
+    /**
+     * Fills the range [first, first + count) with normal samples
+     *
+     * \param generator     Uniform random bit generator
+     * \param first         Destination
+     * \param count         Number of samples
+     */
+    template <typename Generator>
+    void fill(Generator& generator, RealType* first, std::size_t count) const
+    {
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            first[k] = param_.mean
+                       + param_.stddev * RealType(standard_sample(generator));
+        }
+    }
+
+protected:
+    /** \cond INTERNAL */
+    /**
+     * \return Uniform number in (-1, 1) taken from the upper 53 bits
+     */
+    static double signed_uniform(std::uint64_t bits)
+    {
+        return (double(bits >> 11) + 0.5) * (2.0 / 9007199254740992.0) - 1.0;
+    }
+
+    /**
+     * \return A standard normal sample
+     */
+    template <typename Generator>
+    static double standard_sample(Generator& generator)
+    {
+        typedef internal::ZigguratNormalTables Tables;
+        const Tables& tables = Tables::instance();
+
+        const std::uint64_t bits = internal::random_bits_64(generator);
+        const int i = int(bits & 0xff);
+        const double x = signed_uniform(bits) * tables.x[i];
+
+        if (std::fabs(x) < tables.x[i + 1]) return x;
+
+        return slow_path(generator, bits, x);
+    }
+
+    /**
+     * \return A standard normal sample given the rejected fast path candidate
+     *         x drawn from the layer encoded in bits
+     */
+    template <typename Generator>
+    static double slow_path(Generator& generator, std::uint64_t bits, double x)
+    {
+        typedef internal::ZigguratNormalTables Tables;
+        const Tables& tables = Tables::instance();
+
+        const int i = int(bits & 0xff);
+
+        if (i == 0)
+        {
+            // sample from the tail beyond R
+            double tail_x, tail_y;
+            do
+            {
+                tail_x = std::log(internal::open_unit_uniform(generator))
+                         / Tables::R;
+                tail_y = std::log(internal::open_unit_uniform(generator));
+            }
+            while (-2.0 * tail_y < tail_x * tail_x);
+
+            return x < 0.0 ? tail_x - Tables::R : Tables::R - tail_x;
+        }
+
+        // wedge between the layer rectangle and the density
+        const double y = tables.f[i]
+                         + (tables.f[i + 1] - tables.f[i])
+                           * internal::open_unit_uniform(generator);
+
+        if (y < std::exp(-0.5 * x * x)) return x;
+
+        return standard_sample(generator);
+    }
+    /** \endcond */
+
+protected:
+    param_type param_;
+};
+
+/**
+ * \ingroup random
+ *
+ * Fills the range [first, first + count) with samples of the given normal
+ * distribution generator
+ */
+template <typename Distribution, typename Generator, typename RealType>
+inline void fill_normal(Distribution& distribution,
+                        Generator& generator,
+                        RealType* first,
+                        std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        first[i] = distribution(generator);
+    }
+}
+
+/**
+ * \ingroup random
+ *
+ * Fills the range [first, first + count) using ZigguratNormalDistribution::fill
+ */
+template <typename Generator, typename RealType>
+inline void fill_normal(const ZigguratNormalDistribution<RealType>& distribution,
+                        Generator& generator,
+                        RealType* first,
+                        std::size_t count)
+{
+    distribution.fill(generator, first, count);
+}
+
+}
+
+#endif
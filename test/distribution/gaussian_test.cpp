@@ -51,6 +51,7 @@
 #include <Eigen/Dense>
 
 #include <cmath>
+#include <ctime>
 #include <iostream>
 
 #include <fl/distribution/gaussian.hpp>
@@ -273,3 +274,252 @@ TEST_F(GaussianTests, dynamic_uninitialized_gaussian)
     EXPECT_THROW(gaussian.square_root(), fl::GaussianUninitializedException);
 }
 
+
+TEST_F(GaussianTests, moments_returned_by_reference)
+{
+    typedef fl::Gaussian<FVector> Gaussian;
+    typedef typename fl::Traits<Gaussian>::SecondMoment Covariance;
+
+    Gaussian gaussian;
+
+    const FVector& mean = gaussian.mean();
+    const Covariance& covariance = gaussian.covariance();
+
+    // repeated access must not create copies
+    EXPECT_EQ(&mean, &gaussian.mean());
+    EXPECT_EQ(&covariance, &gaussian.covariance());
+
+    // references reflect updates of the distribution
+    FVector new_mean = FVector::Random();
+    gaussian.mean(new_mean);
+    EXPECT_TRUE(mean.isApprox(new_mean));
+
+    Covariance square_root = Covariance::Random();
+    gaussian.square_root(square_root);
+    EXPECT_EQ(&covariance, &gaussian.covariance());
+    EXPECT_TRUE(
+        covariance.isApprox(square_root * square_root.transpose()));
+}
+
+TEST_F(GaussianTests, factorization_based_attributes)
+{
+    typedef fl::Gaussian<DVector> Gaussian;
+    typedef typename fl::Traits<Gaussian>::SecondMoment Covariance;
+
+    const int dim = 6;
+    Gaussian gaussian(dim);
+
+    Covariance A = Covariance::Random(dim, dim);
+    Covariance covariance = A * A.transpose()
+                            + Covariance::Identity(dim, dim);
+    gaussian.covariance(covariance);
+
+    EXPECT_TRUE(gaussian.has_full_rank());
+    EXPECT_TRUE(gaussian.precision().isApprox(covariance.inverse()));
+    EXPECT_TRUE((gaussian.square_root() * gaussian.square_root().transpose())
+                    .isApprox(covariance));
+    EXPECT_NEAR(gaussian.log_normalizer(),
+                -0.5 * (std::log(covariance.determinant())
+                        + dim * std::log(2.0 * M_PI)),
+                1.e-9);
+
+    Covariance rank_deficient = Covariance::Identity(dim, dim);
+    rank_deficient(dim - 1, dim - 1) = 0.;
+    gaussian.covariance(rank_deficient);
+    EXPECT_FALSE(gaussian.has_full_rank());
+}
+
+TEST_F(GaussianTests, rank_update)
+{
+    typedef fl::Gaussian<FVector> Gaussian;
+    typedef typename fl::Traits<Gaussian>::SecondMoment Covariance;
+
+    Gaussian gaussian;
+
+    Covariance A = Covariance::Random();
+    Covariance covariance = A * A.transpose() + Covariance::Identity();
+    gaussian.covariance(covariance);
+
+    Eigen::Matrix<double, 5, 3> V = Eigen::Matrix<double, 5, 3>::Random();
+
+    gaussian.rank_update(V);
+    covariance += V * V.transpose();
+
+    EXPECT_TRUE(gaussian.covariance().isApprox(covariance));
+    EXPECT_TRUE(gaussian.precision().isApprox(covariance.inverse()));
+    EXPECT_TRUE((gaussian.square_root() * gaussian.square_root().transpose())
+                    .isApprox(covariance));
+    EXPECT_NEAR(gaussian.log_normalizer(),
+                -0.5 * (std::log(covariance.determinant())
+                        + 5 * std::log(2.0 * M_PI)),
+                1.e-9);
+
+    // downdating reverts the update
+    gaussian.rank_update(V.leftCols(2), -1.);
+    covariance -= V.leftCols(2) * V.leftCols(2).transpose();
+
+    EXPECT_TRUE(gaussian.covariance().isApprox(covariance));
+    EXPECT_TRUE(gaussian.precision().isApprox(covariance.inverse()));
+}
+
+TEST_F(GaussianTests, batch_log_probability)
+{
+    typedef fl::Gaussian<DVector> Gaussian;
+    typedef typename fl::Traits<Gaussian>::SecondMoment Covariance;
+
+    const int dim = 7;
+    const int sample_count = 50;
+
+    Gaussian gaussian(dim);
+    Covariance A = Covariance::Random(dim, dim);
+    gaussian.mean(DVector::Random(dim));
+    gaussian.covariance(A * A.transpose() + Covariance::Identity(dim, dim));
+
+    Eigen::MatrixXd samples = Eigen::MatrixXd::Random(dim, sample_count);
+    Eigen::VectorXd log_probabilities;
+
+    gaussian.log_probability(samples, log_probabilities);
+
+    ASSERT_EQ(log_probabilities.rows(), sample_count);
+    for (int i = 0; i < sample_count; ++i)
+    {
+        const DVector delta = samples.col(i) - gaussian.mean();
+        const double expected =
+            gaussian.log_normalizer()
+            - 0.5 * delta.dot(gaussian.covariance().inverse() * delta);
+
+        EXPECT_NEAR(log_probabilities(i), expected, 1.e-9);
+        EXPECT_NEAR(gaussian.log_probability(samples.col(i)), expected, 1.e-9);
+    }
+
+    // diagonal representation and Eigen::Map input
+    gaussian.diagonal_covariance(
+        DVector::Constant(dim, 2.).asDiagonal().toDenseMatrix());
+    Eigen::Map<const Eigen::MatrixXd> mapped(samples.data(), dim, sample_count);
+    gaussian.log_probability(mapped, log_probabilities);
+
+    for (int i = 0; i < sample_count; ++i)
+    {
+        const DVector delta = samples.col(i) - gaussian.mean();
+        EXPECT_NEAR(log_probabilities(i),
+                    gaussian.log_normalizer() - 0.25 * delta.squaredNorm(),
+                    1.e-9);
+    }
+
+    // block output after a low rank update of the cached factorization
+    gaussian.covariance(A * A.transpose() + Covariance::Identity(dim, dim));
+    gaussian.log_probability(samples, log_probabilities);
+    const DVector v = DVector::Random(dim);
+    gaussian.rank_update(v);
+
+    Eigen::MatrixXd table = Eigen::MatrixXd::Zero(sample_count, 2);
+    gaussian.log_probability(samples, table.col(1));
+
+    for (int i = 0; i < sample_count; ++i)
+    {
+        const DVector delta = samples.col(i) - gaussian.mean();
+        const double expected =
+            gaussian.log_normalizer()
+            - 0.5 * delta.dot(gaussian.covariance().inverse() * delta);
+
+        EXPECT_NEAR(table(i, 1), expected, 1.e-9);
+        EXPECT_EQ(table(i, 0), 0.);
+    }
+}
+
+// benchmark, run with --gtest_also_run_disabled_tests
+TEST_F(GaussianTests, DISABLED_batch_log_probability_speed)
+{
+    typedef fl::Gaussian<DVector> Gaussian;
+    typedef typename fl::Traits<Gaussian>::SecondMoment Covariance;
+
+    const int dim = 12;
+    const int sample_count = 5000;
+    const int iterations = 20;
+
+    Gaussian gaussian(dim);
+    Covariance A = Covariance::Random(dim, dim);
+    gaussian.covariance(A * A.transpose() + Covariance::Identity(dim, dim));
+
+    Eigen::MatrixXd samples = Eigen::MatrixXd::Random(dim, sample_count);
+    Eigen::VectorXd loop_log_probabilities(sample_count);
+    Eigen::VectorXd batch_log_probabilities(sample_count);
+
+    std::clock_t start = std::clock();
+    for (int k = 0; k < iterations; ++k)
+    {
+        for (int i = 0; i < sample_count; ++i)
+        {
+            loop_log_probabilities(i) =
+                gaussian.log_probability(samples.col(i));
+        }
+    }
+    const double loop_time = (std::clock() - start) / double(CLOCKS_PER_SEC);
+
+    start = std::clock();
+    for (int k = 0; k < iterations; ++k)
+    {
+        gaussian.log_probability(samples, batch_log_probabilities);
+    }
+    const double batch_time = (std::clock() - start) / double(CLOCKS_PER_SEC);
+
+    EXPECT_TRUE(batch_log_probabilities.isApprox(loop_log_probabilities));
+
+    std::cout << "log_probability of " << iterations * sample_count
+              << " samples: per-sample loop " << loop_time
+              << " s, batch " << batch_time << " s" << std::endl;
+}
+
+TEST_F(GaussianTests, batch_map_standard_normal)
+{
+    typedef fl::Gaussian<FVector> Gaussian;
+    typedef typename fl::Traits<Gaussian>::SecondMoment Covariance;
+
+    Gaussian gaussian;
+    Covariance A = Covariance::Random();
+    gaussian.mean(FVector::Random());
+    gaussian.covariance(A * A.transpose() + Covariance::Identity());
+
+    Gaussian::StandardVariates noise = Gaussian::StandardVariates::Random(5, 20);
+    Gaussian::Variates samples = gaussian.map_standard_normal(noise);
+
+    ASSERT_EQ(samples.cols(), 20);
+    for (int i = 0; i < samples.cols(); ++i)
+    {
+        FVector single_noise = noise.col(i);
+        EXPECT_TRUE(samples.col(i).isApprox(
+                        gaussian.map_standard_normal(single_noise)));
+    }
+}
+
+TEST_F(GaussianTests, bulk_sampling)
+{
+    typedef fl::Gaussian<DVector> Gaussian;
+    typedef typename fl::Traits<Gaussian>::SecondMoment Covariance;
+
+    const int dim = 3;
+    const int sample_count = 200000;
+
+    Gaussian gaussian(dim);
+    Covariance covariance(dim, dim);
+    covariance << 2.0, 0.5, 0.0,
+                  0.5, 1.0, 0.3,
+                  0.0, 0.3, 0.5;
+    DVector mean(dim);
+    mean << 1.0, -2.0, 3.0;
+    gaussian.mean(mean);
+    gaussian.covariance(covariance);
+
+    Gaussian::Variates samples = gaussian.sample(sample_count);
+
+    ASSERT_EQ(samples.rows(), dim);
+    ASSERT_EQ(samples.cols(), sample_count);
+
+    DVector sample_mean = samples.rowwise().mean();
+    Eigen::MatrixXd centered = samples.colwise() - sample_mean;
+    Covariance sample_covariance =
+        centered * centered.transpose() / double(sample_count - 1);
+
+    EXPECT_TRUE(sample_mean.isApprox(mean, 0.01));
+    EXPECT_TRUE(sample_covariance.isApprox(covariance, 0.02));
+}
@@ -0,0 +1,199 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file ziggurat_normal_distribution_test.cpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Dense>
+
+#include <cmath>
+#include <ctime>
+#include <vector>
+#include <random>
+#include <iostream>
+#include <algorithm>
+
+#include <fl/util/random.hpp>
+#include <fl/util/ziggurat_normal_distribution.hpp>
+#include <fl/distribution/standard_gaussian.hpp>
+
+const size_t SAMPLE_COUNT = 1000000;
+
+/**
+ * Checks the first four moments, the tail mass and the Kolmogorov-Smirnov
+ * statistic of the given samples against the standard normal distribution
+ */
+void test_standard_normal_quality(std::vector<double> samples)
+{
+    const double n = double(samples.size());
+
+    double mean = 0.;
+    for (auto x : samples) mean += x;
+    mean /= n;
+
+    double m2 = 0., m3 = 0., m4 = 0.;
+    size_t tail_count = 0;
+    for (auto x : samples)
+    {
+        const double d = x - mean;
+        m2 += d * d;
+        m3 += d * d * d;
+        m4 += d * d * d * d;
+        if (std::fabs(x) > fl::internal::ZigguratNormalTables::R) ++tail_count;
+    }
+    m2 /= n; m3 /= n; m4 /= n;
+
+    const double skewness = m3 / std::pow(m2, 1.5);
+    const double kurtosis = m4 / (m2 * m2);
+
+    // tolerances are about five standard errors
+    EXPECT_NEAR(mean, 0., 5. * std::sqrt(1. / n));
+    EXPECT_NEAR(m2, 1., 5. * std::sqrt(2. / n));
+    EXPECT_NEAR(skewness, 0., 5. * std::sqrt(6. / n));
+    EXPECT_NEAR(kurtosis, 3., 5. * std::sqrt(24. / n));
+
+    // probability mass beyond the ziggurat base strip |x| > R
+    const double p_tail =
+        std::erfc(fl::internal::ZigguratNormalTables::R / std::sqrt(2.));
+    EXPECT_NEAR(double(tail_count) / n,
+                p_tail,
+                5. * std::sqrt(p_tail * (1. - p_tail) / n));
+
+    // Kolmogorov-Smirnov statistic, critical value for alpha = 0.001
+    std::sort(samples.begin(), samples.end());
+    double ks = 0.;
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        const double cdf = 0.5 * std::erfc(-samples[i] / std::sqrt(2.));
+        ks = std::max(ks, std::max(cdf - double(i) / n,
+                                   double(i + 1) / n - cdf));
+    }
+    EXPECT_LT(ks, 1.95 / std::sqrt(n));
+}
+
+TEST(ZigguratNormalDistributionTests, scalar_sampling_quality)
+{
+    fl::mt11213b generator(1);
+    fl::ZigguratNormalDistribution<> normal;
+
+    std::vector<double> samples(SAMPLE_COUNT);
+    for (auto& x : samples) x = normal(generator);
+
+    test_standard_normal_quality(samples);
+}
+
+TEST(ZigguratNormalDistributionTests, block_fill_quality)
+{
+    fl::mt11213b generator(2);
+    fl::ZigguratNormalDistribution<> normal;
+
+    std::vector<double> samples(SAMPLE_COUNT);
+    normal.fill(generator, samples.data(), samples.size());
+
+    test_standard_normal_quality(samples);
+}
+
+TEST(ZigguratNormalDistributionTests, block_fill_matches_call_operator)
+{
+    fl::mt11213b fill_generator(6);
+    fl::mt11213b call_generator(6);
+    fl::ZigguratNormalDistribution<> normal;
+
+    std::vector<double> samples(1000);
+    normal.fill(fill_generator, samples.data(), samples.size());
+
+    for (auto x : samples) EXPECT_EQ(x, normal(call_generator));
+}
+
+TEST(ZigguratNormalDistributionTests, 64bit_generator_quality)
+{
+    std::mt19937_64 generator(3);
+    fl::ZigguratNormalDistribution<> normal;
+
+    std::vector<double> samples(SAMPLE_COUNT);
+    for (auto& x : samples) x = normal(generator);
+
+    test_standard_normal_quality(samples);
+}
+
+TEST(ZigguratNormalDistributionTests, mean_and_stddev)
+{
+    fl::mt11213b generator(4);
+    fl::ZigguratNormalDistribution<float> normal(2.f, 3.f);
+
+    std::vector<float> samples(SAMPLE_COUNT);
+    normal.fill(generator, samples.data(), samples.size());
+
+    double mean = 0., var = 0.;
+    for (auto x : samples) mean += x;
+    mean /= double(SAMPLE_COUNT);
+    for (auto x : samples) var += (x - mean) * (x - mean);
+    var /= double(SAMPLE_COUNT);
+
+    EXPECT_NEAR(mean, 2., 0.02);
+    EXPECT_NEAR(var, 9., 0.1);
+}
+
+TEST(ZigguratNormalDistributionTests, standard_gaussian_selection)
+{
+    typedef Eigen::Matrix<double, 3, 1> Variate;
+
+    fl::StandardGaussian<
+        Variate,
+        fl::ZigguratNormalDistribution<double>
+    > ziggurat_gaussian;
+
+    fl::StandardGaussian<
+        Variate,
+        std::normal_distribution<double>
+    > std_gaussian;
+
+    EXPECT_EQ(ziggurat_gaussian.sample(10).cols(), 10);
+    EXPECT_EQ(std_gaussian.sample(10).cols(), 10);
+    EXPECT_EQ(fl::StandardGaussian<double>().sample(7).rows(), 7);
+}
+
+// benchmark, run with --gtest_also_run_disabled_tests
+TEST(ZigguratNormalDistributionTests, DISABLED_throughput)
+{
+    fl::mt11213b generator(5);
+    std::normal_distribution<double> std_normal;
+    fl::ZigguratNormalDistribution<double> ziggurat_normal;
+
+    std::vector<double> samples(SAMPLE_COUNT);
+
+    std::clock_t start = std::clock();
+    for (auto& x : samples) x = std_normal(generator);
+    const double std_time = (std::clock() - start) / double(CLOCKS_PER_SEC);
+
+    start = std::clock();
+    for (auto& x : samples) x = ziggurat_normal(generator);
+    const double ziggurat_time =
+        (std::clock() - start) / double(CLOCKS_PER_SEC);
+
+    start = std::clock();
+    ziggurat_normal.fill(generator, samples.data(), samples.size());
+    const double fill_time = (std::clock() - start) / double(CLOCKS_PER_SEC);
+
+    std::cout << SAMPLE_COUNT << " normal samples: "
+              << "std::normal_distribution " << std_time << " s, "
+              << "ziggurat " << ziggurat_time << " s, "
+              << "ziggurat fill " << fill_time << " s" << std::endl;
+}
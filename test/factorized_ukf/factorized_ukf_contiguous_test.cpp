@@ -0,0 +1,116 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file factorized_ukf_contiguous_test.cpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#include <gtest/gtest.h>
+
+#include "factorized_ukf_models.hpp"
+
+typedef fl::FactorizedUkfTestFilter<
+            Eigen::VectorXd, Eigen::VectorXd, Eigen::VectorXd
+        > Filter;
+typedef Filter::StateDistribution StateDistribution;
+typedef Filter::ContiguousStateDistribution ContiguousStateDistribution;
+
+enum : size_t { DimA = 3, DimB = 2, DimY = 2, Partitions = 300 };
+
+template <typename Left, typename Right>
+void expect_equal_partitions(const Left& left, const Right& right)
+{
+    EXPECT_TRUE(left.mean_a.isApprox(right.mean_a, 1e-12));
+    EXPECT_TRUE(left.cov_aa.isApprox(right.cov_aa, 1e-12));
+
+    ASSERT_EQ(left.count_partitions(), right.count_partitions());
+    for (size_t i = 0; i < left.count_partitions(); ++i)
+    {
+        auto&& l = left.partition(i);
+        auto&& r = right.partition(i);
+
+        EXPECT_TRUE(l.mean_b.isApprox(r.mean_b, 1e-12)) << "partition " << i;
+        EXPECT_TRUE(l.mean_y.isApprox(r.mean_y, 1e-12)) << "partition " << i;
+        EXPECT_TRUE(l.cov_ab.isApprox(r.cov_ab, 1e-12)) << "partition " << i;
+        EXPECT_TRUE(l.cov_ay.isApprox(r.cov_ay, 1e-12)) << "partition " << i;
+        EXPECT_TRUE(l.cov_bb.isApprox(r.cov_bb, 1e-12)) << "partition " << i;
+        EXPECT_TRUE(l.cov_by.isApprox(r.cov_by, 1e-12)) << "partition " << i;
+        EXPECT_TRUE(l.cov_yy.isApprox(r.cov_yy, 1e-12)) << "partition " << i;
+    }
+}
+
+TEST(FactorizedUkfContiguousTests, layout)
+{
+    const ContiguousStateDistribution state =
+        fl::factorized_ukf_test_prior<ContiguousStateDistribution>(
+            DimA, DimB, Partitions);
+
+    EXPECT_EQ(Partitions, state.count_partitions());
+    EXPECT_EQ(DimB, state.b_i_dimension());
+    EXPECT_EQ(int(DimB), state.means_b.rows());
+    EXPECT_EQ(int(DimB * Partitions), state.covs_bb.cols());
+
+    // the blocks of a partition refer to the contiguous buffers
+    EXPECT_EQ(state.means_b.data() + 5 * DimB,
+              state.partition(5).mean_b.data());
+    EXPECT_EQ(state.covs_bb.data() + 5 * DimB * DimB,
+              state.partition(5).cov_bb.data());
+}
+
+TEST(FactorizedUkfContiguousTests, prediction_equals_array_of_structs)
+{
+    Filter filter(DimA, DimB, DimY);
+
+    const StateDistribution prior =
+        fl::factorized_ukf_test_prior<StateDistribution>(
+            DimA, DimB, Partitions);
+    const ContiguousStateDistribution contiguous_prior =
+        fl::factorized_ukf_test_prior<ContiguousStateDistribution>(
+            DimA, DimB, Partitions);
+
+    StateDistribution prediction;
+    ContiguousStateDistribution contiguous_prediction;
+    filter.Predict(prior, 0.1, prediction);
+    filter.Predict(contiguous_prior, 0.1, contiguous_prediction);
+
+    expect_equal_partitions(prediction, contiguous_prediction);
+}
+
+TEST(FactorizedUkfContiguousTests, update_equals_array_of_structs)
+{
+    Filter filter(DimA, DimB, DimY);
+
+    StateDistribution state =
+        fl::factorized_ukf_test_prior<StateDistribution>(
+            DimA, DimB, Partitions);
+    ContiguousStateDistribution contiguous_state =
+        fl::factorized_ukf_test_prior<ContiguousStateDistribution>(
+            DimA, DimB, Partitions);
+
+    for (int step = 0; step < 3; ++step)
+    {
+        filter.Predict(state, 0.1, state);
+        filter.Predict(contiguous_state, 0.1, contiguous_state);
+
+        const Eigen::MatrixXd y = fl::factorized_ukf_test_measurement(state);
+
+        EXPECT_TRUE(filter.Update(state, y, state));
+        EXPECT_TRUE(filter.Update(contiguous_state, y, contiguous_state));
+
+        expect_equal_partitions(state, contiguous_state);
+    }
+}
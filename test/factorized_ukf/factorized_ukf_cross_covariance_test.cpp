@@ -0,0 +1,112 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file factorized_ukf_cross_covariance_test.cpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#include <gtest/gtest.h>
+
+#include "factorized_ukf_models.hpp"
+
+typedef fl::FactorizedUkfTestFilter<
+            Eigen::VectorXd, Eigen::VectorXd, Eigen::VectorXd
+        > Filter;
+typedef Filter::StateDistribution StateDistribution;
+
+typedef fl::FactorizedUkfTestFilter<
+            Eigen::VectorXd, Eigen::Matrix<double, 1, 1>,
+            Eigen::Matrix<double, 1, 1>
+        > ScalarFilter;
+typedef ScalarFilter::StateDistribution ScalarStateDistribution;
+
+enum : size_t { DimA = 3, DimB = 2, DimY = 2, Partitions = 50 };
+
+/**
+ * Predicts serially and compares the covariances of the last partition
+ * with the dense products of its full normalized sigma points, which are
+ * left in the workspace of the calling thread
+ */
+template <typename TestFilter, typename Distribution>
+void expect_dense_covariances(size_t dim_b, size_t dim_y)
+{
+    TestFilter filter(DimA, dim_b, dim_y);
+
+    const Distribution prior =
+        fl::factorized_ukf_test_prior<Distribution>(DimA, dim_b, Partitions);
+
+    Distribution prediction;
+    filter.Predict(prior, 0.1, prediction);
+
+    const Eigen::MatrixXd& X_a = filter.X_a_norm_;
+    const Eigen::MatrixXd& X_b_i = filter.workspaces_[0].X_b_i;
+    const Eigen::MatrixXd& Y = filter.workspaces_[0].Y;
+
+    // the compressed points are considerably smaller than the full ones
+    EXPECT_LT(filter.workspaces_[0].X_b_i_compressed.cols(), X_b_i.cols());
+
+    auto&& partition = prediction.partition(Partitions - 1);
+
+    EXPECT_TRUE(partition.cov_ab.isApprox(X_a * X_b_i.transpose(), 1e-12));
+    EXPECT_TRUE(partition.cov_ay.isApprox(X_a * Y.transpose(), 1e-12));
+    EXPECT_TRUE(partition.cov_bb.isApprox(X_b_i * X_b_i.transpose(), 1e-12));
+    EXPECT_TRUE(partition.cov_by.isApprox(X_b_i * Y.transpose(), 1e-12));
+    EXPECT_TRUE(partition.cov_yy.isApprox(Y * Y.transpose(), 1e-12));
+}
+
+TEST(FactorizedUkfCrossCovarianceTests, compressed_equals_dense)
+{
+    expect_dense_covariances<Filter, StateDistribution>(DimB, DimY);
+}
+
+TEST(FactorizedUkfCrossCovarianceTests, scalar_compressed_equals_dense)
+{
+    expect_dense_covariances<ScalarFilter, ScalarStateDistribution>(1, 1);
+}
+
+TEST(FactorizedUkfCrossCovarianceTests, compressed_products)
+{
+    Filter filter(DimA, DimB, DimY);
+
+    // joint dimension of [a  Q_a  b_i  Q_b_i  R_y_i]
+    const size_t joint_dimension = DimA + DimA + DimB + DimB + DimY;
+    const size_t offset = DimA + DimA;
+    const size_t dimension = DimB + DimB;
+
+    // arbitrary points X and points Z which differ from a common point only
+    // in the columns of the [b_i  Q_b_i] partition
+    const Eigen::MatrixXd X =
+        Eigen::MatrixXd::Random(DimA, 2 * joint_dimension + 1);
+    Eigen::MatrixXd Z =
+        Eigen::VectorXd::Random(DimB).replicate(1, 2 * joint_dimension + 1);
+    Z.col(0).setRandom();
+    Z.middleCols(1 + offset, dimension).setRandom();
+    Z.middleCols(1 + joint_dimension + offset, dimension).setRandom();
+
+    Eigen::MatrixXd X_compressed;
+    Eigen::MatrixXd Z_compressed;
+    filter.CompressSigmaPoints(X, false, X_compressed);
+    filter.CompressSigmaPoints(Z, true, Z_compressed);
+
+    EXPECT_EQ(int(2 * dimension + 2), X_compressed.cols());
+    EXPECT_EQ(int(2 * dimension + 2), Z_compressed.cols());
+
+    EXPECT_TRUE((X_compressed * Z_compressed.transpose())
+                    .isApprox(X * Z.transpose(), 1e-12));
+    EXPECT_TRUE((Z_compressed * Z_compressed.transpose())
+                    .isApprox(Z * Z.transpose(), 1e-12));
+}
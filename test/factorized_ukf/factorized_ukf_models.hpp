@@ -0,0 +1,250 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file factorized_ukf_models.hpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#ifndef FL__TEST__FACTORIZED_UKF__FACTORIZED_UKF_MODELS_HPP
+#define FL__TEST__FACTORIZED_UKF__FACTORIZED_UKF_MODELS_HPP
+
+#include <Eigen/Dense>
+
+#include <cmath>
+#include <memory>
+#include <cstddef>
+
+#include <fl/util/traits.hpp>
+#include <fl/distribution/interface/standard_gaussian_mapping.hpp>
+#include <ff/filters/deterministic/factorized_unscented_kalman_filter.hpp>
+
+namespace fl
+{
+
+template <typename State> class FactorizedUkfTestProcessModel;
+template <typename StateA, typename StateB, typename Obsrv>
+class FactorizedUkfTestObservationModel;
+
+template <typename State_>
+struct Traits<FactorizedUkfTestProcessModel<State_>>
+{
+    typedef State_ State;
+    typedef State_ Noise;
+    typedef State_ Input;
+    typedef typename State_::Scalar Scalar;
+};
+
+/**
+ * \brief Mildly nonlinear process model \f$x_{t+1} = x_t + \Delta t\, 0.1
+ * \sin(x_t) + 0.1 v_t\f$ with the interface expected by the factorized UKF.
+ * The model stores the conditioned state and is therefore not thread safe.
+ */
+template <typename State_>
+class FactorizedUkfTestProcessModel
+    : public StandardGaussianMapping<State_, State_>
+{
+public:
+    typedef State_ State;
+    typedef State_ Noise;
+    typedef State_ Input;
+
+    explicit FactorizedUkfTestProcessModel(
+            size_t dimension = DimensionOf<State>())
+        : StandardGaussianMapping<State, Noise>(dimension),
+          dimension_(dimension),
+          delta_time_(0.),
+          state_(State::Zero(dimension, 1))
+    { }
+
+    void condition(double delta_time, const State& state, const Input&)
+    {
+        delta_time_ = delta_time;
+        state_ = state;
+    }
+
+    State map_standard_normal(const Noise& noise) const
+    {
+        return state_
+               + delta_time_ * 0.1 * state_.array().sin().matrix()
+               + 0.1 * noise;
+    }
+
+    size_t dimension() const { return dimension_; }
+    size_t InputDimension() const { return dimension_; }
+
+    bool is_thread_safe() const { return false; }
+
+    std::shared_ptr<FactorizedUkfTestProcessModel> clone() const
+    {
+        return std::make_shared<FactorizedUkfTestProcessModel>(*this);
+    }
+
+    /* the model has no parameters which could change */
+    size_t version() const { return 0; }
+
+protected:
+    size_t dimension_;
+    double delta_time_;
+    State state_;
+};
+
+/**
+ * \brief Observation model \f$y_i = b_i + 0.5 \sin(\sum a + 0.01 i) + 0.05
+ * w_i\f$ with the interface expected by the factorized UKF. The first
+ * dim(y_i) components of b_i are observed. The model stores the conditioned
+ * state and is therefore not thread safe.
+ */
+template <typename StateA, typename StateB, typename Obsrv>
+class FactorizedUkfTestObservationModel
+    : public StandardGaussianMapping<Obsrv, Obsrv>
+{
+public:
+    typedef Obsrv Observation;
+    typedef Obsrv Noise;
+
+    explicit FactorizedUkfTestObservationModel(
+            size_t dimension = DimensionOf<Obsrv>())
+        : StandardGaussianMapping<Obsrv, Obsrv>(dimension),
+          dimension_(dimension),
+          offset_(0.)
+    { }
+
+    void condition(const StateA& a, const StateB& b, size_t, size_t index)
+    {
+        offset_ = 0.5 * std::sin(a.sum() + 0.01 * double(index));
+        b_ = b;
+    }
+
+    Observation map_standard_normal(const Noise& noise) const
+    {
+        Observation y = b_.topRows(dimension_);
+        y.array() += offset_;
+
+        return y + 0.05 * noise;
+    }
+
+    size_t dimension() const { return dimension_; }
+
+    bool is_thread_safe() const { return false; }
+
+    std::shared_ptr<FactorizedUkfTestObservationModel> clone() const
+    {
+        return std::make_shared<FactorizedUkfTestObservationModel>(*this);
+    }
+
+    /* the model has no parameters which could change */
+    size_t version() const { return 0; }
+
+protected:
+    size_t dimension_;
+    double offset_;
+    StateB b_;
+};
+
+/**
+ * \brief Factorized UKF using the test models
+ */
+template <typename StateA, typename StateB, typename Obsrv>
+class FactorizedUkfTestFilter
+    : public FactorizedUnscentedKalmanFilter<
+                 FactorizedUkfTestProcessModel<StateA>,
+                 FactorizedUkfTestProcessModel<StateB>,
+                 FactorizedUkfTestObservationModel<StateA, StateB, Obsrv>>
+{
+public:
+    typedef FactorizedUnscentedKalmanFilter<
+                FactorizedUkfTestProcessModel<StateA>,
+                FactorizedUkfTestProcessModel<StateB>,
+                FactorizedUkfTestObservationModel<StateA, StateB, Obsrv>
+            > Base;
+
+    FactorizedUkfTestFilter(size_t dim_a, size_t dim_b, size_t dim_y)
+        : Base(std::make_shared<FactorizedUkfTestProcessModel<StateA>>(dim_a),
+               std::make_shared<FactorizedUkfTestProcessModel<StateB>>(dim_b),
+               std::make_shared<
+                   FactorizedUkfTestObservationModel<StateA, StateB, Obsrv>
+               >(dim_y))
+    { }
+
+    /* internals exposed to the tests */
+    using Base::AccumulateInformation;
+    using Base::CompressSigmaPoints;
+    using Base::workspaces_;
+};
+
+/**
+ * \return Prior with the given number of partitions. Each partition has its
+ *         own mean and covariance.
+ */
+template <typename Distribution>
+Distribution factorized_ukf_test_prior(size_t dim_a,
+                                       size_t dim_b,
+                                       size_t count)
+{
+    typedef typename Distribution::Cov_aa Cov_aa;
+    typedef typename Distribution::Cov_bb Cov_bb;
+
+    Distribution prior;
+    prior.initialize(Eigen::VectorXd::LinSpaced(dim_a, -0.5, 0.5),
+                     count,
+                     Eigen::VectorXd::Zero(dim_b),
+                     0.2,
+                     0.1);
+
+    Cov_aa cov_aa = Cov_aa::Constant(dim_a, dim_a, 0.02);
+    cov_aa.diagonal().array() += 0.2;
+    prior.cov_aa = cov_aa;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto&& partition = prior.partition(i);
+
+        partition.mean_b.setConstant(std::sin(0.1 * double(i)));
+
+        Cov_bb cov_bb = Cov_bb::Constant(dim_b, dim_b, 0.01);
+        cov_bb.diagonal().array() += 0.05 + 0.001 * double(i % 7);
+        partition.cov_bb = cov_bb;
+    }
+
+    return prior;
+}
+
+/**
+ * \return Measurements close to the predicted observations such that every
+ *         partition passes the innovation gate of the filter
+ */
+template <typename Distribution>
+Eigen::MatrixXd factorized_ukf_test_measurement(
+        const Distribution& predicted_state)
+{
+    const size_t count = predicted_state.count_partitions();
+    const size_t dim_y = predicted_state.partition(0).mean_y.rows();
+
+    Eigen::MatrixXd y(count * dim_y, 1);
+    for (size_t i = 0; i < count; ++i)
+    {
+        y.middleRows(i * dim_y, dim_y) =
+            predicted_state.partition(i).mean_y.array()
+            + 0.02 * std::cos(0.3 * double(i));
+    }
+
+    return y;
+}
+
+}
+
+#endif
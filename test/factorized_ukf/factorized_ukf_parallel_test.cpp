@@ -0,0 +1,113 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file factorized_ukf_parallel_test.cpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <iostream>
+
+#include <fl/util/thread_pool.hpp>
+
+#include "factorized_ukf_models.hpp"
+
+typedef fl::FactorizedUkfTestFilter<
+            Eigen::VectorXd, Eigen::VectorXd, Eigen::VectorXd
+        > Filter;
+typedef Filter::StateDistribution StateDistribution;
+
+enum : size_t { DimA = 3, DimB = 2, DimY = 2, Partitions = 1000 };
+
+void expect_identical(const StateDistribution& left,
+                      const StateDistribution& right)
+{
+    EXPECT_TRUE(left.mean_a == right.mean_a);
+    EXPECT_TRUE(left.cov_aa == right.cov_aa);
+
+    ASSERT_EQ(left.count_partitions(), right.count_partitions());
+    for (size_t i = 0; i < left.count_partitions(); ++i)
+    {
+        auto&& l = left.partition(i);
+        auto&& r = right.partition(i);
+
+        EXPECT_TRUE(l.mean_b == r.mean_b) << "partition " << i;
+        EXPECT_TRUE(l.mean_y == r.mean_y) << "partition " << i;
+        EXPECT_TRUE(l.cov_ab == r.cov_ab) << "partition " << i;
+        EXPECT_TRUE(l.cov_ay == r.cov_ay) << "partition " << i;
+        EXPECT_TRUE(l.cov_bb == r.cov_bb) << "partition " << i;
+        EXPECT_TRUE(l.cov_by == r.cov_by) << "partition " << i;
+        EXPECT_TRUE(l.cov_yy == r.cov_yy) << "partition " << i;
+    }
+}
+
+TEST(FactorizedUkfParallelTests, parallel_prediction_is_bitwise_serial)
+{
+    const StateDistribution prior =
+        fl::factorized_ukf_test_prior<StateDistribution>(
+            DimA, DimB, Partitions);
+
+    Filter serial_filter(DimA, DimB, DimY);
+    StateDistribution serial_prediction;
+    serial_filter.Predict(prior, 0.1, serial_prediction);
+
+    for (size_t threads: {2, 3, 8})
+    {
+        Filter parallel_filter(DimA, DimB, DimY);
+        parallel_filter.thread_pool(std::make_shared<fl::ThreadPool>(threads));
+
+        // two steps to reuse the worker instances and workspaces
+        StateDistribution parallel_prediction;
+        parallel_filter.Predict(prior, 0.1, parallel_prediction);
+        parallel_filter.Predict(prior, 0.1, parallel_prediction);
+
+        expect_identical(serial_prediction, parallel_prediction);
+    }
+}
+
+// benchmark, run with --gtest_also_run_disabled_tests
+TEST(FactorizedUkfParallelTests, DISABLED_thread_scaling)
+{
+    const size_t partitions = 5000;
+    const StateDistribution prior =
+        fl::factorized_ukf_test_prior<StateDistribution>(
+            DimA, DimB, partitions);
+
+    for (size_t threads: {1, 2, 4, 8, 16})
+    {
+        Filter filter(DimA, DimB, DimY);
+        filter.thread_pool(std::make_shared<fl::ThreadPool>(threads));
+
+        StateDistribution prediction;
+        filter.Predict(prior, 0.1, prediction);
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int step = 0; step < 5; ++step)
+        {
+            filter.Predict(prior, 0.1, prediction);
+        }
+        const double time = std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - start)
+                                .count() / 5.;
+
+        std::cout << partitions << " partitions, " << threads << " threads: "
+                  << time << " s per prediction" << std::endl;
+    }
+}
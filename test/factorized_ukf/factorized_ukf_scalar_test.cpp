@@ -0,0 +1,166 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file factorized_ukf_scalar_test.cpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#include <gtest/gtest.h>
+
+#include "factorized_ukf_models.hpp"
+
+typedef Eigen::Matrix<double, 1, 1> Scalar1;
+
+typedef fl::FactorizedUkfTestFilter<
+            Eigen::VectorXd, Scalar1, Scalar1
+        > ScalarFilter;
+
+typedef fl::FactorizedUkfTestFilter<
+            Eigen::VectorXd, Eigen::VectorXd, Eigen::VectorXd
+        > GenericFilter;
+
+typedef ScalarFilter::StateDistribution ScalarState;
+typedef GenericFilter::StateDistribution GenericState;
+
+enum : size_t { DimA = 3, Partitions = 400 };
+
+TEST(FactorizedUkfScalarTests, specialization_selection)
+{
+    EXPECT_TRUE(ScalarFilter::ScalarPartitions);
+    EXPECT_FALSE(GenericFilter::ScalarPartitions);
+}
+
+template <typename Left, typename Right>
+void expect_equal_partitions(const Left& left, const Right& right)
+{
+    ASSERT_EQ(left.count_partitions(), right.count_partitions());
+    for (size_t i = 0; i < left.count_partitions(); ++i)
+    {
+        auto&& l = left.partition(i);
+        auto&& r = right.partition(i);
+
+        EXPECT_TRUE(l.mean_b.isApprox(r.mean_b, 1e-10)) << "partition " << i;
+        EXPECT_TRUE(l.cov_bb.isApprox(r.cov_bb, 1e-10)) << "partition " << i;
+    }
+}
+
+TEST(FactorizedUkfScalarTests, prediction_equals_generic_path)
+{
+    ScalarFilter scalar_filter(DimA, 1, 1);
+    GenericFilter generic_filter(DimA, 1, 1);
+
+    ScalarState scalar_state =
+        fl::factorized_ukf_test_prior<ScalarState>(DimA, 1, Partitions);
+    GenericState generic_state =
+        fl::factorized_ukf_test_prior<GenericState>(DimA, 1, Partitions);
+
+    scalar_filter.Predict(scalar_state, 0.1, scalar_state);
+    generic_filter.Predict(generic_state, 0.1, generic_state);
+
+    EXPECT_TRUE(scalar_state.mean_a.isApprox(generic_state.mean_a, 1e-12));
+    EXPECT_TRUE(scalar_state.cov_aa.isApprox(generic_state.cov_aa, 1e-12));
+
+    expect_equal_partitions(scalar_state, generic_state);
+    for (size_t i = 0; i < Partitions; ++i)
+    {
+        auto&& s = scalar_state.partition(i);
+        auto&& g = generic_state.partition(i);
+
+        EXPECT_TRUE(s.mean_y.isApprox(g.mean_y, 1e-12));
+        EXPECT_TRUE(s.cov_ab.isApprox(g.cov_ab, 1e-12));
+        EXPECT_TRUE(s.cov_ay.isApprox(g.cov_ay, 1e-12));
+        EXPECT_TRUE(s.cov_by.isApprox(g.cov_by, 1e-12));
+        EXPECT_TRUE(s.cov_yy.isApprox(g.cov_yy, 1e-12));
+    }
+}
+
+TEST(FactorizedUkfScalarTests, update_b_equals_generic_path)
+{
+    ScalarFilter scalar_filter(DimA, 1, 1);
+    GenericFilter generic_filter(DimA, 1, 1);
+
+    ScalarState scalar_predicted =
+        fl::factorized_ukf_test_prior<ScalarState>(DimA, 1, Partitions);
+    scalar_filter.Predict(scalar_predicted, 0.1, scalar_predicted);
+
+    const Eigen::MatrixXd y =
+        fl::factorized_ukf_test_measurement(scalar_predicted);
+
+    ScalarState scalar_posterior = scalar_predicted;
+    ASSERT_TRUE(scalar_filter.Update_a(scalar_predicted, y, scalar_posterior));
+
+    // identical predicted states and cohesive posteriors for both paths
+    GenericState generic_predicted;
+    generic_predicted.mean_a = scalar_predicted.mean_a;
+    generic_predicted.mean_a_predicted = scalar_predicted.mean_a_predicted;
+    generic_predicted.cov_aa = scalar_predicted.cov_aa;
+    generic_predicted.resize_partitions(Partitions, 1, 1);
+    for (size_t i = 0; i < Partitions; ++i)
+    {
+        auto&& s = scalar_predicted.partition(i);
+        auto&& g = generic_predicted.partition(i);
+
+        g.mean_b = s.mean_b;
+        g.mean_y = s.mean_y;
+        g.cov_ab = s.cov_ab;
+        g.cov_ay = s.cov_ay;
+        g.cov_bb = s.cov_bb;
+        g.cov_by = s.cov_by;
+        g.cov_yy = s.cov_yy;
+    }
+
+    GenericState generic_posterior = generic_predicted;
+    generic_posterior.mean_a = scalar_posterior.mean_a;
+    generic_posterior.cov_aa = scalar_posterior.cov_aa;
+    generic_posterior.cov_aa_inverse = scalar_posterior.cov_aa_inverse;
+
+    scalar_filter.Update_b(scalar_predicted, y, scalar_posterior);
+    generic_filter.Update_b(generic_predicted, y, generic_posterior);
+
+    expect_equal_partitions(scalar_posterior, generic_posterior);
+
+    // the update must have changed the partitions
+    EXPECT_FALSE(scalar_posterior.partition(0).mean_b.isApprox(
+                     scalar_predicted.partition(0).mean_b));
+}
+
+TEST(FactorizedUkfScalarTests, filter_step_equals_generic_path)
+{
+    ScalarFilter scalar_filter(DimA, 1, 1);
+    GenericFilter generic_filter(DimA, 1, 1);
+
+    ScalarState scalar_state =
+        fl::factorized_ukf_test_prior<ScalarState>(DimA, 1, Partitions);
+    GenericState generic_state =
+        fl::factorized_ukf_test_prior<GenericState>(DimA, 1, Partitions);
+
+    for (int step = 0; step < 3; ++step)
+    {
+        scalar_filter.Predict(scalar_state, 0.1, scalar_state);
+        generic_filter.Predict(generic_state, 0.1, generic_state);
+
+        const Eigen::MatrixXd y =
+            fl::factorized_ukf_test_measurement(scalar_state);
+
+        scalar_filter.Update(scalar_state, y, scalar_state);
+        generic_filter.Update(generic_state, y, generic_state);
+
+        EXPECT_TRUE(scalar_state.mean_a.isApprox(generic_state.mean_a, 1e-10));
+        EXPECT_TRUE(scalar_state.cov_aa.isApprox(generic_state.cov_aa, 1e-10));
+        expect_equal_partitions(scalar_state, generic_state);
+    }
+}
@@ -0,0 +1,159 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file factorized_ukf_update_test.cpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <memory>
+
+#include <fl/util/thread_pool.hpp>
+
+#include "factorized_ukf_models.hpp"
+
+typedef fl::FactorizedUkfTestFilter<
+            Eigen::VectorXd, Eigen::VectorXd, Eigen::VectorXd
+        > Filter;
+typedef Filter::StateDistribution StateDistribution;
+
+enum : size_t { DimA = 3, DimB = 2, DimY = 2, Partitions = 600 };
+
+TEST(FactorizedUkfUpdateTests, update_with_valid_measurements)
+{
+    Filter filter(DimA, DimB, DimY);
+
+    StateDistribution state =
+        fl::factorized_ukf_test_prior<StateDistribution>(
+            DimA, DimB, Partitions);
+
+    filter.Predict(state, 0.1, state);
+    const Eigen::VectorXd predicted_mean_a = state.mean_a;
+
+    EXPECT_TRUE(filter.Update(
+                    state, fl::factorized_ukf_test_measurement(state), state));
+    EXPECT_FALSE(state.mean_a.isApprox(predicted_mean_a));
+}
+
+TEST(FactorizedUkfUpdateTests, update_without_valid_measurements)
+{
+    Filter filter(DimA, DimB, DimY);
+
+    StateDistribution state =
+        fl::factorized_ukf_test_prior<StateDistribution>(
+            DimA, DimB, Partitions);
+
+    filter.Predict(state, 0.1, state);
+    const StateDistribution predicted_state = state;
+
+    const Eigen::MatrixXd y = Eigen::MatrixXd::Constant(
+        Partitions * DimY, 1, std::numeric_limits<double>::quiet_NaN());
+
+    EXPECT_FALSE(filter.Update(predicted_state, y, state));
+    EXPECT_TRUE(state.mean_a == predicted_state.mean_a);
+    EXPECT_TRUE(state.cov_aa == predicted_state.cov_aa);
+}
+
+/**
+ * Adds distinct information terms of the i-th partition
+ */
+struct AccumulateTestTerms
+{
+    template <typename Accumulator>
+    void operator()(size_t i, Accumulator& accumulator) const
+    {
+        accumulator.C += term_C(i);
+        accumulator.D += term_D(i);
+        ++accumulator.count;
+    }
+
+    static Eigen::MatrixXd term_C(size_t i)
+    {
+        Eigen::MatrixXd C(DimA, DimA);
+        for (size_t r = 0; r < DimA; ++r)
+            for (size_t c = 0; c < DimA; ++c)
+                C(r, c) = std::sin(0.37 * double(i) + double(r * DimA + c));
+        return C;
+    }
+
+    static Eigen::VectorXd term_D(size_t i)
+    {
+        return Eigen::VectorXd::LinSpaced(DimA, 1., 2.) / double(i + 1);
+    }
+};
+
+TEST(FactorizedUkfUpdateTests, tree_reduction_equals_naive_sum)
+{
+    // several blocks of 256 partitions, the last one partially filled
+    const size_t count = 1500;
+
+    Eigen::MatrixXd naive_C = Eigen::MatrixXd::Zero(DimA, DimA);
+    Eigen::VectorXd naive_D = Eigen::VectorXd::Zero(DimA);
+    for (size_t i = 0; i < count; ++i)
+    {
+        naive_C += AccumulateTestTerms::term_C(i);
+        naive_D += AccumulateTestTerms::term_D(i);
+    }
+
+    Filter serial_filter(DimA, DimB, DimY);
+    auto&& serial = serial_filter.AccumulateInformation(
+                        count, AccumulateTestTerms());
+
+    EXPECT_EQ(count, serial.count);
+    EXPECT_TRUE(serial.C.isApprox(naive_C, 1e-12));
+    EXPECT_TRUE(serial.D.isApprox(naive_D, 1e-12));
+
+    Filter parallel_filter(DimA, DimB, DimY);
+    parallel_filter.thread_pool(std::make_shared<fl::ThreadPool>(3));
+    auto&& parallel = parallel_filter.AccumulateInformation(
+                          count, AccumulateTestTerms());
+
+    EXPECT_EQ(count, parallel.count);
+    EXPECT_TRUE(parallel.C == serial.C);
+    EXPECT_TRUE(parallel.D == serial.D);
+}
+
+TEST(FactorizedUkfUpdateTests, parallel_update_is_bitwise_serial)
+{
+    const StateDistribution prior =
+        fl::factorized_ukf_test_prior<StateDistribution>(
+            DimA, DimB, Partitions);
+
+    Filter serial_filter(DimA, DimB, DimY);
+    StateDistribution serial_state;
+    serial_filter.Predict(prior, 0.1, serial_state);
+    const Eigen::MatrixXd y = fl::factorized_ukf_test_measurement(serial_state);
+    serial_filter.Update(serial_state, y, serial_state);
+
+    Filter parallel_filter(DimA, DimB, DimY);
+    parallel_filter.thread_pool(std::make_shared<fl::ThreadPool>(4));
+    StateDistribution parallel_state;
+    parallel_filter.Predict(prior, 0.1, parallel_state);
+    parallel_filter.Update(parallel_state, y, parallel_state);
+
+    EXPECT_TRUE(parallel_state.mean_a == serial_state.mean_a);
+    EXPECT_TRUE(parallel_state.cov_aa == serial_state.cov_aa);
+    for (size_t i = 0; i < Partitions; ++i)
+    {
+        EXPECT_TRUE(parallel_state.partition(i).mean_b
+                    == serial_state.partition(i).mean_b);
+        EXPECT_TRUE(parallel_state.partition(i).cov_bb
+                    == serial_state.partition(i).cov_bb);
+    }
+}
@@ -0,0 +1,192 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file gaussian_filter_ukf_allocation_test.cpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#include <new>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/*
+ * Counts the heap allocations while enabled. Eigen allocates through
+ * std::malloc and bypasses operator new. Its allocations are reported by the
+ * runtime malloc check instead which is routed into the same counter.
+ */
+static bool count_allocations = false;
+static int allocations = 0;
+
+static void eigen_assertion(bool condition, const char* message)
+{
+    if (condition) return;
+
+    if (std::strstr(message, "heap allocation"))
+    {
+        ++allocations;
+        return;
+    }
+
+    std::fprintf(stderr, "Eigen assertion failed: %s\n", message);
+    std::abort();
+}
+
+#define EIGEN_RUNTIME_NO_MALLOC
+#define eigen_assert(x) eigen_assertion(bool(x), #x)
+
+void* operator new(std::size_t size)
+{
+    if (count_allocations) ++allocations;
+
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Dense>
+
+#include <memory>
+
+#include <fl/model/process/linear_process_model.hpp>
+#include <fl/model/observation/linear_observation_model.hpp>
+#include <fl/filter/gaussian/gaussian_filter.hpp>
+#include <fl/filter/gaussian/unscented_transform.hpp>
+#include <fl/util/thread_pool.hpp>
+
+typedef Eigen::Matrix<double, 3, 1> State;
+typedef Eigen::Matrix<double, 1, 1> Input;
+
+void begin_counting()
+{
+    allocations = 0;
+    count_allocations = true;
+    Eigen::internal::set_is_malloc_allowed(false);
+}
+
+int end_counting()
+{
+    Eigen::internal::set_is_malloc_allowed(true);
+    count_allocations = false;
+    return allocations;
+}
+
+/**
+ * \return Number of heap allocations of the given number of fixed-size
+ *         filter steps after one warm up step
+ */
+template <typename Obsrv, typename Filter>
+int count_step_allocations(Filter& filter, int steps)
+{
+    filter.threshold = 1.e9;
+    filter.inv_sigma = 1.e-12;
+
+    typename Filter::StateDistribution state_distr;
+    const Input u = Input::Zero();
+    Obsrv y = Obsrv::Ones();
+
+    filter.predict(1.0, u, state_distr, state_distr);
+    filter.update(y, state_distr, state_distr);
+
+    begin_counting();
+    for (int i = 0; i < steps; ++i)
+    {
+        filter.predict(1.0, u, state_distr, state_distr);
+        filter.update(y, state_distr, state_distr);
+        y = -y;
+    }
+    return end_counting();
+}
+
+/**
+ * Linear filter setup, optionally with the filter form tag, e.g.
+ * fl::SquareRootCovariance
+ */
+template <typename Obsrv, typename... Form>
+struct FilterOf
+{
+    typedef fl::LinearGaussianProcessModel<State, Input> ProcessModel;
+    typedef fl::LinearGaussianObservationModel<Obsrv, State> ObsrvModel;
+
+    typedef fl::GaussianFilter<
+                ProcessModel, ObsrvModel, fl::UnscentedTransform, Form...
+            > Type;
+
+    static Type create()
+    {
+        return Type(
+            std::make_shared<ProcessModel>(
+                ProcessModel::SecondMoment::Identity()),
+            std::make_shared<ObsrvModel>(
+                ObsrvModel::SecondMoment::Identity()),
+            std::make_shared<fl::UnscentedTransform>());
+    }
+};
+
+TEST(GaussianFilterUkfAllocationTests, counter_detects_eigen_allocations)
+{
+    begin_counting();
+    Eigen::MatrixXd m(4, 4);
+    const int count = end_counting();
+
+    EXPECT_EQ(count, 1);
+    EXPECT_EQ(m.size(), 16);
+}
+
+TEST(GaussianFilterUkfAllocationTests, fixed_size_step_is_allocation_free)
+{
+    typedef Eigen::Matrix<double, 2, 1> Obsrv;
+
+    auto filter = FilterOf<Obsrv>::create();
+
+    EXPECT_EQ(count_step_allocations<Obsrv>(filter, 5), 0);
+}
+
+TEST(GaussianFilterUkfAllocationTests, scalar_obsrv_step_is_allocation_free)
+{
+    typedef Eigen::Matrix<double, 1, 1> Obsrv;
+
+    auto filter = FilterOf<Obsrv>::create();
+
+    EXPECT_EQ(count_step_allocations<Obsrv>(filter, 5), 0);
+}
+
+TEST(GaussianFilterUkfAllocationTests, square_root_step_is_allocation_free)
+{
+    typedef Eigen::Matrix<double, 2, 1> Obsrv;
+
+    auto filter = FilterOf<Obsrv, fl::SquareRootCovariance>::create();
+
+    EXPECT_EQ(count_step_allocations<Obsrv>(filter, 5), 0);
+}
+
+TEST(GaussianFilterUkfAllocationTests, pooled_step_is_allocation_free)
+{
+    typedef Eigen::Matrix<double, 2, 1> Obsrv;
+
+    auto filter = FilterOf<Obsrv>::create();
+    filter.thread_pool(std::make_shared<fl::ThreadPool>(2));
+
+    EXPECT_EQ(count_step_allocations<Obsrv>(filter, 5), 0);
+}
@@ -0,0 +1,240 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file gaussian_filter_ukf_npn_aon_test.cpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Dense>
+
+#include <memory>
+
+#include <fl/util/traits.hpp>
+#include <fl/model/process/linear_process_model.hpp>
+#include <fl/model/observation/observation_model_interface.hpp>
+#include <fl/filter/gaussian/gaussian_filter.hpp>
+#include <fl/filter/gaussian/unscented_transform.hpp>
+
+typedef Eigen::Matrix<double, 3, 1> State;
+typedef Eigen::Matrix<double, 1, 1> Input;
+typedef Eigen::Matrix<double, Eigen::Dynamic, 1> Obsrv;
+
+typedef fl::LinearGaussianProcessModel<State, Input> ProcessModel;
+
+class AdditiveLinearObsrvModel;
+
+namespace fl
+{
+template <> struct Traits<AdditiveLinearObsrvModel>
+{
+    typedef ::State State;
+    typedef ::Obsrv Observation;
+    typedef ::Obsrv Noise;
+};
+}
+
+/**
+ * Linear observation model y = H x + v with additive noise
+ * v ~ N(0, diag(r))
+ */
+class AdditiveLinearObsrvModel
+    : public fl::ANObservationModelInterface<Obsrv, State, Obsrv>
+{
+public:
+    explicit AdditiveLinearObsrvModel(int obsrv_dim)
+        : H(Eigen::MatrixXd::Random(obsrv_dim, State::SizeAtCompileTime)),
+          r(Obsrv::Random(obsrv_dim).array().abs() + 0.5)
+    { }
+
+    virtual Obsrv predict_observation(const State& state,
+                                      const Obsrv& noise,
+                                      double delta_time)
+    {
+        return H * state + r.cwiseSqrt().asDiagonal() * noise;
+    }
+
+    virtual Obsrv predict_observation(const State& state, double delta_time)
+    {
+        return H * state;
+    }
+
+    virtual Obsrv noise_covariance_vector() const { return r; }
+
+    virtual size_t state_dimension() const { return H.cols(); }
+    virtual size_t noise_dimension() const { return H.rows(); }
+    virtual size_t observation_dimension() const { return H.rows(); }
+
+    Eigen::MatrixXd H;
+    Obsrv r;
+};
+
+typedef fl::GaussianFilter<
+            ProcessModel,
+            AdditiveLinearObsrvModel,
+            fl::UnscentedTransform,
+            fl::AdditiveObservationNoise
+        > Filter;
+
+typedef Filter::UpdateSpace UpdateSpace;
+
+Filter create_filter(int obsrv_dim)
+{
+    srand(0);
+
+    auto filter = Filter(
+        std::make_shared<ProcessModel>(ProcessModel::SecondMoment::Identity()),
+        std::make_shared<AdditiveLinearObsrvModel>(obsrv_dim),
+        std::make_shared<fl::UnscentedTransform>());
+
+    filter.threshold = 1.e9;
+    filter.inv_sigma = 1.e-12;
+
+    return filter;
+}
+
+/**
+ * Performs a predict and an update and returns the posterior
+ */
+Filter::StateDistribution step(Filter& filter, int obsrv_dim)
+{
+    Filter::StateDistribution state_distr;
+    state_distr.mean(State(1., -2., 0.5));
+
+    filter.predict(1.0, Input::Zero(), state_distr, state_distr);
+    filter.update(Obsrv::Ones(obsrv_dim), state_distr, state_distr);
+
+    return state_distr;
+}
+
+TEST(GaussianFilterUkfNpnAonTests, cheaper_update_space)
+{
+    EXPECT_EQ(Filter::cheaper_update_space(2, 13, 3), UpdateSpace::Observation);
+    EXPECT_EQ(Filter::cheaper_update_space(12, 13, 3), UpdateSpace::Observation);
+    EXPECT_EQ(Filter::cheaper_update_space(14, 13, 3), UpdateSpace::Point);
+    EXPECT_EQ(Filter::cheaper_update_space(100000, 13, 3), UpdateSpace::Point);
+}
+
+TEST(GaussianFilterUkfNpnAonTests, automatic_update_space_selection)
+{
+    auto small = create_filter(2);
+    auto large = create_filter(40);
+
+    EXPECT_EQ(small.last_update_space(), UpdateSpace::Automatic);
+
+    step(small, 2);
+    step(large, 40);
+
+    EXPECT_EQ(small.last_update_space(), UpdateSpace::Observation);
+    EXPECT_EQ(large.last_update_space(), UpdateSpace::Point);
+}
+
+void expect_update_spaces_agree(int obsrv_dim, UpdateSpace update_space)
+{
+    auto observation_space_filter = create_filter(obsrv_dim);
+    auto other_filter = create_filter(obsrv_dim);
+
+    observation_space_filter.update_space(UpdateSpace::Observation);
+    other_filter.update_space(update_space);
+
+    auto observation_space_posterior = step(observation_space_filter, obsrv_dim);
+    auto other_posterior = step(other_filter, obsrv_dim);
+
+    EXPECT_EQ(observation_space_filter.last_update_space(),
+              UpdateSpace::Observation);
+    EXPECT_EQ(other_filter.last_update_space(), update_space);
+
+    EXPECT_TRUE(observation_space_posterior.mean().isApprox(
+                    other_posterior.mean(), 1.e-9));
+    EXPECT_TRUE(observation_space_posterior.covariance().isApprox(
+                    other_posterior.covariance(), 1.e-9));
+}
+
+TEST(GaussianFilterUkfNpnAonTests, update_spaces_agree_small_obsrv)
+{
+    expect_update_spaces_agree(2, UpdateSpace::Point);
+}
+
+TEST(GaussianFilterUkfNpnAonTests, update_spaces_agree_large_obsrv)
+{
+    expect_update_spaces_agree(40, UpdateSpace::Point);
+}
+
+TEST(GaussianFilterUkfNpnAonTests, sequential_update_agrees)
+{
+    expect_update_spaces_agree(2, UpdateSpace::Sequential);
+    expect_update_spaces_agree(40, UpdateSpace::Sequential);
+}
+
+/**
+ * Updates the given predicted distribution and compares the posterior with
+ * the closed form Kalman update
+ */
+void expect_kalman_update(Filter& filter,
+                          const Filter::StateDistribution& predicted,
+                          int obsrv_dim)
+{
+    Filter::StateDistribution posterior;
+    filter.update(Obsrv::Ones(obsrv_dim), predicted, posterior);
+
+    const AdditiveLinearObsrvModel& model = *filter.observation_model();
+    const Eigen::MatrixXd P = predicted.covariance();
+    const Eigen::MatrixXd S =
+        model.H * P * model.H.transpose() + Eigen::MatrixXd(model.r.asDiagonal());
+    const Eigen::MatrixXd K = P * model.H.transpose() * S.inverse();
+
+    const State mean =
+        predicted.mean()
+        + K * (Obsrv::Ones(obsrv_dim) - model.H * predicted.mean());
+    const Eigen::MatrixXd covariance = P - K * S * K.transpose();
+
+    EXPECT_TRUE(posterior.mean().isApprox(mean, 1.e-9));
+    EXPECT_TRUE(posterior.covariance().isApprox(covariance, 1.e-9));
+}
+
+TEST(GaussianFilterUkfNpnAonTests, update_space_matches_kalman_update)
+{
+    const int obsrv_dim = 4;
+    auto filter = create_filter(obsrv_dim);
+
+    Filter::StateDistribution predicted;
+    predicted.mean(State(1., -2., 0.5));
+    filter.predict(1.0, Input::Zero(), predicted, predicted);
+
+    expect_kalman_update(filter, predicted, obsrv_dim);
+}
+
+TEST(GaussianFilterUkfNpnAonTests, update_without_prediction)
+{
+    const int obsrv_dim = 4;
+
+    Filter::StateDistribution predicted;
+    predicted.mean(State(1., -2., 0.5));
+    predicted.covariance(2. * Filter::StateDistribution::SecondMoment::Identity());
+
+    for (auto update_space: {UpdateSpace::Observation,
+                             UpdateSpace::Sequential,
+                             UpdateSpace::Point})
+    {
+        auto filter = create_filter(obsrv_dim);
+        filter.update_space(update_space);
+
+        expect_kalman_update(filter, predicted, obsrv_dim);
+        EXPECT_EQ(filter.last_update_space(), update_space);
+    }
+}
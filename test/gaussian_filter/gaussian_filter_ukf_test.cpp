@@ -0,0 +1,381 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file gaussian_filter_ukf_test.cpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Dense>
+
+#include <memory>
+
+#include <fl/model/process/linear_process_model.hpp>
+#include <fl/model/observation/linear_observation_model.hpp>
+#include <fl/filter/gaussian/gaussian_filter.hpp>
+#include <fl/filter/gaussian/unscented_transform.hpp>
+#include <fl/util/thread_pool.hpp>
+
+typedef Eigen::Matrix<double, 3, 1> State;
+typedef Eigen::Matrix<double, 1, 1> Input;
+typedef Eigen::Matrix<double, 2, 1> Obsrv;
+
+typedef fl::LinearGaussianProcessModel<State, Input> LinearProcessModel;
+typedef fl::LinearGaussianObservationModel<Obsrv, State> LinearObsrvModel;
+
+/**
+ * Linear process model counting the number of state predictions
+ */
+class CountingProcessModel
+    : public LinearProcessModel
+{
+public:
+    CountingProcessModel()
+        : LinearProcessModel(SecondMoment::Identity()),
+          evaluations(0)
+    { }
+
+    virtual State predict_state(double delta_time,
+                                const State& state,
+                                const Noise& noise,
+                                const Input& input)
+    {
+        ++evaluations;
+        return LinearProcessModel::predict_state(delta_time,
+                                                 state,
+                                                 noise,
+                                                 input);
+    }
+
+    virtual void predict_states(double delta_time,
+                                const Eigen::Ref<const StateMatrix>& states,
+                                const Eigen::Ref<const NoiseMatrix>& noises,
+                                const Input& input,
+                                Eigen::Ref<StateMatrix> predictions)
+    {
+        evaluations += states.cols();
+        LinearProcessModel::predict_states(delta_time,
+                                           states,
+                                           noises,
+                                           input,
+                                           predictions);
+    }
+
+    size_t evaluations;
+};
+
+/**
+ * Linear observation model counting the number of observation predictions
+ */
+class CountingObsrvModel
+    : public LinearObsrvModel
+{
+public:
+    CountingObsrvModel()
+        : LinearObsrvModel(SecondMoment::Identity()),
+          evaluations(0)
+    { }
+
+    virtual Obsrv predict_observation(const State& state,
+                                      const Noise& noise,
+                                      double delta_time)
+    {
+        ++evaluations;
+        return LinearObsrvModel::predict_observation(state, noise, delta_time);
+    }
+
+    virtual void predict_observations(
+        const Eigen::Ref<const StateMatrix>& states,
+        const Eigen::Ref<const NoiseMatrix>& noises,
+        double delta_time,
+        Eigen::Ref<ObservationMatrix> predictions)
+    {
+        evaluations += states.cols();
+        LinearObsrvModel::predict_observations(states,
+                                               noises,
+                                               delta_time,
+                                               predictions);
+    }
+
+    size_t evaluations;
+};
+
+namespace fl
+{
+template <> struct Traits<CountingProcessModel>
+    : Traits<LinearProcessModel> { };
+
+template <> struct Traits<CountingObsrvModel>
+    : Traits<LinearObsrvModel> { };
+}
+
+TEST(GaussianFilterUkfTests, duplicate_points_evaluated_once)
+{
+    typedef fl::GaussianFilter<
+                CountingProcessModel,
+                CountingObsrvModel,
+                fl::UnscentedTransform
+            > Filter;
+
+    auto process_model = std::make_shared<CountingProcessModel>();
+    auto obsrv_model = std::make_shared<CountingObsrvModel>();
+
+    Filter filter(process_model,
+                  obsrv_model,
+                  std::make_shared<fl::UnscentedTransform>());
+    filter.threshold = std::numeric_limits<double>::infinity();
+    filter.inv_sigma = 0.;
+
+    Filter::StateDistribution state_distr;
+
+    // joint dimension 3 + 3 + 2 = 8, hence 17 points. The observation noise
+    // partition yields 2 * 2 copies of the mean in the prediction and the
+    // state noise partition 2 * 3 copies in the update.
+    filter.predict(1.0, Input::Zero(), state_distr, state_distr);
+    EXPECT_EQ(17u - 4u, process_model->evaluations);
+
+    filter.update(Obsrv::Ones(), state_distr, state_distr);
+    EXPECT_EQ(17u - 6u, obsrv_model->evaluations);
+}
+
+TEST(GaussianFilterUkfTests, linear_models_match_kalman_filter)
+{
+    typedef fl::GaussianFilter<
+                LinearProcessModel,
+                LinearObsrvModel,
+                fl::UnscentedTransform
+            > UnscentedKalmanFilter;
+
+    typedef fl::GaussianFilter<
+                LinearProcessModel,
+                LinearObsrvModel
+            > KalmanFilter;
+
+    LinearProcessModel::SecondMoment Q;
+    Q.setRandom();
+    Q = Q * Q.transpose() + Q.Identity();
+
+    auto process_model = std::make_shared<LinearProcessModel>(Q);
+    auto obsrv_model = std::make_shared<LinearObsrvModel>(
+        LinearObsrvModel::SecondMoment::Identity());
+
+    process_model->A(LinearProcessModel::DynamicsMatrix::Random());
+    obsrv_model->H(LinearObsrvModel::SensorMatrix::Random());
+
+    UnscentedKalmanFilter ukf(process_model,
+                              obsrv_model,
+                              std::make_shared<fl::UnscentedTransform>());
+    ukf.threshold = std::numeric_limits<double>::infinity();
+    ukf.inv_sigma = 0.;
+
+    KalmanFilter kf(process_model, obsrv_model);
+
+    UnscentedKalmanFilter::StateDistribution ukf_distr;
+    KalmanFilter::StateDistribution kf_distr;
+
+    ukf_distr.mean(State::Ones());
+    kf_distr.mean(State::Ones());
+
+    for (int i = 0; i < 5; ++i)
+    {
+        const Obsrv y = Obsrv::Random();
+
+        ukf.predict(1.0, Input::Zero(), ukf_distr, ukf_distr);
+        kf.predict(1.0, Input::Zero(), kf_distr, kf_distr);
+
+        EXPECT_TRUE(ukf_distr.mean().isApprox(kf_distr.mean(), 1.e-9));
+        EXPECT_TRUE(ukf_distr.covariance().isApprox(kf_distr.covariance(), 1.e-9));
+
+        ukf.update(y, ukf_distr, ukf_distr);
+        kf.update(y, kf_distr, kf_distr);
+
+        EXPECT_TRUE(ukf_distr.mean().isApprox(kf_distr.mean(), 1.e-9));
+        EXPECT_TRUE(ukf_distr.covariance().isApprox(kf_distr.covariance(), 1.e-9));
+    }
+}
+
+TEST(GaussianFilterUkfTests, parallel_points_match_serial)
+{
+    typedef fl::GaussianFilter<
+                LinearProcessModel,
+                LinearObsrvModel,
+                fl::UnscentedTransform
+            > Filter;
+
+    LinearProcessModel::SecondMoment Q;
+    Q.setRandom();
+    Q = Q * Q.transpose() + Q.Identity();
+
+    auto process_model = std::make_shared<LinearProcessModel>(Q);
+    auto obsrv_model = std::make_shared<LinearObsrvModel>(
+        LinearObsrvModel::SecondMoment::Identity());
+
+    process_model->A(LinearProcessModel::DynamicsMatrix::Random());
+    obsrv_model->H(LinearObsrvModel::SensorMatrix::Random());
+
+    Filter serial(process_model,
+                  obsrv_model,
+                  std::make_shared<fl::UnscentedTransform>());
+    Filter parallel(process_model,
+                    obsrv_model,
+                    std::make_shared<fl::UnscentedTransform>());
+
+    serial.threshold = parallel.threshold =
+        std::numeric_limits<double>::infinity();
+    serial.inv_sigma = parallel.inv_sigma = 0.;
+
+    parallel.thread_pool(std::make_shared<fl::ThreadPool>(4));
+
+    Filter::StateDistribution serial_distr;
+    Filter::StateDistribution parallel_distr;
+
+    for (int i = 0; i < 5; ++i)
+    {
+        const Obsrv y = Obsrv::Random();
+
+        serial.predict(1.0, Input::Zero(), serial_distr, serial_distr);
+        parallel.predict(1.0, Input::Zero(), parallel_distr, parallel_distr);
+        serial.update(y, serial_distr, serial_distr);
+        parallel.update(y, parallel_distr, parallel_distr);
+
+        // each point is evaluated independently, the results are identical
+        EXPECT_EQ(serial_distr.mean(), parallel_distr.mean());
+        EXPECT_EQ(serial_distr.covariance(), parallel_distr.covariance());
+    }
+}
+
+TEST(GaussianFilterUkfTests, parallel_falls_back_to_serial)
+{
+    typedef fl::GaussianFilter<
+                CountingProcessModel,
+                CountingObsrvModel,
+                fl::UnscentedTransform
+            > Filter;
+
+    auto process_model = std::make_shared<CountingProcessModel>();
+    auto obsrv_model = std::make_shared<CountingObsrvModel>();
+
+    Filter filter(process_model,
+                  obsrv_model,
+                  std::make_shared<fl::UnscentedTransform>());
+    filter.threshold = std::numeric_limits<double>::infinity();
+    filter.inv_sigma = 0.;
+
+    // the counting models cannot be cloned into their own type and must
+    // therefore be evaluated by the calling thread only
+    filter.thread_pool(std::make_shared<fl::ThreadPool>(4));
+
+    Filter::StateDistribution state_distr;
+    filter.predict(1.0, Input::Zero(), state_distr, state_distr);
+    filter.update(Obsrv::Ones(), state_distr, state_distr);
+
+    EXPECT_EQ(17u - 4u, process_model->evaluations);
+    EXPECT_EQ(17u - 6u, obsrv_model->evaluations);
+}
+
+/**
+ * Runs the regular and the square root UKF side by side on random linear
+ * models
+ */
+void expect_square_root_ukf_matches_ukf(
+    const std::shared_ptr<fl::UnscentedTransform>& transform,
+    double threshold)
+{
+    typedef fl::GaussianFilter<
+                LinearProcessModel,
+                LinearObsrvModel,
+                fl::UnscentedTransform
+            > UnscentedKalmanFilter;
+
+    typedef fl::GaussianFilter<
+                LinearProcessModel,
+                LinearObsrvModel,
+                fl::UnscentedTransform,
+                fl::SquareRootCovariance
+            > SquareRootUnscentedKalmanFilter;
+
+    LinearProcessModel::SecondMoment Q;
+    Q.setRandom();
+    Q = Q * Q.transpose() + Q.Identity();
+
+    auto process_model = std::make_shared<LinearProcessModel>(Q);
+    auto obsrv_model = std::make_shared<LinearObsrvModel>(
+        LinearObsrvModel::SecondMoment::Identity());
+
+    process_model->A(LinearProcessModel::DynamicsMatrix::Random());
+    obsrv_model->H(LinearObsrvModel::SensorMatrix::Random());
+
+    UnscentedKalmanFilter ukf(process_model, obsrv_model, transform);
+    SquareRootUnscentedKalmanFilter sr_ukf(process_model,
+                                           obsrv_model,
+                                           transform);
+
+    ukf.threshold = sr_ukf.threshold = threshold;
+    ukf.inv_sigma = sr_ukf.inv_sigma = 10.;
+
+    UnscentedKalmanFilter::StateDistribution ukf_distr;
+    SquareRootUnscentedKalmanFilter::StateDistribution sr_ukf_distr;
+
+    ukf_distr.mean(State::Ones());
+    sr_ukf_distr.mean(State::Ones());
+
+    for (int i = 0; i < 5; ++i)
+    {
+        const Obsrv y = Obsrv::Random();
+
+        ukf.predict(1.0, Input::Zero(), ukf_distr, ukf_distr);
+        sr_ukf.predict(1.0, Input::Zero(), sr_ukf_distr, sr_ukf_distr);
+
+        EXPECT_TRUE(sr_ukf_distr.mean().isApprox(ukf_distr.mean(), 1.e-9));
+        EXPECT_TRUE(sr_ukf_distr.covariance().isApprox(
+                        ukf_distr.covariance(), 1.e-9));
+
+        ukf.update(y, ukf_distr, ukf_distr);
+        sr_ukf.update(y, sr_ukf_distr, sr_ukf_distr);
+
+        EXPECT_TRUE(sr_ukf_distr.mean().isApprox(ukf_distr.mean(), 1.e-9));
+        EXPECT_TRUE(sr_ukf_distr.covariance().isApprox(
+                        ukf_distr.covariance(), 1.e-9));
+
+        // the factor is kept lower triangular
+        EXPECT_TRUE(sr_ukf_distr.square_root().isLowerTriangular());
+    }
+}
+
+TEST(GaussianFilterUkfTests, square_root_ukf_matches_ukf)
+{
+    expect_square_root_ukf_matches_ukf(
+        std::make_shared<fl::UnscentedTransform>(),
+        std::numeric_limits<double>::infinity());
+}
+
+TEST(GaussianFilterUkfTests, square_root_ukf_negative_first_weight)
+{
+    // alpha = 0.5 yields a negative covariance weight of the first point
+    // which enters the factor as a downdate
+    expect_square_root_ukf_matches_ukf(
+        std::make_shared<fl::UnscentedTransform>(0.5),
+        std::numeric_limits<double>::infinity());
+}
+
+TEST(GaussianFilterUkfTests, square_root_ukf_inflated_innovation)
+{
+    expect_square_root_ukf_matches_ukf(
+        std::make_shared<fl::UnscentedTransform>(),
+        0.);
+}
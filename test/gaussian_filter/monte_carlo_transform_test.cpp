@@ -0,0 +1,83 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file monte_carlo_transform_test.cpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Dense>
+
+#include <fl/distribution/gaussian.hpp>
+#include <fl/filter/gaussian/point_set.hpp>
+#include <fl/filter/gaussian/monte_carlo_transform.hpp>
+
+TEST(MonteCarloTransformTest, moment_recovery_fixed)
+{
+    constexpr int dim = 4;
+    typedef Eigen::Matrix<double, dim, 1> Point;
+    typedef fl::MonteCarloTransform<fl::ConstantPointCountPolicy<10000>>
+            Transform;
+
+    fl::Gaussian<Point> gaussian;
+    Eigen::Matrix<double, dim, dim> A =
+        Eigen::Matrix<double, dim, dim>::Random();
+    gaussian.mean(Point::Random());
+    gaussian.covariance(
+        A * A.transpose() + Eigen::Matrix<double, dim, dim>::Identity());
+
+    fl::PointSet<Point> point_set(dim, Transform::number_of_points(dim));
+
+    Transform transform;
+    transform.forward(gaussian, point_set);
+
+    EXPECT_EQ(point_set.count_points(), 10000);
+    EXPECT_DOUBLE_EQ(point_set.weight(0), 1. / 10000.);
+
+    auto&& centered = point_set.centered_points();
+    Eigen::Matrix<double, dim, dim> covariance =
+        centered * centered.transpose() / 10000.;
+
+    EXPECT_TRUE(point_set.mean().isApprox(gaussian.mean(), 0.05));
+    EXPECT_TRUE(covariance.isApprox(gaussian.covariance(), 0.05));
+}
+
+TEST(MonteCarloTransformTest, moment_recovery_dynamic)
+{
+    typedef Eigen::Matrix<double, Eigen::Dynamic, 1> Point;
+    typedef fl::MonteCarloTransform<fl::LinearPointCountPolicy<10000>>
+            Transform;
+
+    const int dim = 3;
+    const int point_count = Transform::number_of_points(dim);
+
+    fl::Gaussian<Point> gaussian(dim);
+    gaussian.mean(Point::Ones(dim));
+
+    fl::PointSet<Point> point_set(dim, point_count);
+
+    Transform transform;
+    transform.forward(gaussian, point_set);
+
+    auto&& centered = point_set.centered_points();
+    Eigen::MatrixXd covariance =
+        centered * centered.transpose() / double(point_count);
+
+    EXPECT_TRUE(point_set.mean().isApprox(gaussian.mean(), 0.05));
+    EXPECT_TRUE(covariance.isApprox(gaussian.covariance(), 0.05));
+}
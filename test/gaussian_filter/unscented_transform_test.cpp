@@ -245,3 +245,39 @@ TEST(UnscentedTransformTest, covariance_recovery_dynamic_fixed)
     test_covariance_transform(point_set, dim);
 }
 
+
+TEST(UnscentedTransformTest, mean_points_of_partition)
+{
+    typedef Eigen::Matrix<double, Eigen::Dynamic, 1> Point;
+
+    constexpr size_t global_dim = 9;
+    constexpr size_t offset = 3;
+    constexpr size_t dim = 4;
+
+    fl::UnscentedTransform ut;
+
+    typename fl::Traits<fl::Gaussian<Point>>::SecondMoment cov;
+    cov.setRandom(dim, dim);
+    cov = cov * cov.transpose() + cov.Identity(dim, dim);
+
+    fl::Gaussian<Point> gaussian(dim);
+    gaussian.mean(Point::Random(dim));
+    gaussian.covariance(cov);
+
+    fl::PointSet<Point> point_set(dim);
+    ut.forward(gaussian, global_dim, offset, point_set);
+
+    size_t mean_points = 0;
+    for (size_t i = 0; i < point_set.count_points(); ++i)
+    {
+        const bool is_mean = point_set.point(i) == gaussian.mean();
+
+        EXPECT_EQ(is_mean,
+                  fl::UnscentedTransform::is_mean_point(
+                      i, global_dim, offset, dim));
+
+        mean_points += is_mean;
+    }
+
+    EXPECT_EQ(2 * (global_dim - dim) + 1, mean_points);
+}
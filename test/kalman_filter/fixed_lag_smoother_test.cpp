@@ -0,0 +1,188 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file fixed_lag_smoother_test.cpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Dense>
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <fl/filter/fixed_lag_smoother.hpp>
+#include <fl/filter/gaussian/gaussian_filter.hpp>
+#include <fl/filter/gaussian/unscented_transform.hpp>
+#include <fl/filter/gaussian/parallel_kalman_filter.hpp>
+
+typedef Eigen::Matrix<double, 3, 1> State;
+typedef Eigen::Matrix<double, 1, 1> Input;
+typedef Eigen::Matrix<double, 2, 1> Obsrv;
+
+typedef fl::LinearGaussianProcessModel<State, Input> ProcessModel;
+typedef fl::LinearGaussianObservationModel<Obsrv, State> ObsrvModel;
+
+typedef fl::GaussianFilter<ProcessModel, ObsrvModel> KalmanFilter;
+typedef fl::GaussianFilter<
+            ProcessModel, ObsrvModel, fl::UnscentedTransform
+        > UnscentedKalmanFilter;
+typedef fl::GaussianFilter<
+            ProcessModel,
+            ObsrvModel,
+            fl::UnscentedTransform,
+            fl::SquareRootCovariance
+        > SquareRootUnscentedKalmanFilter;
+
+class FixedLagSmootherTests
+    : public testing::Test
+{
+protected:
+    FixedLagSmootherTests()
+    {
+        ProcessModel::SecondMoment Q = ProcessModel::SecondMoment::Random();
+
+        process_model = std::make_shared<ProcessModel>(
+            Q * Q.transpose() + ProcessModel::SecondMoment::Identity());
+        obsrv_model = std::make_shared<ObsrvModel>(
+            ObsrvModel::SecondMoment::Identity());
+
+        process_model->A(0.5 * ProcessModel::DynamicsMatrix::Random());
+        obsrv_model->H(ObsrvModel::SensorMatrix::Random());
+
+        prior.mean(State::Random());
+
+        for (int i = 0; i < 12; ++i) y.push_back(Obsrv::Random());
+
+        // reference smoothed distributions of the full sequence
+        fl::ParallelKalmanFilter<ProcessModel, ObsrvModel>(
+            process_model, obsrv_model)
+                .smooth(1.0, Input::Zero(), y, prior, smoothed);
+    }
+
+    /**
+     * Runs the smoother over the sequence and compares the recorded steps
+     * against the smoothed distributions of the full sequence after the last
+     * step
+     */
+    template <typename Smoother>
+    void expect_matches_full_smoother(Smoother& smoother)
+    {
+        typename Smoother::StateDistribution distribution = prior;
+
+        for (size_t t = 0; t < y.size(); ++t)
+        {
+            smoother.predict_and_update(
+                1.0, Input::Zero(), y[t], distribution, distribution);
+
+            // the current step is the filtered one
+            EXPECT_TRUE(smoother.smoothed(0).mean().isApprox(
+                            distribution.mean(), 1.e-9));
+        }
+
+        ASSERT_EQ(smoother.size(), smoother.lag() + 1);
+
+        for (size_t age = 0; age <= smoother.lag(); ++age)
+        {
+            const size_t t = y.size() - 1 - age;
+
+            EXPECT_TRUE(smoother.smoothed(age).mean().isApprox(
+                            smoothed[t].mean(), 1.e-9));
+            EXPECT_TRUE(smoother.smoothed(age).covariance().isApprox(
+                            smoothed[t].covariance(), 1.e-9));
+        }
+
+        EXPECT_TRUE(smoother.lagged().mean().isApprox(
+                        smoothed[y.size() - 1 - smoother.lag()].mean(),
+                        1.e-9));
+    }
+
+    std::shared_ptr<ProcessModel> process_model;
+    std::shared_ptr<ObsrvModel> obsrv_model;
+    KalmanFilter::StateDistribution prior;
+    std::vector<Obsrv> y;
+    std::vector<KalmanFilter::StateDistribution> smoothed;
+};
+
+TEST_F(FixedLagSmootherTests, kalman_filter_matches_full_smoother)
+{
+    fl::FixedLagSmoother<KalmanFilter> smoother(
+        std::make_shared<KalmanFilter>(process_model, obsrv_model), 4);
+
+    expect_matches_full_smoother(smoother);
+}
+
+TEST_F(FixedLagSmootherTests, ukf_matches_full_smoother)
+{
+    auto filter = std::make_shared<UnscentedKalmanFilter>(
+        process_model,
+        obsrv_model,
+        std::make_shared<fl::UnscentedTransform>());
+    filter->threshold = std::numeric_limits<double>::infinity();
+    filter->inv_sigma = 0.;
+
+    fl::FixedLagSmoother<UnscentedKalmanFilter> smoother(filter, 3);
+
+    expect_matches_full_smoother(smoother);
+}
+
+TEST_F(FixedLagSmootherTests, square_root_ukf_matches_full_smoother)
+{
+    auto filter = std::make_shared<SquareRootUnscentedKalmanFilter>(
+        process_model,
+        obsrv_model,
+        std::make_shared<fl::UnscentedTransform>());
+    filter->threshold = std::numeric_limits<double>::infinity();
+    filter->inv_sigma = 0.;
+
+    EXPECT_FALSE(filter->compute_cross_covariance());
+
+    fl::FixedLagSmoother<SquareRootUnscentedKalmanFilter> smoother(filter, 3);
+
+    EXPECT_TRUE(filter->compute_cross_covariance());
+
+    expect_matches_full_smoother(smoother);
+}
+
+TEST_F(FixedLagSmootherTests, buffer_bounds)
+{
+    fl::FixedLagSmoother<KalmanFilter> smoother(
+        std::make_shared<KalmanFilter>(process_model, obsrv_model), 2);
+
+    EXPECT_EQ(smoother.size(), 0);
+    EXPECT_THROW(smoother.lagged(), fl::OutOfBoundsException);
+
+    KalmanFilter::StateDistribution distribution = prior;
+
+    smoother.predict_and_update(
+        1.0, Input::Zero(), y[0], distribution, distribution);
+    EXPECT_EQ(smoother.size(), 2);
+
+    for (int i = 0; i < 5; ++i)
+    {
+        smoother.predict_and_update(
+            1.0, Input::Zero(), y[i], distribution, distribution);
+    }
+
+    EXPECT_EQ(smoother.size(), 3);
+    EXPECT_THROW(smoother.smoothed(3), fl::OutOfBoundsException);
+
+    smoother.clear();
+    EXPECT_EQ(smoother.size(), 0);
+}
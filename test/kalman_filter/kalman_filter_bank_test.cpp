@@ -0,0 +1,162 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file kalman_filter_bank_test.cpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Dense>
+
+#include <vector>
+#include <memory>
+
+#include <fl/util/thread_pool.hpp>
+#include <fl/filter/gaussian/gaussian_filter.hpp>
+#include <fl/filter/gaussian/kalman_filter_bank.hpp>
+
+typedef Eigen::Matrix<double, 4, 1> State;
+typedef Eigen::Matrix<double, 1, 1> Input;
+typedef Eigen::Matrix<double, 2, 1> Obsrv;
+
+typedef fl::LinearGaussianProcessModel<State, Input> ProcessModel;
+typedef fl::LinearGaussianObservationModel<Obsrv, State> ObsrvModel;
+
+typedef fl::GaussianFilter<ProcessModel, ObsrvModel> KalmanFilter;
+typedef fl::KalmanFilterBank<ProcessModel, ObsrvModel> FilterBank;
+
+class KalmanFilterBankTests
+    : public testing::Test
+{
+protected:
+    KalmanFilterBankTests()
+    {
+        ProcessModel::SecondMoment Q = ProcessModel::SecondMoment::Random();
+        ObsrvModel::SecondMoment R = ObsrvModel::SecondMoment::Random();
+
+        process_model = std::make_shared<ProcessModel>(Q * Q.transpose());
+        obsrv_model = std::make_shared<ObsrvModel>(R * R.transpose());
+
+        process_model->A(ProcessModel::DynamicsMatrix::Random());
+        obsrv_model->H(ObsrvModel::SensorMatrix::Random());
+    }
+
+    /**
+     * Runs the bank and one Kalman filter per track side by side. Every
+     * third track misses its observation in every second step. The fully
+     * observed steps use the unmasked update.
+     */
+    void expect_bank_matches_filters(FilterBank& bank)
+    {
+        const size_t count = bank.count();
+
+        KalmanFilter filter(process_model, obsrv_model);
+        std::vector<KalmanFilter::StateDistribution> distributions(count);
+
+        for (size_t k = 0; k < count; ++k)
+        {
+            distributions[k].mean(State::Random());
+            bank.distribution(k, distributions[k]);
+        }
+
+        for (int step = 0; step < 10; ++step)
+        {
+            const FilterBank::ObsrvMatrix y =
+                FilterBank::ObsrvMatrix::Random(2, count);
+            std::vector<bool> observed(count);
+
+            bank.predict(1.0, Input::Zero());
+
+            for (size_t k = 0; k < count; ++k)
+            {
+                observed[k] = step % 2 == 0 || k % 3 != 0;
+
+                filter.predict(1.0, Input::Zero(),
+                               distributions[k], distributions[k]);
+
+                if (observed[k])
+                {
+                    filter.update(y.col(k), distributions[k], distributions[k]);
+                }
+            }
+
+            if (step % 2 == 0)
+            {
+                bank.update(y);
+            }
+            else
+            {
+                bank.update(y, observed);
+            }
+
+            for (size_t k = 0; k < count; ++k)
+            {
+                EXPECT_TRUE(bank.mean(k).isApprox(
+                                distributions[k].mean(), 1.e-9));
+                EXPECT_TRUE(bank.covariance(k).isApprox(
+                                distributions[k].covariance(), 1.e-9));
+            }
+        }
+    }
+
+    std::shared_ptr<ProcessModel> process_model;
+    std::shared_ptr<ObsrvModel> obsrv_model;
+};
+
+TEST_F(KalmanFilterBankTests, init)
+{
+    FilterBank bank(process_model, obsrv_model, 5);
+
+    EXPECT_EQ(bank.count(), 5);
+    EXPECT_EQ(bank.means().rows(), 4);
+    EXPECT_EQ(bank.means().cols(), 5);
+    EXPECT_EQ(bank.covariances().cols(), 20);
+    EXPECT_TRUE(bank.mean(4).isZero());
+    EXPECT_TRUE(bank.covariance(4).isIdentity());
+
+    bank.mean(2) = State::Ones();
+    bank.resize(7);
+
+    EXPECT_EQ(bank.count(), 7);
+    EXPECT_TRUE(bank.mean(2).isOnes());
+    EXPECT_TRUE(bank.covariance(6).isIdentity());
+    EXPECT_TRUE(bank.distribution(2).mean().isOnes());
+}
+
+TEST_F(KalmanFilterBankTests, matches_kalman_filters)
+{
+    FilterBank bank(process_model, obsrv_model, 20);
+
+    expect_bank_matches_filters(bank);
+}
+
+TEST_F(KalmanFilterBankTests, parallel_matches_kalman_filters)
+{
+    FilterBank bank(process_model, obsrv_model, 20);
+    bank.thread_pool(std::make_shared<fl::ThreadPool>(3));
+
+    expect_bank_matches_filters(bank);
+}
+
+TEST_F(KalmanFilterBankTests, wrong_observation_count)
+{
+    FilterBank bank(process_model, obsrv_model, 3);
+
+    EXPECT_THROW(bank.update(FilterBank::ObsrvMatrix::Zero(2, 2)),
+                 fl::WrongSizeException);
+}
@@ -52,6 +52,7 @@
 #include <iostream>
 
 #include <fl/model/process/linear_process_model.hpp>
+#include <fl/model/process/continuous_linear_process_model.hpp>
 #include <fl/model/observation/linear_observation_model.hpp>
 #include <fl/filter/filter_interface.hpp>
 #include <fl/filter/gaussian/gaussian_filter.hpp>
@@ -241,3 +242,298 @@ TEST(KalmanFilterTests, dynamic_size_predict_update)
         EXPECT_TRUE(state_dist.covariance().ldlt().isPositive());
     }
 }
+
+TEST(KalmanFilterTests, sequential_update_matches_joint_update)
+{
+    typedef double Scalar;
+    typedef Eigen::Matrix<Scalar, 4, 1> State;
+    typedef Eigen::Matrix<Scalar, 1, 1> Input;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Observation;
+
+    const size_t dim_observation = 30;
+
+    typedef fl::GaussianFilter<
+                fl::LinearGaussianProcessModel<State, Input>,
+                fl::LinearGaussianObservationModel<Observation, State>
+            > Filter;
+
+    typedef typename fl::Traits<Filter>::ProcessModel ProcessModel;
+    typedef typename fl::Traits<Filter>::ObservationModel ObservationModel;
+
+    ProcessModel::SecondMoment Q = ProcessModel::SecondMoment::Random();
+    Q *= Q.transpose();
+
+    ObservationModel::SecondMoment R =
+        (Observation::Random(dim_observation).array().abs() + 0.1)
+            .matrix().asDiagonal();
+
+    auto process_model = std::make_shared<ProcessModel>(Q);
+    auto observation_model =
+        std::make_shared<ObservationModel>(R, dim_observation);
+
+    process_model->A(ProcessModel::DynamicsMatrix::Random());
+    observation_model->H(
+        ObservationModel::SensorMatrix::Random(dim_observation, 4));
+
+    Filter joint_filter(process_model, observation_model);
+    Filter sequential_filter(process_model, observation_model);
+    sequential_filter.sequential_update(true);
+
+    EXPECT_FALSE(joint_filter.sequential_update());
+    EXPECT_TRUE(sequential_filter.sequential_update());
+
+    Filter::StateDistribution joint_dist;
+    Filter::StateDistribution sequential_dist;
+
+    for (size_t i = 0; i < 10; ++i)
+    {
+        const Observation y = Observation::Random(dim_observation);
+
+        joint_filter.predict_and_update(
+            1.0, Input(), y, joint_dist, joint_dist);
+        sequential_filter.predict_and_update(
+            1.0, Input(), y, sequential_dist, sequential_dist);
+
+        EXPECT_TRUE(sequential_dist.mean().isApprox(joint_dist.mean(), 1e-9));
+        EXPECT_TRUE(sequential_dist.covariance().isApprox(
+                        joint_dist.covariance(), 1e-9));
+    }
+}
+
+TEST(KalmanFilterTests, steady_state_matches_converged_filter)
+{
+    typedef double Scalar;
+    typedef Eigen::Matrix<Scalar, 4, 1> State;
+    typedef Eigen::Matrix<Scalar, 1, 1> Input;
+    typedef Eigen::Matrix<Scalar, 2, 1> Observation;
+
+    typedef fl::GaussianFilter<
+                fl::LinearGaussianProcessModel<State, Input>,
+                fl::LinearGaussianObservationModel<Observation, State>
+            > Filter;
+
+    typedef typename fl::Traits<Filter>::ProcessModel ProcessModel;
+    typedef typename fl::Traits<Filter>::ObservationModel ObservationModel;
+
+    ProcessModel::SecondMoment Q = ProcessModel::SecondMoment::Random();
+    Q = Q * Q.transpose() + ProcessModel::SecondMoment::Identity();
+
+    ObservationModel::SecondMoment R = ObservationModel::SecondMoment::Random();
+    R = R * R.transpose() + ObservationModel::SecondMoment::Identity();
+
+    auto process_model = std::make_shared<ProcessModel>(Q);
+    auto observation_model = std::make_shared<ObservationModel>(R);
+
+    // stable dynamics
+    ProcessModel::DynamicsMatrix A = ProcessModel::DynamicsMatrix::Random();
+    A *= 0.9 / A.eigenvalues().cwiseAbs().maxCoeff();
+
+    process_model->A(A);
+    observation_model->H(ObservationModel::SensorMatrix::Random());
+
+    Filter filter(process_model, observation_model);
+    Filter steady_state_filter(process_model, observation_model);
+
+    EXPECT_FALSE(steady_state_filter.steady_state());
+    EXPECT_TRUE(steady_state_filter.compute_steady_state(1.0));
+    EXPECT_TRUE(steady_state_filter.steady_state());
+
+    Filter::StateDistribution state_dist;
+
+    for (size_t i = 0; i < 500; ++i)
+    {
+        filter.predict_and_update(
+            1.0, Input(), Observation::Random(), state_dist, state_dist);
+    }
+
+    Filter::StateDistribution steady_state_dist = state_dist;
+
+    for (size_t i = 0; i < 10; ++i)
+    {
+        const Observation y = Observation::Random();
+
+        filter.predict(1.0, Input(), state_dist, state_dist);
+        steady_state_filter.predict(
+            1.0, Input(), steady_state_dist, steady_state_dist);
+
+        EXPECT_TRUE(steady_state_dist.mean().isApprox(state_dist.mean(), 1e-8));
+        EXPECT_TRUE(steady_state_dist.covariance().isApprox(
+                        state_dist.covariance(), 1e-8));
+
+        filter.update(y, state_dist, state_dist);
+        steady_state_filter.update(y, steady_state_dist, steady_state_dist);
+
+        EXPECT_TRUE(steady_state_dist.mean().isApprox(state_dist.mean(), 1e-8));
+        EXPECT_TRUE(steady_state_dist.covariance().isApprox(
+                        state_dist.covariance(), 1e-8));
+    }
+
+    steady_state_filter.disable_steady_state();
+    EXPECT_FALSE(steady_state_filter.steady_state());
+}
+
+TEST(KalmanFilterTests, steady_state_with_mixed_time_steps)
+{
+    typedef Eigen::Matrix<double, 4, 1> State;
+    typedef Eigen::Matrix<double, 1, 1> Input;
+    typedef Eigen::Matrix<double, 2, 1> Observation;
+
+    typedef fl::GaussianFilter<
+                fl::LinearGaussianProcessModel<State, Input>,
+                fl::LinearGaussianObservationModel<Observation, State>
+            > Filter;
+
+    typedef typename fl::Traits<Filter>::ProcessModel ProcessModel;
+    typedef typename fl::Traits<Filter>::ObservationModel ObservationModel;
+
+    ProcessModel::SecondMoment Q = ProcessModel::SecondMoment::Random();
+    Q = Q * Q.transpose() + ProcessModel::SecondMoment::Identity();
+
+    ObservationModel::SecondMoment R = ObservationModel::SecondMoment::Random();
+    R = R * R.transpose() + ObservationModel::SecondMoment::Identity();
+
+    auto process_model = std::make_shared<ProcessModel>(Q);
+    auto observation_model = std::make_shared<ObservationModel>(R);
+
+    ProcessModel::DynamicsMatrix A = ProcessModel::DynamicsMatrix::Random();
+    A *= 0.9 / A.eigenvalues().cwiseAbs().maxCoeff();
+
+    process_model->A(A);
+    observation_model->H(ObservationModel::SensorMatrix::Random());
+
+    Filter filter(process_model, observation_model);
+    Filter steady_state_filter(process_model, observation_model);
+
+    EXPECT_TRUE(steady_state_filter.compute_steady_state(1.0));
+
+    Filter::StateDistribution converged_dist;
+
+    for (size_t i = 0; i < 500; ++i)
+    {
+        filter.predict_and_update(
+            1.0, Input(), Observation::Random(), converged_dist, converged_dist);
+    }
+
+    // the steady state cache applies to the steady time step only, every
+    // other time step must yield the regular prediction and update
+    const double delta_times[] = { 1.0, 0.5, 1.0, 2.0, 0.25, 1.0 };
+
+    for (double delta_time: delta_times)
+    {
+        const Observation y = Observation::Random();
+
+        Filter::StateDistribution state_dist = converged_dist;
+        Filter::StateDistribution steady_state_dist = converged_dist;
+
+        filter.predict(delta_time, Input(), state_dist, state_dist);
+        steady_state_filter.predict(
+            delta_time, Input(), steady_state_dist, steady_state_dist);
+
+        filter.update(y, state_dist, state_dist);
+        steady_state_filter.update(y, steady_state_dist, steady_state_dist);
+
+        EXPECT_TRUE(steady_state_dist.mean().isApprox(state_dist.mean(), 1e-8));
+        EXPECT_TRUE(steady_state_dist.covariance().isApprox(
+                        state_dist.covariance(), 1e-8));
+
+        // a repeated update is not preceded by a steady state prediction
+        filter.update(y, state_dist, state_dist);
+        steady_state_filter.update(y, steady_state_dist, steady_state_dist);
+
+        EXPECT_TRUE(steady_state_dist.mean().isApprox(state_dist.mean(), 1e-8));
+        EXPECT_TRUE(steady_state_dist.covariance().isApprox(
+                        state_dist.covariance(), 1e-8));
+    }
+}
+
+TEST(KalmanFilterTests, continuous_model_large_step_matches_small_steps)
+{
+    typedef Eigen::Matrix<double, 4, 1> State;
+    typedef Eigen::Matrix<double, 1, 1> Input;
+    typedef Eigen::Matrix<double, 2, 1> Observation;
+
+    typedef fl::GaussianFilter<
+                fl::LinearGaussianProcessModel<State, Input>,
+                fl::LinearGaussianObservationModel<Observation, State>
+            > Filter;
+
+    typedef fl::ContinuousLinearGaussianProcessModel<State, Input>
+            ContinuousModel;
+    typedef typename fl::Traits<Filter>::ObservationModel ObservationModel;
+
+    ContinuousModel::SecondMoment Q = ContinuousModel::SecondMoment::Random();
+    Q = Q * Q.transpose();
+
+    auto process_model = std::make_shared<ContinuousModel>(Q);
+    process_model->A(ContinuousModel::DynamicsMatrix::Random());
+
+    Filter filter(process_model,
+                  std::make_shared<ObservationModel>(
+                      ObservationModel::SecondMoment::Identity()));
+
+    Filter::StateDistribution prior;
+    prior.mean(State::Random());
+
+    // one exact step of 1.0, ten steps of 0.1 and one fast forward
+    Filter::StateDistribution large_step;
+    filter.predict(1.0, Input(), prior, large_step);
+
+    Filter::StateDistribution small_steps = prior;
+    for (int i = 0; i < 10; ++i)
+    {
+        filter.predict(0.1, Input(), small_steps, small_steps);
+    }
+
+    Filter::StateDistribution fast_forward;
+    filter.predict(0.1, 10, Input(), prior, fast_forward);
+
+    EXPECT_TRUE(large_step.mean().isApprox(small_steps.mean(), 1e-9));
+    EXPECT_TRUE(large_step.covariance().isApprox(
+                    small_steps.covariance(), 1e-9));
+
+    EXPECT_TRUE(fast_forward.mean().isApprox(small_steps.mean(), 1e-9));
+    EXPECT_TRUE(fast_forward.covariance().isApprox(
+                    small_steps.covariance(), 1e-9));
+}
+
+TEST(KalmanFilterTests, fast_forward_matches_repeated_predict)
+{
+    typedef Eigen::Matrix<double, 3, 1> State;
+    typedef Eigen::Matrix<double, 1, 1> Input;
+    typedef Eigen::Matrix<double, 2, 1> Observation;
+
+    typedef fl::GaussianFilter<
+                fl::LinearGaussianProcessModel<State, Input>,
+                fl::LinearGaussianObservationModel<Observation, State>
+            > Filter;
+
+    typedef typename fl::Traits<Filter>::ProcessModel ProcessModel;
+    typedef typename fl::Traits<Filter>::ObservationModel ObservationModel;
+
+    auto process_model = std::make_shared<ProcessModel>(
+        ProcessModel::SecondMoment::Identity());
+    process_model->A(ProcessModel::DynamicsMatrix::Random());
+
+    Filter filter(process_model,
+                  std::make_shared<ObservationModel>(
+                      ObservationModel::SecondMoment::Identity()));
+
+    Filter::StateDistribution prior;
+    prior.mean(State::Random());
+
+    for (size_t steps: { 1, 2, 7 })
+    {
+        Filter::StateDistribution repeated = prior;
+        for (size_t i = 0; i < steps; ++i)
+        {
+            filter.predict(0.5, Input(), repeated, repeated);
+        }
+
+        Filter::StateDistribution fast_forward;
+        filter.predict(0.5, steps, Input(), prior, fast_forward);
+
+        EXPECT_TRUE(fast_forward.mean().isApprox(repeated.mean(), 1e-9));
+        EXPECT_TRUE(fast_forward.covariance().isApprox(
+                        repeated.covariance(), 1e-9));
+    }
+}
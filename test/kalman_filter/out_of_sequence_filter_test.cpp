@@ -0,0 +1,244 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file out_of_sequence_filter_test.cpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Dense>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <fl/filter/out_of_sequence_filter.hpp>
+#include <fl/filter/gaussian/gaussian_filter.hpp>
+#include <fl/model/process/continuous_linear_process_model.hpp>
+
+typedef Eigen::Matrix<double, 2, 1> State;
+typedef Eigen::Matrix<double, 1, 1> Input;
+typedef Eigen::Matrix<double, 1, 1> Obsrv;
+
+typedef fl::LinearGaussianProcessModel<State, Input> ProcessModel;
+typedef fl::ContinuousLinearGaussianProcessModel<State, Input>
+        ContinuousProcessModel;
+typedef fl::LinearGaussianObservationModel<Obsrv, State> ObsrvModel;
+
+typedef fl::GaussianFilter<ProcessModel, ObsrvModel> KalmanFilter;
+typedef fl::OutOfSequenceFilter<KalmanFilter> OosmFilter;
+
+class OutOfSequenceFilterTests
+    : public testing::Test
+{
+protected:
+    OutOfSequenceFilterTests()
+    {
+        // constant velocity model observing the position
+        ContinuousProcessModel::SecondMoment Q_c =
+            ContinuousProcessModel::SecondMoment::Zero();
+        Q_c(1, 1) = 0.5;
+
+        auto process_model = std::make_shared<ContinuousProcessModel>(Q_c);
+        ContinuousProcessModel::DynamicsMatrix F;
+        F << 0., 1.,
+             0., -0.1;
+        process_model->A(F);
+
+        auto obsrv_model = std::make_shared<ObsrvModel>(
+            ObsrvModel::SecondMoment::Identity());
+        ObsrvModel::SensorMatrix H;
+        H << 1., 0.;
+        obsrv_model->H(H);
+
+        filter = std::make_shared<KalmanFilter>(process_model, obsrv_model);
+
+        prior.mean(State::Random());
+
+        for (int i = 1; i <= 10; ++i)
+        {
+            measurements[0.7 * i] = Obsrv::Random();
+        }
+    }
+
+    /**
+     * \return Posterior of processing all measurements in order
+     */
+    KalmanFilter::StateDistribution in_order()
+    {
+        KalmanFilter::StateDistribution distribution = prior;
+        double time = 0.;
+
+        for (auto& measurement: measurements)
+        {
+            filter->predict_and_update(measurement.first - time,
+                                       Input::Zero(),
+                                       measurement.second,
+                                       distribution,
+                                       distribution);
+            time = measurement.first;
+        }
+
+        return distribution;
+    }
+
+    void expect_equal(const KalmanFilter::StateDistribution& a,
+                      const KalmanFilter::StateDistribution& b)
+    {
+        EXPECT_TRUE(a.mean().isApprox(b.mean(), 1.e-9));
+        EXPECT_TRUE(a.covariance().isApprox(b.covariance(), 1.e-9));
+    }
+
+    std::shared_ptr<KalmanFilter> filter;
+    KalmanFilter::StateDistribution prior;
+    std::map<double, Obsrv> measurements;
+};
+
+TEST_F(OutOfSequenceFilterTests, replay_matches_in_order)
+{
+    OosmFilter oosm_filter(filter, 20);
+    oosm_filter.initialize(0., prior);
+
+    // deliver with a latency of up to three measurements
+    const int order[] = { 1, 0, 3, 2, 6, 4, 5, 9, 8, 7 };
+    auto times = std::vector<double>();
+    for (auto& measurement: measurements) times.push_back(measurement.first);
+
+    for (int i: order)
+    {
+        EXPECT_TRUE(oosm_filter.update(
+                        times[i], Input::Zero(), measurements[times[i]]));
+    }
+
+    expect_equal(oosm_filter.distribution(), in_order());
+    EXPECT_DOUBLE_EQ(oosm_filter.time(), times.back());
+
+    auto&& metrics = oosm_filter.metrics();
+    EXPECT_EQ(metrics.in_sequence, 4);
+    EXPECT_EQ(metrics.out_of_sequence, 6);
+    EXPECT_EQ(metrics.replays, 6);
+    EXPECT_EQ(metrics.dropped, 0);
+    EXPECT_EQ(metrics.max_replayed_steps, 3);
+    EXPECT_EQ(metrics.replayed_steps, 2 + 2 + 2 + 2 + 2 + 3);
+}
+
+TEST_F(OutOfSequenceFilterTests, retrodiction_matches_replay)
+{
+    OosmFilter replay_filter(filter, 20);
+    OosmFilter retro_filter(filter, 20);
+    replay_filter.initialize(0., prior);
+    retro_filter.initialize(0., prior);
+    retro_filter.retrodiction(true);
+
+    // every second measurement arrives one step late
+    const int order[] = { 1, 0, 3, 2, 5, 4, 7, 6, 9, 8 };
+    auto times = std::vector<double>();
+    for (auto& measurement: measurements) times.push_back(measurement.first);
+
+    for (int i: order)
+    {
+        replay_filter.update(times[i], Input::Zero(), measurements[times[i]]);
+        retro_filter.update(times[i], Input::Zero(), measurements[times[i]]);
+
+        expect_equal(retro_filter.distribution(),
+                     replay_filter.distribution());
+    }
+
+    expect_equal(retro_filter.distribution(), in_order());
+
+    EXPECT_EQ(retro_filter.metrics().retrodictions, 5);
+    EXPECT_EQ(retro_filter.metrics().replays, 0);
+    EXPECT_EQ(replay_filter.metrics().replays, 5);
+
+    // a measurement before a retrodicted one is replayed
+    Obsrv late = Obsrv::Random();
+    replay_filter.update(0.7 * 8.5, Input::Zero(), late);
+    retro_filter.update(0.7 * 8.5, Input::Zero(), late);
+
+    expect_equal(retro_filter.distribution(), replay_filter.distribution());
+    EXPECT_EQ(retro_filter.metrics().replays, 1);
+}
+
+TEST_F(OutOfSequenceFilterTests, bounded_history)
+{
+    OosmFilter oosm_filter(filter, 4);
+    oosm_filter.initialize(0., prior);
+
+    OosmFilter uninitialized(filter, 4);
+    EXPECT_THROW(uninitialized.update(1., Input::Zero(), Obsrv::Zero()),
+                 fl::Exception);
+    KalmanFilter::StateDistribution predicted;
+    EXPECT_THROW(uninitialized.predict(1., Input::Zero(), predicted),
+                 fl::Exception);
+    EXPECT_THROW(uninitialized.distribution(), fl::Exception);
+    EXPECT_THROW(uninitialized.time(), fl::Exception);
+    EXPECT_THROW(uninitialized.horizon(), fl::Exception);
+
+    for (auto& measurement: measurements)
+    {
+        oosm_filter.update(measurement.first,
+                           Input::Zero(),
+                           measurement.second);
+        EXPECT_LE(oosm_filter.size(), oosm_filter.history_size());
+    }
+
+    EXPECT_EQ(oosm_filter.size(), 4);
+    EXPECT_DOUBLE_EQ(oosm_filter.horizon(), 0.7 * 7);
+    expect_equal(oosm_filter.distribution(), in_order());
+
+    // older than the history
+    EXPECT_FALSE(oosm_filter.update(0.7 * 6.5, Input::Zero(), Obsrv::Zero()));
+    EXPECT_EQ(oosm_filter.metrics().dropped, 1);
+
+    // within the history, the oldest entry is dropped
+    EXPECT_TRUE(oosm_filter.update(0.7 * 8.5, Input::Zero(), Obsrv::Zero()));
+    EXPECT_EQ(oosm_filter.size(), 4);
+    EXPECT_DOUBLE_EQ(oosm_filter.horizon(), 0.7 * 8);
+    EXPECT_EQ(oosm_filter.metrics().replayed_steps, 3);
+}
+
+TEST_F(OutOfSequenceFilterTests, bounded_history_replays_only_the_anchor)
+{
+    OosmFilter oosm_filter(filter, 4);
+    OosmFilter reference(filter, 20);
+    oosm_filter.initialize(0., prior);
+    reference.initialize(0., prior);
+    oosm_filter.retrodiction(true);
+
+    auto times = std::vector<double>();
+    for (auto& measurement: measurements) times.push_back(measurement.first);
+
+    for (int i: { 0, 1, 2, 3 })
+    {
+        reference.update(times[i], Input::Zero(), measurements[times[i]]);
+    }
+
+    // the retrodicted entry becomes the anchor when the history is full
+    for (int i: { 1, 0, 3, 2 })
+    {
+        oosm_filter.update(times[i], Input::Zero(), measurements[times[i]]);
+    }
+
+    expect_equal(oosm_filter.distribution(), reference.distribution());
+    EXPECT_DOUBLE_EQ(oosm_filter.horizon(), times[0]);
+
+    // the new anchor is replayed by a single step
+    EXPECT_EQ(oosm_filter.metrics().retrodictions, 2);
+    EXPECT_EQ(oosm_filter.metrics().replays, 1);
+    EXPECT_EQ(oosm_filter.metrics().replayed_steps, 1);
+}
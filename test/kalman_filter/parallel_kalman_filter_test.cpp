@@ -0,0 +1,171 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file parallel_kalman_filter_test.cpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Dense>
+
+#include <vector>
+#include <memory>
+
+#include <fl/util/thread_pool.hpp>
+#include <fl/filter/gaussian/gaussian_filter.hpp>
+#include <fl/filter/gaussian/parallel_kalman_filter.hpp>
+
+typedef Eigen::Matrix<double, 4, 1> State;
+typedef Eigen::Matrix<double, 1, 1> Input;
+typedef Eigen::Matrix<double, 2, 1> Obsrv;
+
+typedef fl::LinearGaussianProcessModel<State, Input> ProcessModel;
+typedef fl::LinearGaussianObservationModel<Obsrv, State> ObsrvModel;
+
+typedef fl::GaussianFilter<ProcessModel, ObsrvModel> KalmanFilter;
+typedef fl::ParallelKalmanFilter<ProcessModel, ObsrvModel> ParallelFilter;
+
+class ParallelKalmanFilterTests
+    : public testing::Test
+{
+protected:
+    ParallelKalmanFilterTests()
+    {
+        ProcessModel::SecondMoment Q = ProcessModel::SecondMoment::Random();
+        ObsrvModel::SecondMoment R = ObsrvModel::SecondMoment::Random();
+
+        process_model = std::make_shared<ProcessModel>(
+            Q * Q.transpose() + ProcessModel::SecondMoment::Identity());
+        obsrv_model = std::make_shared<ObsrvModel>(
+            R * R.transpose() + ObsrvModel::SecondMoment::Identity());
+
+        // stable dynamics
+        process_model->A(0.5 * ProcessModel::DynamicsMatrix::Random());
+        obsrv_model->H(ObsrvModel::SensorMatrix::Random());
+
+        prior.mean(State::Random());
+    }
+
+    /**
+     * Runs the sequential Kalman filter and a Rauch-Tung-Striebel smoother
+     * over the observations
+     */
+    void sequential(const ParallelFilter::Observations& y,
+                    ParallelFilter::StateDistributions& filtered,
+                    ParallelFilter::StateDistributions& smoothed)
+    {
+        KalmanFilter filter(process_model, obsrv_model);
+
+        filtered.assign(y.size(), prior);
+
+        KalmanFilter::StateDistribution dist = prior;
+        for (size_t k = 0; k < y.size(); ++k)
+        {
+            filter.predict_and_update(1.0, Input::Zero(), y[k], dist, dist);
+            filtered[k] = dist;
+        }
+
+        auto&& A = process_model->discretized_A(1.0);
+        auto&& Q = process_model->discretized_covariance(1.0);
+
+        smoothed = filtered;
+        for (int k = int(y.size()) - 2; k >= 0; --k)
+        {
+            auto&& P = (A * filtered[k].covariance() * A.transpose() + Q)
+                            .eval();
+            auto&& G = (filtered[k].covariance() * A.transpose()
+                            * P.inverse()).eval();
+
+            smoothed[k].mean(
+                filtered[k].mean()
+                + G * (smoothed[k + 1].mean() - A * filtered[k].mean()));
+            smoothed[k].covariance(
+                filtered[k].covariance()
+                + G * (smoothed[k + 1].covariance() - P) * G.transpose());
+        }
+    }
+
+    void expect_parallel_matches_sequential(ParallelFilter& parallel_filter,
+                                            size_t steps)
+    {
+        ParallelFilter::Observations y(steps);
+        for (auto& observation: y) observation = Obsrv::Random();
+
+        ParallelFilter::StateDistributions filtered;
+        ParallelFilter::StateDistributions smoothed;
+        sequential(y, filtered, smoothed);
+
+        ParallelFilter::StateDistributions parallel_filtered;
+        ParallelFilter::StateDistributions parallel_smoothed;
+        parallel_filter.filter(
+            1.0, Input::Zero(), y, prior, parallel_filtered);
+        parallel_filter.smooth(
+            1.0, Input::Zero(), y, prior, parallel_smoothed);
+
+        ASSERT_EQ(parallel_filtered.size(), steps);
+        ASSERT_EQ(parallel_smoothed.size(), steps);
+
+        for (size_t k = 0; k < steps; ++k)
+        {
+            EXPECT_TRUE(parallel_filtered[k].mean().isApprox(
+                            filtered[k].mean(), 1.e-8));
+            EXPECT_TRUE(parallel_filtered[k].covariance().isApprox(
+                            filtered[k].covariance(), 1.e-8));
+
+            EXPECT_TRUE(parallel_smoothed[k].mean().isApprox(
+                            smoothed[k].mean(), 1.e-8));
+            EXPECT_TRUE(parallel_smoothed[k].covariance().isApprox(
+                            smoothed[k].covariance(), 1.e-8));
+        }
+    }
+
+    std::shared_ptr<ProcessModel> process_model;
+    std::shared_ptr<ObsrvModel> obsrv_model;
+    KalmanFilter::StateDistribution prior;
+};
+
+TEST_F(ParallelKalmanFilterTests, matches_sequential)
+{
+    ParallelFilter filter(process_model, obsrv_model);
+
+    for (size_t steps: { 1, 2, 3, 8, 37 })
+    {
+        expect_parallel_matches_sequential(filter, steps);
+    }
+}
+
+TEST_F(ParallelKalmanFilterTests, parallel_matches_sequential)
+{
+    ParallelFilter filter(process_model, obsrv_model);
+    filter.thread_pool(std::make_shared<fl::ThreadPool>(3));
+
+    for (size_t steps: { 1, 5, 64, 100 })
+    {
+        expect_parallel_matches_sequential(filter, steps);
+    }
+}
+
+TEST_F(ParallelKalmanFilterTests, empty_sequence)
+{
+    ParallelFilter filter(process_model, obsrv_model);
+
+    ParallelFilter::StateDistributions posteriors(3);
+    filter.smooth(1.0, Input::Zero(), {}, prior, posteriors);
+
+    EXPECT_TRUE(posteriors.empty());
+}
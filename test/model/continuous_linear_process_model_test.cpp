@@ -0,0 +1,172 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file continuous_linear_process_model_test.cpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Dense>
+
+#include <cmath>
+
+#include <fl/util/math/linear_algebra.hpp>
+#include <fl/model/process/continuous_linear_process_model.hpp>
+
+typedef Eigen::Matrix<double, 2, 1> State;
+typedef fl::ContinuousLinearGaussianProcessModel<State> Model;
+
+/**
+ * Constant velocity model with acceleration noise density q
+ */
+Model create_constant_velocity_model(double q)
+{
+    Model::SecondMoment Q_c = Model::SecondMoment::Zero();
+    Q_c(1, 1) = q;
+
+    Model model(Q_c);
+
+    Model::DynamicsMatrix F = Model::DynamicsMatrix::Zero();
+    F(0, 1) = 1.;
+    model.A(F);
+
+    return model;
+}
+
+TEST(ContinuousLinearGaussianProcessModelTests, matrix_exponential)
+{
+    // rotation generator, large angle to exercise the squaring
+    const double angle = 7.3;
+    Eigen::Matrix2d W;
+    W << 0., -angle,
+         angle, 0.;
+
+    Eigen::Matrix2d R;
+    R << std::cos(angle), -std::sin(angle),
+         std::sin(angle),  std::cos(angle);
+
+    EXPECT_TRUE(fl::matrix_exponential(W).isApprox(R, 1.e-12));
+
+    const Eigen::MatrixXd D = Eigen::VectorXd::LinSpaced(4, -3., 2.)
+                                  .asDiagonal();
+    const Eigen::MatrixXd expected = Eigen::VectorXd::LinSpaced(4, -3., 2.)
+                                         .array().exp().matrix().asDiagonal();
+
+    EXPECT_TRUE(fl::matrix_exponential(D).isApprox(expected, 1.e-12));
+    EXPECT_TRUE(fl::matrix_exponential(Eigen::Matrix3d::Zero().eval())
+                    .isIdentity());
+}
+
+TEST(ContinuousLinearGaussianProcessModelTests, constant_velocity)
+{
+    const double q = 0.7;
+    const double dt = 2.5;
+    Model model = create_constant_velocity_model(q);
+
+    Model::DynamicsMatrix Phi;
+    Phi << 1., dt,
+           0., 1.;
+
+    Model::SecondMoment Q_d;
+    Q_d << dt * dt * dt / 3., dt * dt / 2.,
+           dt * dt / 2.,      dt;
+    Q_d *= q;
+
+    EXPECT_TRUE(model.discretized_A(dt).isApprox(Phi, 1.e-12));
+    EXPECT_TRUE(model.discretized_covariance(dt).isApprox(Q_d, 1.e-12));
+}
+
+TEST(ContinuousLinearGaussianProcessModelTests, discretization_cache)
+{
+    Model model = create_constant_velocity_model(1.);
+
+    const Model::SecondMoment Q_1 = model.discretized_covariance(1.);
+    const Model::SecondMoment Q_2 = model.discretized_covariance(2.);
+
+    EXPECT_FALSE(Q_1.isApprox(Q_2));
+    EXPECT_TRUE(model.discretized_covariance(1.).isApprox(Q_1));
+
+    model.covariance(2. * model.covariance());
+    EXPECT_TRUE(model.discretized_covariance(1.).isApprox(2. * Q_1));
+
+    model.A(Model::DynamicsMatrix::Zero());
+    EXPECT_TRUE(model.discretized_A(1.).isIdentity());
+}
+
+TEST(ContinuousLinearGaussianProcessModelTests, fast_forward)
+{
+    Model model = create_constant_velocity_model(0.3);
+    model.A(model.A() - 0.2 * Model::DynamicsMatrix::Identity());
+
+    Model::DynamicsMatrix A;
+    Model::SecondMoment Q;
+    model.fast_forward(0.1, 13, A, Q);
+
+    EXPECT_TRUE(A.isApprox(model.discretized_A(1.3), 1.e-12));
+    EXPECT_TRUE(Q.isApprox(model.discretized_covariance(1.3), 1.e-12));
+
+    model.fast_forward(0.1, 0, A, Q);
+    EXPECT_TRUE(A.isIdentity());
+    EXPECT_TRUE(Q.isZero());
+}
+
+TEST(ContinuousLinearGaussianProcessModelTests,
+     predict_states_matches_predict_state)
+{
+    Model model = create_constant_velocity_model(0.5);
+
+    const Model::StateMatrix states = Model::StateMatrix::Random(2, 5);
+    const Model::NoiseMatrix noises = Model::NoiseMatrix::Random(2, 5);
+    Model::StateMatrix predictions(2, 5);
+
+    model.predict_states(
+        0.5, states, noises, Model::Input::Zero(), predictions);
+
+    for (int i = 0; i < states.cols(); ++i)
+    {
+        const State expected = model.predict_state(
+            0.5, states.col(i), noises.col(i), Model::Input::Zero());
+
+        EXPECT_TRUE(predictions.col(i).isApprox(expected));
+    }
+
+    // zero noise yields the transition of the mean
+    EXPECT_TRUE(model.predict_state(0.5, states.col(0), Model::Noise::Zero(),
+                                    Model::Input::Zero())
+                    .isApprox(model.discretized_A(0.5) * states.col(0)));
+}
+
+TEST(ContinuousLinearGaussianProcessModelTests, parameters_change_version)
+{
+    Model model = create_constant_velocity_model(0.5);
+    const size_t version = model.version();
+
+    // conditioning does not modify the parameters
+    model.condition(0.1, State::Ones(), Model::Input::Zero());
+    EXPECT_EQ(version, model.version());
+
+    model.A(model.A());
+    EXPECT_LT(version, model.version());
+
+    const size_t a_version = model.version();
+    model.covariance(model.covariance());
+    EXPECT_LT(a_version, model.version());
+
+    // clones start with the version of the original
+    EXPECT_EQ(model.version(), model.clone()->version());
+}
@@ -0,0 +1,148 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file damped_wiener_process_model_test.cpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Dense>
+
+#include <cmath>
+
+#include <fl/model/process/damped_wiener_process_model.hpp>
+#include <fl/model/process/integrated_damped_wiener_process_model.hpp>
+
+typedef Eigen::Matrix<double, 3, 1> State;
+typedef fl::DampedWienerProcessModel<State> Model;
+
+/**
+ * \return Prediction of the damped Wiener process computed from scratch
+ */
+State expected_prediction(double damping,
+                          const Model::SecondMoment& noise_covariance,
+                          double dt,
+                          const State& state,
+                          const Model::Noise& noise,
+                          const Model::Input& input)
+{
+    const double exp_ddt = std::exp(-damping * dt);
+    const double factor =
+        (1.0 - std::exp(-2.0 * damping * dt)) / (2. * damping);
+
+    return exp_ddt * state
+           + (1.0 - exp_ddt) / damping * input
+           + (factor * noise_covariance.diagonal()).cwiseSqrt()
+                 .cwiseProduct(noise);
+}
+
+TEST(DampedWienerProcessModelTests, cached_discretization_matches_fresh)
+{
+    Model model;
+
+    Model::SecondMoment cov = Model::SecondMoment::Zero();
+    cov.diagonal() = State(1.0, 2.0, 3.0);
+    model.parameters(0.5, cov);
+
+    const State state = State::Random();
+    const Model::Noise noise = Model::Noise::Random();
+    const Model::Input input = Model::Input::Random();
+
+    // alternate time steps to hit and miss the cache
+    const double delta_times[] = { 0.1, 0.1, 0.1, 0.03, 0.03, 0.1 };
+
+    for (double dt: delta_times)
+    {
+        EXPECT_TRUE(model.predict_state(dt, state, noise, input).isApprox(
+            expected_prediction(0.5, cov, dt, state, noise, input)));
+    }
+}
+
+TEST(DampedWienerProcessModelTests, parameters_invalidate_discretization)
+{
+    Model model;
+
+    Model::SecondMoment cov = Model::SecondMoment::Identity();
+    model.parameters(0.5, cov);
+
+    const State state = State::Random();
+    const Model::Noise noise = Model::Noise::Random();
+    const Model::Input input = Model::Input::Random();
+
+    model.predict_state(0.1, state, noise, input);
+
+    cov.diagonal() = State(4.0, 5.0, 6.0);
+    model.parameters(2.0, cov);
+
+    EXPECT_TRUE(model.predict_state(0.1, state, noise, input).isApprox(
+        expected_prediction(2.0, cov, 0.1, state, noise, input)));
+}
+
+TEST(DampedWienerProcessModelTests, predict_states_matches_predict_state)
+{
+    Model model;
+    model.parameters(0.5, Model::SecondMoment::Identity());
+
+    const Model::StateMatrix states = Model::StateMatrix::Random(3, 7);
+    const Model::NoiseMatrix noises = Model::NoiseMatrix::Random(3, 7);
+    const Model::Input input = Model::Input::Random();
+
+    Model::StateMatrix predictions(3, 7);
+    model.predict_states(0.1, states, noises, input, predictions);
+
+    for (int i = 0; i < states.cols(); ++i)
+    {
+        EXPECT_TRUE(predictions.col(i).isApprox(
+            model.predict_state(0.1, states.col(i), noises.col(i), input)));
+    }
+}
+
+TEST(IntegratedDampedWienerProcessModelTests,
+     cached_discretization_matches_fresh)
+{
+    typedef Eigen::Matrix<double, 4, 1> State;
+    typedef fl::IntegratedDampedWienerProcessModel<State> Model;
+    typedef Eigen::Matrix<double, 2, 2> SecondMoment;
+
+    const State state = State::Random();
+    const Model::Noise noise = Model::Noise::Random();
+    const Model::Input input = Model::Input::Random();
+
+    Model model;
+    model.parameters(0.5, SecondMoment::Identity());
+
+    // repeated and alternating time steps as well as a parameter change
+    const double delta_times[] = { 0.1, 0.1, 0.03, 0.1, 0.1 };
+
+    for (double dt: delta_times)
+    {
+        Model fresh_model;
+        fresh_model.parameters(0.5, SecondMoment::Identity());
+
+        EXPECT_TRUE(model.predict_state(dt, state, noise, input).isApprox(
+            fresh_model.predict_state(dt, state, noise, input)));
+    }
+
+    model.parameters(2.0, 3.0 * SecondMoment::Identity());
+
+    Model fresh_model;
+    fresh_model.parameters(2.0, 3.0 * SecondMoment::Identity());
+
+    EXPECT_TRUE(model.predict_state(0.1, state, noise, input).isApprox(
+        fresh_model.predict_state(0.1, state, noise, input)));
+}
@@ -323,3 +323,32 @@ TEST_F(JointProcessModel_ID_Tests, predict_dynamic_fallback)
 //}
 
 
+
+TEST_F(JointProcessModel_ID_Tests, predict_states_dynamic_fallback)
+{
+    auto my_model = DynamicFallbackModel(
+        std::make_shared<FModelA>(FACov::Identity() * 3 * 3),
+        std::make_shared<DModelB>(DBCov::Identity(5, 5) * 5 * 5, 5),
+        std::make_shared<FModelC>(FCCov::Identity() * 7 * 7));
+
+    typedef fl::Traits<DynamicFallbackModel>::ProcessModelBase Base;
+
+    const int count = 9;
+    Base::StateMatrix states = Base::StateMatrix::Random(15, count);
+    Base::NoiseMatrix noises = Base::NoiseMatrix::Random(15, count);
+    Base::StateMatrix predictions(15, count);
+    auto input = fl::Traits<DynamicFallbackModel>::Input(3, 1);
+    input.setZero();
+
+    my_model.predict_states(1., states, noises, input, predictions);
+
+    for (int i = 0; i < count; ++i)
+    {
+        auto expected = my_model.predict_state(1.,
+                                               states.col(i),
+                                               noises.col(i),
+                                               input);
+
+        EXPECT_TRUE(predictions.col(i).isApprox(expected));
+    }
+}
@@ -176,3 +176,32 @@ TEST_F(LinearObservationModelTests, sensor_matrix)
     EXPECT_TRUE(model.map_standard_normal(noise).isApprox(observation + noise));
 }
 
+
+TEST_F(LinearObservationModelTests, predict_observations_matches_predict_observation)
+{
+    typedef Eigen::Matrix<double, 10, 1> State;
+    typedef Eigen::Matrix<double, 20, 1> Observation;
+    const size_t dim = Observation::SizeAtCompileTime;
+    const size_t dim_state = State::SizeAtCompileTime;
+    const size_t count = 21;
+    typedef fl::LinearGaussianObservationModel<Observation, State> LGModel;
+
+    LGModel::SecondMoment cov = LGModel::SecondMoment::Random(dim, dim);
+    cov = cov * cov.transpose() + LGModel::SecondMoment::Identity(dim, dim);
+    LGModel model(cov);
+    model.H(LGModel::SensorMatrix::Random(dim, dim_state));
+
+    LGModel::StateMatrix states = LGModel::StateMatrix::Random(dim_state, count);
+    LGModel::NoiseMatrix noises = LGModel::NoiseMatrix::Random(dim, count);
+    LGModel::ObservationMatrix predictions(dim, count);
+
+    model.predict_observations(states, noises, 0., predictions);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        Observation expected =
+            model.predict_observation(states.col(i), noises.col(i), 0.);
+
+        EXPECT_TRUE(predictions.col(i).isApprox(expected));
+    }
+}
@@ -188,3 +188,62 @@ TEST_F(LinearGaussianProcessModelTests, dynamics_matrix)
     EXPECT_FALSE(model.map_standard_normal(sample).isApprox(state));
     EXPECT_TRUE(model.map_standard_normal(sample).isApprox(state_expected));
 }
+
+TEST_F(LinearGaussianProcessModelTests, predict_states_matches_predict_state)
+{
+    const size_t dim = 10;
+    const size_t count = 21;
+    typedef Eigen::Matrix<double, 10, 1> State;
+    typedef fl::LinearGaussianProcessModel<State> LGModel;
+
+    LGModel::SecondMoment cov = LGModel::SecondMoment::Random(dim, dim);
+    cov = cov * cov.transpose() + LGModel::SecondMoment::Identity(dim, dim);
+    LGModel model(cov, dim);
+    model.A(LGModel::DynamicsMatrix::Random(dim, dim));
+
+    LGModel::StateMatrix states = LGModel::StateMatrix::Random(dim, count);
+    LGModel::NoiseMatrix noises = LGModel::NoiseMatrix::Random(dim, count);
+    LGModel::StateMatrix predictions(dim, count);
+    LGModel::Input input = LGModel::Input::Zero();
+
+    model.predict_states(0.5, states, noises, input, predictions);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        State expected =
+            model.predict_state(0.5, states.col(i), noises.col(i), input);
+
+        EXPECT_TRUE(predictions.col(i).isApprox(expected));
+    }
+}
+
+TEST_F(LinearGaussianProcessModelTests, discretization_cache)
+{
+    const size_t dim = 4;
+    typedef Eigen::Matrix<double, 4, 1> State;
+    typedef fl::LinearGaussianProcessModel<State> LGModel;
+
+    LGModel model(LGModel::SecondMoment::Identity(dim, dim), dim);
+    LGModel::DynamicsMatrix A = LGModel::DynamicsMatrix::Random(dim, dim);
+    model.A(A);
+
+    EXPECT_TRUE(model.discretized_A(0.5).isApprox(A * 0.5));
+    EXPECT_TRUE(model.discretized_A(0.5).isApprox(A * 0.5));
+    EXPECT_TRUE(model.discretized_A(0.2).isApprox(A * 0.2));
+    EXPECT_TRUE(model.discretized_covariance(0.2).isApprox(
+                    LGModel::SecondMoment::Identity() * 0.2));
+
+    // changing the model invalidates the cached discretization
+    A = LGModel::DynamicsMatrix::Random(dim, dim);
+    model.A(A);
+    EXPECT_TRUE(model.discretized_A(0.2).isApprox(A * 0.2));
+
+    LGModel::SecondMoment cov = LGModel::SecondMoment::Random(dim, dim);
+    cov = cov * cov.transpose();
+    model.covariance(cov);
+    EXPECT_TRUE(model.discretized_covariance(0.2).isApprox(cov * 0.2));
+
+    model.square_root(LGModel::SecondMoment::Identity() * 2.0);
+    EXPECT_TRUE(model.discretized_covariance(0.2).isApprox(
+                    LGModel::SecondMoment::Identity() * 0.8));
+}
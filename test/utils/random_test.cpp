@@ -0,0 +1,168 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file random_test.cpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Dense>
+
+#include <vector>
+#include <cstdint>
+
+#include <fl/util/random.hpp>
+#include <fl/distribution/standard_gaussian.hpp>
+
+/*
+ * Known answer tests of the Random123 reference implementation
+ */
+TEST(RandomTests, philox_known_answer)
+{
+    std::uint32_t output[4];
+
+    fl::Philox4x32 zero(0, 0);
+    zero.generate_block(0, output);
+    EXPECT_EQ(0x6627e8d5u, output[0]);
+    EXPECT_EQ(0xe169c58du, output[1]);
+    EXPECT_EQ(0xbc57ac4cu, output[2]);
+    EXPECT_EQ(0x9b00dbd8u, output[3]);
+
+    fl::Philox4x32 pi((std::uint64_t(0x299f31d0) << 32) | 0xa4093822,
+                      (std::uint64_t(0x03707344) << 32) | 0x13198a2e);
+    pi.generate_block((std::uint64_t(0x85a308d3) << 32) | 0x243f6a88, output);
+    EXPECT_EQ(0xd16cfe09u, output[0]);
+    EXPECT_EQ(0x94fdccebu, output[1]);
+    EXPECT_EQ(0x5001e420u, output[2]);
+    EXPECT_EQ(0x24126ea1u, output[3]);
+}
+
+TEST(RandomTests, philox_discard)
+{
+    for (unsigned long long skip: {0ull, 1ull, 3ull, 4ull, 5ull, 1001ull})
+    {
+        for (int offset = 0; offset < 5; ++offset)
+        {
+            fl::Philox4x32 a(42, 7);
+            fl::Philox4x32 b(42, 7);
+
+            for (int i = 0; i < offset; ++i) { a(); b(); }
+
+            for (unsigned long long i = 0; i < skip; ++i) a();
+            b.discard(skip);
+
+            EXPECT_EQ(a, b);
+            EXPECT_EQ(a(), b());
+        }
+    }
+}
+
+TEST(RandomTests, philox_streams_differ)
+{
+    fl::Philox4x32 a(1, 0);
+    fl::Philox4x32 b(1, 1);
+    fl::Philox4x32 c(2, 0);
+
+    int equal_ab = 0;
+    int equal_ac = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        const auto x = a();
+        equal_ab += (x == b());
+        equal_ac += (x == c());
+    }
+
+    EXPECT_LE(equal_ab, 1);
+    EXPECT_LE(equal_ac, 1);
+}
+
+TEST(RandomTests, philox_uniformity)
+{
+    fl::Philox4x32 generator(3, 5);
+    std::uniform_real_distribution<double> uniform;
+
+    const int count = 100000;
+    double sum = 0.;
+    double sum_squares = 0.;
+    for (int i = 0; i < count; ++i)
+    {
+        const double u = uniform(generator);
+        sum += u;
+        sum_squares += u * u;
+    }
+
+    EXPECT_NEAR(sum / count, 0.5, 0.01);
+    EXPECT_NEAR(sum_squares / count - 0.25, 1. / 12., 0.01);
+}
+
+TEST(RandomTests, substreams_are_order_independent)
+{
+    const std::uint64_t stream = 11;
+    const int count = 16;
+
+    std::vector<std::uint32_t> forward(count);
+    std::vector<std::uint32_t> backward(count);
+
+    for (int i = 0; i < count; ++i)
+    {
+        fl::Philox4x32 generator(5, fl::substream(stream, i));
+        forward[i] = generator();
+    }
+
+    for (int i = count - 1; i >= 0; --i)
+    {
+        fl::Philox4x32 generator(5, fl::substream(stream, i));
+        backward[i] = generator();
+    }
+
+    EXPECT_EQ(forward, backward);
+
+    for (int i = 1; i < count; ++i)
+    {
+        EXPECT_NE(fl::substream(stream, i), fl::substream(stream, i - 1));
+        EXPECT_NE(fl::substream(stream, i), fl::substream(stream + 1, i));
+    }
+}
+
+TEST(RandomTests, root_seed_reproducibility)
+{
+    typedef fl::StandardGaussian<Eigen::VectorXd> Gaussian;
+
+    const unsigned int previous_seed = fl::seed();
+
+    fl::seed(1234);
+    Gaussian first_a(3);
+    Gaussian first_b(3);
+    const Eigen::MatrixXd a = first_a.sample(100);
+    const Eigen::MatrixXd b = first_b.sample(100);
+
+    fl::seed(1234);
+    Gaussian second_a(3);
+    Gaussian second_b(3);
+
+    // consumption order must not matter
+    const Eigen::MatrixXd b_again = second_b.sample(100);
+    const Eigen::MatrixXd a_again = second_a.sample(100);
+
+    EXPECT_EQ(1234u, fl::seed());
+    EXPECT_TRUE(a.isApprox(a_again));
+    EXPECT_TRUE(b.isApprox(b_again));
+    EXPECT_FALSE(a.isApprox(b));
+
+    fl::seed(previous_seed);
+}
@@ -301,3 +301,25 @@
 
 //    std::cout << r << std::endl;
 //}
+
+TEST(LinearAlgebra, cholesky_update)
+{
+    typedef Eigen::Matrix<double, 5, 5> Matrix;
+    typedef Eigen::Matrix<double, 5, 1> Vector;
+
+    Matrix A = Matrix::Random();
+    A = A * A.transpose() + Matrix::Identity();
+    Vector x = Vector::Random();
+
+    Matrix L = A.llt().matrixL();
+
+    EXPECT_TRUE(fl::cholesky_update(L, x, 0.5));
+    EXPECT_TRUE(L.isLowerTriangular());
+    EXPECT_TRUE((L * L.transpose()).isApprox(A + 0.5 * x * x.transpose()));
+
+    EXPECT_TRUE(fl::cholesky_update(L, x, -0.5));
+    EXPECT_TRUE((L * L.transpose()).isApprox(A));
+
+    // downdating by more than the matrix contains fails
+    EXPECT_FALSE(fl::cholesky_update(L, Vector::Unit(0), -2. * A(0, 0)));
+}
@@ -0,0 +1,171 @@
+/*
+ * This is part of the FL library, a C++ Bayesian filtering library
+ * (https://github.com/filtering-library)
+ *
+ * Copyright (c) 2014 Jan Issac (jan.issac@gmail.com)
+ * Copyright (c) 2014 Manuel Wuthrich (manuel.wuthrich@gmail.com)
+ *
+ * Max-Planck Institute for Intelligent Systems, AMD Lab
+ * University of Southern California, CLMC Lab
+ *
+ * This Source Code Form is subject to the terms of the MIT License (MIT).
+ * A copy of the license can be found in the LICENSE file distributed with this
+ * source code.
+ */
+
+/**
+ * \file thread_pool_test.cpp
+ * \date 2015
+ * \author Jan Issac (jan.issac@gmail.com)
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+
+#include <fl/util/thread_pool.hpp>
+
+TEST(ThreadPoolTests, size)
+{
+    EXPECT_EQ(1u, fl::ThreadPool(1).size());
+    EXPECT_EQ(4u, fl::ThreadPool(4).size());
+    EXPECT_GE(fl::ThreadPool().size(), 1u);
+}
+
+TEST(ThreadPoolTests, each_index_once)
+{
+    fl::ThreadPool pool(4);
+
+    for (int job = 0; job < 100; ++job)
+    {
+        const size_t count = 1 + job * 7;
+        std::vector<int> hits(count, 0);
+        std::atomic<int> invalid_worker(0);
+
+        pool.parallel_for(0, count, [&](size_t i, size_t worker)
+        {
+            ++hits[i];
+            if (worker >= pool.size()) ++invalid_worker;
+        });
+
+        EXPECT_EQ(0, invalid_worker);
+        for (size_t i = 0; i < count; ++i)
+        {
+            EXPECT_EQ(1, hits[i]);
+        }
+    }
+}
+
+TEST(ThreadPoolTests, index_range)
+{
+    fl::ThreadPool pool(3);
+    std::vector<int> hits(10, 0);
+
+    pool.parallel_for(3, 8, [&](size_t i, size_t) { ++hits[i]; });
+    pool.parallel_for(5, 5, [&](size_t i, size_t) { ++hits[i]; });
+
+    for (size_t i = 0; i < hits.size(); ++i)
+    {
+        EXPECT_EQ(i >= 3 && i < 8 ? 1 : 0, hits[i]);
+    }
+}
+
+TEST(ThreadPoolTests, exception_propagation)
+{
+    fl::ThreadPool pool(4);
+
+    EXPECT_THROW(
+        pool.parallel_for(0, 100, [](size_t i, size_t)
+        {
+            if (i == 42) throw std::runtime_error("failed point");
+        }),
+        std::runtime_error);
+
+    // the pool remains usable
+    std::atomic<size_t> sum(0);
+    pool.parallel_for(0, 100, [&](size_t i, size_t) { sum += i; });
+    EXPECT_EQ(4950u, sum);
+}
+
+struct Counter
+{
+    explicit Counter(bool thread_safe)
+        : thread_safe(thread_safe), parameters(0)
+    { }
+    virtual ~Counter() { }
+
+    bool is_thread_safe() const { return thread_safe; }
+    size_t version() const { return parameters; }
+
+    virtual std::shared_ptr<Counter> clone() const
+    {
+        return std::make_shared<Counter>(*this);
+    }
+
+    bool thread_safe;
+    size_t parameters;
+};
+
+struct DerivedCounter
+    : Counter
+{
+    DerivedCounter() : Counter(false) { }
+};
+
+TEST(ThreadPoolTests, worker_instances)
+{
+    fl::WorkerInstances<Counter> instances;
+
+    auto shared = std::make_shared<Counter>(true);
+    EXPECT_TRUE(instances.assign(shared, 3));
+    EXPECT_EQ(shared.get(), &instances[0]);
+    EXPECT_EQ(shared.get(), &instances[2]);
+
+    auto cloneable = std::make_shared<Counter>(false);
+    EXPECT_TRUE(instances.assign(cloneable, 3));
+    EXPECT_EQ(cloneable.get(), &instances[0]);
+    EXPECT_NE(&instances[1], &instances[2]);
+    EXPECT_NE(cloneable.get(), &instances[1]);
+
+    // DerivedCounter does not override clone() and would be sliced
+    fl::WorkerInstances<DerivedCounter> derived_instances;
+    EXPECT_FALSE(derived_instances.assign(std::make_shared<DerivedCounter>(), 2));
+}
+
+TEST(ThreadPoolTests, worker_instances_are_kept)
+{
+    fl::WorkerInstances<Counter> instances;
+
+    auto cloneable = std::make_shared<Counter>(false);
+    EXPECT_TRUE(instances.assign(cloneable, 3));
+    Counter* clone = &instances[1];
+
+    // same original and worker count, the clones are reused
+    EXPECT_TRUE(instances.assign(cloneable, 3));
+    EXPECT_EQ(clone, &instances[1]);
+
+    // a different original is cloned again
+    auto other = std::make_shared<Counter>(false);
+    EXPECT_TRUE(instances.assign(other, 3));
+    EXPECT_EQ(other.get(), &instances[0]);
+    EXPECT_NE(other.get(), &instances[1]);
+
+    // reset() discards the clones of the current original
+    instances.reset();
+    EXPECT_TRUE(instances.assign(other, 3));
+    EXPECT_NE(other.get(), &instances[1]);
+
+    // a new version of the original replaces the outdated clones
+    Counter* outdated = &instances[1];
+    ++other->parameters;
+    EXPECT_TRUE(instances.assign(other, 3));
+    EXPECT_NE(outdated, &instances[1]);
+    EXPECT_EQ(other->parameters, instances[1].parameters);
+
+    // becoming thread safe switches to sharing the original
+    other->thread_safe = true;
+    EXPECT_TRUE(instances.assign(other, 3));
+    EXPECT_EQ(other.get(), &instances[1]);
+}